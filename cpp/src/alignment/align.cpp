@@ -1,6 +1,8 @@
 // All content Copyright (C) 2018 Genomics plc
 //
 // Implementation of a global-local version of the Needleman-Wunsch algorithm using SSE2 instructions.
+// The score-only kernels for several reads at once are at the end, dispatched on the instruction sets the CPU
+// supports.
 //
 // Gerton Lunter, 20/10/2014
 //
@@ -12,25 +14,30 @@
 #include <emmintrin.h>
 #include "common.hpp"
 #include "align.hpp"
+#include "alignKernel.hpp"
 #include "mmHelpers.hpp"
+#include "utils/exceptions.hpp"
+#include "utils/logging.hpp"
 
 namespace wecall
 {
 namespace alignment
 {
-
-    int needlemanWunschAlignment( std::string::const_iterator haplotype,
-                                  std::string::const_iterator readSeq,
-                                  const char * readQual,
-                                  const unsigned int haplotypeLength,
-                                  const unsigned int readLength,
-                                  const unsigned short gapextend,
-                                  const unsigned short nucprior,
-                                  const localGapOpenPenalties_t & localgapopen,
-                                  char * aln1,
-                                  char * aln2,
-                                  int * const firstpos,
-                                  const int o )
+    /// The alignment, specialised at compile time on whether a traceback is wanted. Without one no traceback
+    /// pointers are kept, so a call does no heap allocation.
+    template < bool backtrace >
+    int needlemanWunschAlignmentImpl( std::string::const_iterator haplotype,
+                                      std::string::const_iterator readSeq,
+                                      const char * readQual,
+                                      const unsigned int haplotypeLength,
+                                      const unsigned int readLength,
+                                      const unsigned short gapextend,
+                                      const unsigned short nucprior,
+                                      const localGapOpenPenalties_t & localgapopen,
+                                      char * aln1,
+                                      char * aln2,
+                                      int * const firstpos,
+                                      const int o )
     {
 
         /**********************************************************************************************************
@@ -157,7 +164,6 @@ namespace alignment
         assert( gapextend > 0 );
         assert( nucprior >= 0 );
 
-        const int backtrace = ( aln1 != nullptr );
         constexpr int init_offset = 2048;
         const short infty = 0x7fff - 4 * gapextend - 4;
 
@@ -179,8 +185,8 @@ namespace alignment
         // (For the traceback algorithm, the values in traceback_ptrs are accessed through _wordbackpointers;
         //  according to the GCC documentation, adding __may_alias__ to the latter's definition should ensure
         //  this works, however it proved to be necessary to also give traceback_ptrs this attribute.  Bit worrying...)
-        std::vector< short_array8 > traceback_ptrs( 2 * ( haplotypeLength + 8 ) );
-        int16_t * word_traceback_ptrs = (int16_t *)&traceback_ptrs[0];
+        std::vector< short_array8 > traceback_ptrs( backtrace ? 2 * ( haplotypeLength + 8 ) : 0 );
+        int16_t * word_traceback_ptrs = (int16_t *)traceback_ptrs.data();
 
         // initialization, to -32768 (=(int16_t)0x8000) which encodes score 0, plus offsets that are annulled by
         // mismatches
@@ -457,5 +463,170 @@ namespace alignment
         // and done
         return minscore >> 2;
     }
+
+    int needlemanWunschAlignment( std::string::const_iterator haplotype,
+                                  std::string::const_iterator readSeq,
+                                  const char * readQual,
+                                  const unsigned int haplotypeLength,
+                                  const unsigned int readLength,
+                                  const unsigned short gapextend,
+                                  const unsigned short nucprior,
+                                  const localGapOpenPenalties_t & localgapopen,
+                                  char * aln1,
+                                  char * aln2,
+                                  int * const firstpos,
+                                  const int o )
+    {
+        if ( aln1 == nullptr )
+        {
+            return needlemanWunschAlignmentImpl< false >( haplotype, readSeq, readQual, haplotypeLength, readLength,
+                                                          gapextend, nucprior, localgapopen, aln1, aln2, firstpos, o );
+        }
+        else
+        {
+            return needlemanWunschAlignmentImpl< true >( haplotype, readSeq, readQual, haplotypeLength, readLength,
+                                                         gapextend, nucprior, localgapopen, aln1, aln2, firstpos, o );
+        }
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    void needlemanWunschScoresScalar( const NeedlemanWunschTask * tasks,
+                                      const unsigned int readLength,
+                                      const unsigned short gapextend,
+                                      const unsigned short nucprior,
+                                      int * scores )
+    {
+        needlemanWunschScoresKernel< reference_short_array8 >( tasks, readLength, gapextend, nucprior, scores );
+    }
+
+    void needlemanWunschScoresSse2( const NeedlemanWunschTask * tasks,
+                                    const unsigned int readLength,
+                                    const unsigned short gapextend,
+                                    const unsigned short nucprior,
+                                    int * scores )
+    {
+        needlemanWunschScoresKernel< short_array8 >( tasks, readLength, gapextend, nucprior, scores );
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    std::string toString( SimdInstructionSet instructionSet )
+    {
+        switch ( instructionSet )
+        {
+        case SimdInstructionSet::scalar:
+            return "scalar";
+        case SimdInstructionSet::sse2:
+            return "SSE2";
+        case SimdInstructionSet::avx2:
+            return "AVX2";
+        case SimdInstructionSet::avx512bw:
+            return "AVX-512BW";
+        default:
+            throw utils::wecall_exception( "Unknown instruction set: " +
+                                            std::to_string( static_cast< int >( instructionSet ) ) );
+        }
+    }
+
+    SimdInstructionSet bestSupportedInstructionSet()
+    {
+        static const SimdInstructionSet best = []()
+        {
+            __builtin_cpu_init();
+            const auto instructionSet =
+                __builtin_cpu_supports( "avx512bw" )
+                    ? SimdInstructionSet::avx512bw
+                    : __builtin_cpu_supports( "avx2" ) ? SimdInstructionSet::avx2 : SimdInstructionSet::sse2;
+            WECALL_LOG( INFO, "Using " << toString( instructionSet ) << " alignment kernel" );
+            return instructionSet;
+        }();
+        return best;
+    }
+
+    std::size_t alignmentLanes( SimdInstructionSet instructionSet )
+    {
+        switch ( instructionSet )
+        {
+        case SimdInstructionSet::avx2:
+            return 2;
+        case SimdInstructionSet::avx512bw:
+            return 4;
+        default:
+            return 1;
+        }
+    }
+
+    namespace
+    {
+        using scoresKernel_t = void ( * )( const NeedlemanWunschTask *,
+                                           const unsigned int,
+                                           const unsigned short,
+                                           const unsigned short,
+                                           int * );
+
+        scoresKernel_t scoresKernel( SimdInstructionSet instructionSet )
+        {
+            switch ( instructionSet )
+            {
+            case SimdInstructionSet::scalar:
+                return needlemanWunschScoresScalar;
+            case SimdInstructionSet::sse2:
+                return needlemanWunschScoresSse2;
+            case SimdInstructionSet::avx2:
+                return needlemanWunschScoresAvx2;
+            case SimdInstructionSet::avx512bw:
+                return needlemanWunschScoresAvx512;
+            default:
+                throw utils::wecall_exception( "Unknown instruction set: " +
+                                                std::to_string( static_cast< int >( instructionSet ) ) );
+            }
+        }
+
+        /// The next narrower instruction set, to align the tasks left over after filling the wider kernel.
+        SimdInstructionSet narrower( SimdInstructionSet instructionSet )
+        {
+            switch ( instructionSet )
+            {
+            case SimdInstructionSet::avx512bw:
+                return SimdInstructionSet::avx2;
+            case SimdInstructionSet::avx2:
+                return SimdInstructionSet::sse2;
+            default:
+                return instructionSet;
+            }
+        }
+    }
+
+    void needlemanWunschScores( SimdInstructionSet instructionSet,
+                                const std::vector< NeedlemanWunschTask > & tasks,
+                                const unsigned int readLength,
+                                const unsigned short gapextend,
+                                const unsigned short nucprior,
+                                int * scores )
+    {
+        assert( gapextend > 0 );
+
+        std::size_t done = 0;
+        while ( done < tasks.size() )
+        {
+            while ( alignmentLanes( instructionSet ) > tasks.size() - done )
+            {
+                instructionSet = narrower( instructionSet );
+            }
+
+            scoresKernel( instructionSet )( tasks.data() + done, readLength, gapextend, nucprior, scores + done );
+            done += alignmentLanes( instructionSet );
+        }
+    }
+
+    void needlemanWunschScores( const std::vector< NeedlemanWunschTask > & tasks,
+                                const unsigned int readLength,
+                                const unsigned short gapextend,
+                                const unsigned short nucprior,
+                                int * scores )
+    {
+        needlemanWunschScores( bestSupportedInstructionSet(), tasks, readLength, gapextend, nucprior, scores );
+    }
 }
 }
@@ -2,6 +2,8 @@
 #ifndef ALIGN_HPP
 #define ALIGN_HPP
 
+#include <cstdint>
+#include <string>
 #include <vector>
 #include <emmintrin.h>
 #include <stdio.h>
@@ -27,6 +29,50 @@ namespace alignment
                                   int * const firstpos,
                                   const int o  ///< offset
                                   );
+
+    /// One read to align against a haplotype segment in needlemanWunschScores.
+    struct NeedlemanWunschTask
+    {
+        std::string::const_iterator m_haplotype;  ///< Start of the haplotype segment, 15 bases longer than the read
+        std::string::const_iterator m_readSeq;
+        const char * m_readQual;
+        const int16_t * m_localGapOpen;  ///< Gap open penalties for the haplotype segment
+    };
+
+    /// Instruction sets the score-only alignment kernel is built for. Each kernel aligns one read per 128-bit
+    /// lane of its registers and gives the same scores as needlemanWunschAlignment.
+    enum class SimdInstructionSet
+    {
+        scalar,  ///< Plain C++ reference implementation
+        sse2,
+        avx2,
+        avx512bw
+    };
+
+    std::string toString( SimdInstructionSet instructionSet );
+
+    /// The widest instruction set supported by this CPU, detected once.
+    SimdInstructionSet bestSupportedInstructionSet();
+
+    /// Number of reads aligned at once by the kernel for instructionSet.
+    std::size_t alignmentLanes( SimdInstructionSet instructionSet );
+
+    /// Alignment scores of reads of equal length against their haplotype segments, as needlemanWunschAlignment
+    /// would compute them without a traceback. The reads are aligned as many at a time as the instruction set
+    /// allows.
+    void needlemanWunschScores( SimdInstructionSet instructionSet,
+                                const std::vector< NeedlemanWunschTask > & tasks,
+                                const unsigned int readLength,
+                                const unsigned short gapextend,
+                                const unsigned short nucprior,
+                                int * scores );
+
+    /// As above, using the best supported instruction set.
+    void needlemanWunschScores( const std::vector< NeedlemanWunschTask > & tasks,
+                                const unsigned int readLength,
+                                const unsigned short gapextend,
+                                const unsigned short nucprior,
+                                int * scores );
 }
 }
 
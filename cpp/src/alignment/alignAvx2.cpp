@@ -0,0 +1,23 @@
+// All content Copyright (C) 2018 Genomics plc
+//
+// Score-only Needleman-Wunsch kernel using AVX2 instructions. This is the only translation unit compiled with
+// AVX2 enabled, and it is only called on CPUs that support it.
+//
+
+#include "alignment/alignKernel.hpp"
+#include "alignment/mmHelpersAvx2.hpp"
+
+namespace wecall
+{
+namespace alignment
+{
+    void needlemanWunschScoresAvx2( const NeedlemanWunschTask * tasks,
+                                    const unsigned int readLength,
+                                    const unsigned short gapextend,
+                                    const unsigned short nucprior,
+                                    int * scores )
+    {
+        needlemanWunschScoresKernel< short_array16 >( tasks, readLength, gapextend, nucprior, scores );
+    }
+}
+}
@@ -0,0 +1,23 @@
+// All content Copyright (C) 2018 Genomics plc
+//
+// Score-only Needleman-Wunsch kernel using AVX-512BW instructions. This is the only translation unit compiled with
+// AVX-512BW enabled, and it is only called on CPUs that support it.
+//
+
+#include "alignment/alignKernel.hpp"
+#include "alignment/mmHelpersAvx512.hpp"
+
+namespace wecall
+{
+namespace alignment
+{
+    void needlemanWunschScoresAvx512( const NeedlemanWunschTask * tasks,
+                                      const unsigned int readLength,
+                                      const unsigned short gapextend,
+                                      const unsigned short nucprior,
+                                      int * scores )
+    {
+        needlemanWunschScoresKernel< short_array32 >( tasks, readLength, gapextend, nucprior, scores );
+    }
+}
+}
@@ -0,0 +1,226 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef ALIGN_KERNEL_HPP
+#define ALIGN_KERNEL_HPP
+
+#include "common.hpp"
+#include "alignment/align.hpp"
+
+namespace wecall
+{
+namespace alignment
+{
+    // Score-only kernels for exactly alignmentLanes( instructionSet ) tasks. The AVX2 and AVX-512 kernels live in
+    // their own translation units, which are the only ones compiled with those instruction sets enabled.
+    void needlemanWunschScoresScalar( const NeedlemanWunschTask * tasks,
+                                      const unsigned int readLength,
+                                      const unsigned short gapextend,
+                                      const unsigned short nucprior,
+                                      int * scores );
+
+    void needlemanWunschScoresSse2( const NeedlemanWunschTask * tasks,
+                                    const unsigned int readLength,
+                                    const unsigned short gapextend,
+                                    const unsigned short nucprior,
+                                    int * scores );
+
+    void needlemanWunschScoresAvx2( const NeedlemanWunschTask * tasks,
+                                    const unsigned int readLength,
+                                    const unsigned short gapextend,
+                                    const unsigned short nucprior,
+                                    int * scores );
+
+    void needlemanWunschScoresAvx512( const NeedlemanWunschTask * tasks,
+                                      const unsigned int readLength,
+                                      const unsigned short gapextend,
+                                      const unsigned short nucprior,
+                                      int * scores );
+
+    /// The recursion of needlemanWunschAlignment (see align.cpp for its derivation) without the traceback, for
+    /// one task per 128-bit lane of short_vector_t. Entries are only ever moved within a lane, so the lanes are
+    /// independent alignments sharing the loop over the read.
+    ///
+    /// Where the SSE2 code writes single entries, this writes one entry per lane by building a vector with the
+    /// new entry of every lane and zeros elsewhere, and or-ing it into the shifted vector.
+    template < typename short_vector_t >
+    void needlemanWunschScoresKernel( const NeedlemanWunschTask * tasks,
+                                      const unsigned int readLength,
+                                      const unsigned short gapextend,
+                                      const unsigned short nucprior,
+                                      int * scores )
+    {
+        constexpr std::size_t lanes = short_vector_t::lanes;
+        constexpr std::size_t width = 8 * lanes;
+        constexpr int init_offset = 2048;
+        constexpr int x8000 = 0x8000;
+
+        const unsigned int haplotypeLength = readLength + 15;
+        const short infty = 0x7fff - 4 * gapextend - 4;
+        const int nscore = 4 * nucprior;
+
+        const short_vector_t gapextend_vec( short( 4 * gapextend ) );
+        const short_vector_t nucprior_vec( short( 4 * nucprior ) );
+
+        // scratch space to build vectors from, and extract entries into
+        short entries[width];
+        short laneEntries[lanes];
+
+        for ( std::size_t lane = 0; lane < lanes; ++lane )
+        {
+            laneEntries[lane] = infty;
+        }
+        const short_vector_t first_infty = short_vector_t::first_in_lanes( laneEntries );
+        const short_vector_t last_infty = short_vector_t::last_in_lanes( laneEntries );
+        for ( std::size_t lane = 0; lane < lanes; ++lane )
+        {
+            laneEntries[lane] = -1;
+        }
+        const short_vector_t last_mask = short_vector_t::last_in_lanes( laneEntries );
+
+        for ( std::size_t i = 0; i < width; ++i )
+        {
+            entries[i] = short( x8000 + ( i % 8 ) * init_offset );
+        }
+        short_vector_t mat_even = short_vector_t::load( entries );
+        short_vector_t mat_odd = mat_even;
+        short_vector_t ins_even( infty );
+        short_vector_t del_even( infty );
+        short_vector_t ins_odd( infty );
+        short_vector_t del_odd( infty );
+
+        for ( std::size_t i = 0; i < width; ++i )
+        {
+            entries[i] = tasks[i / 8].m_haplotype[i % 8];
+        }
+        short_vector_t seq1vector = short_vector_t::load( entries );
+
+        for ( std::size_t i = 0; i < width; ++i )
+        {
+            entries[i] = tasks[i / 8].m_haplotype[i % 8] == constants::gapChar ? nscore : infty;
+        }
+        short_vector_t qual1vector = short_vector_t::load( entries );
+
+        short_vector_t seq2vector = ins_even;
+        short_vector_t qual2vector( short( -init_offset ) );
+
+        for ( std::size_t i = 0; i < width; ++i )
+        {
+            entries[i] = 4 * tasks[i / 8].m_localGapOpen[i % 8];
+        }
+        short_vector_t gapopen_vec = short_vector_t::load( entries );
+
+        int minscore[lanes];
+        for ( std::size_t lane = 0; lane < lanes; ++lane )
+        {
+            minscore[lane] = 99999;
+        }
+
+        // Keeps the lowest match score of each lane at the entry where y == readLength.
+        const auto extractMinScore = [&]( const short_vector_t & mat, const unsigned int entry )
+        {
+            mat.store( entries );
+            for ( std::size_t lane = 0; lane < lanes; ++lane )
+            {
+                if ( entries[8 * lane + entry] < minscore[lane] )
+                {
+                    minscore[lane] = entries[8 * lane + entry];
+                }
+            }
+        };
+
+        unsigned int s;
+        for ( s = 0; s < 2 * readLength + 14; s += 2 )
+        {
+            seq2vector = shift_left( seq2vector );
+            qual2vector = shift_left( qual2vector );
+
+            if ( s / 2 < readLength )
+            {
+                for ( std::size_t lane = 0; lane < lanes; ++lane )
+                {
+                    laneEntries[lane] = tasks[lane].m_readSeq[s / 2];
+                }
+                seq2vector = seq2vector | short_vector_t::first_in_lanes( laneEntries );
+                for ( std::size_t lane = 0; lane < lanes; ++lane )
+                {
+                    laneEntries[lane] = 4 * tasks[lane].m_readQual[s / 2];
+                }
+                qual2vector = qual2vector | short_vector_t::first_in_lanes( laneEntries );
+            }
+
+            //
+            // s even
+            //
+
+            if ( s / 2 >= readLength )
+            {
+                extractMinScore( mat_even, s / 2 - readLength );
+            }
+
+            mat_even = mat_even + min( qual1vector, andnot( cmpeq( seq2vector, seq1vector ), qual2vector ) );
+
+            ins_even = min( mat_odd + gapopen_vec, ins_odd + gapextend_vec ) + nucprior_vec;
+
+            del_even = min( min( mat_odd, ins_odd ) + shift_right( gapopen_vec ), del_odd + gapextend_vec );
+
+            del_even = shift_left( del_even ) | first_infty;
+
+            mat_odd = min( mat_odd, min( ins_odd, del_odd ) );
+
+            //
+            // s odd
+            //
+
+            seq1vector = shift_right( seq1vector );
+            qual1vector = shift_right( qual1vector );
+            gapopen_vec = shift_right( gapopen_vec );
+
+            if ( s / 2 + 8 < haplotypeLength )
+            {
+                for ( std::size_t lane = 0; lane < lanes; ++lane )
+                {
+                    laneEntries[lane] = tasks[lane].m_haplotype[s / 2 + 8];
+                }
+                seq1vector = seq1vector | short_vector_t::last_in_lanes( laneEntries );
+                for ( std::size_t lane = 0; lane < lanes; ++lane )
+                {
+                    laneEntries[lane] = tasks[lane].m_haplotype[s / 2 + 8] == constants::gapChar ? nscore : infty;
+                }
+                qual1vector = qual1vector | short_vector_t::last_in_lanes( laneEntries );
+                for ( std::size_t lane = 0; lane < lanes; ++lane )
+                {
+                    laneEntries[lane] = 4 * tasks[lane].m_localGapOpen[s / 2 + 8];
+                }
+                gapopen_vec = gapopen_vec | short_vector_t::last_in_lanes( laneEntries );
+            }
+
+            if ( s / 2 >= readLength )
+            {
+                extractMinScore( mat_odd, s / 2 - readLength );
+            }
+
+            mat_odd = mat_odd + min( qual1vector, andnot( cmpeq( seq2vector, seq1vector ), qual2vector ) );
+
+            del_odd = min( min( mat_even, ins_even ) + gapopen_vec, del_even + gapextend_vec );
+
+            ins_odd = min( ( shift_right( mat_even ) + gapopen_vec ), shift_right( ins_even ) + gapextend_vec ) +
+                      nucprior_vec;
+
+            ins_odd = andnot( last_mask, ins_odd ) | last_infty;
+
+            mat_even = min( mat_even, min( ins_even, del_even ) );
+        }
+
+        mat_odd = min( mat_odd, min( ins_odd, del_odd ) );
+
+        extractMinScore( mat_even, s / 2 - readLength );
+        extractMinScore( mat_odd, s / 2 - readLength );
+
+        for ( std::size_t lane = 0; lane < lanes; ++lane )
+        {
+            scores[lane] = ( minscore[lane] + x8000 ) >> 2;
+        }
+    }
+}
+}
+
+#endif
@@ -16,6 +16,17 @@ namespace wecall
 {
 namespace alignment
 {
+    namespace
+    {
+        double likelihoodFromAlignmentScore( const io::Read & theRead, const int bestScore )
+        {
+            const auto mapq = theRead.getMappingQuality();
+            const double probMappingWrong = stats::fromPhredQ( mapq );
+            const double bestAlignmentLikelihood = stats::fromPhredQ( bestScore );
+            return bestAlignmentLikelihood * ( 1.0 - probMappingWrong ) + probMappingWrong * 10.0e-20;
+        }
+    }
+
     double computeLikelihoodForReadAndHaplotype( const io::Read & theRead,
                                                  const int64_t hintPosition,
                                                  const mapping::HashMapper & mapper,
@@ -34,19 +45,40 @@ namespace alignment
         else
         {
             const auto & readQuals = theRead.getQualities();
-            int bestScore = std::numeric_limits< int >::max();
+            const auto bestScore = aligner.computeBestAlignmentPhredScore( readSeq, readQuals, mapPositions );
+            return likelihoodFromAlignmentScore( theRead, bestScore );
+        }
+    }
+
+    std::vector< double > computeLikelihoodsForReadsAndHaplotype( const std::vector< const io::Read * > & reads,
+                                                                 const int64_t haplotypeStart,
+                                                                 const mapping::HashMapper & mapper,
+                                                                 const alignment::GAlign & aligner )
+    {
+        std::vector< double > likelihoods( reads.size(), 0.0 );
 
-            for ( const auto candidatePos : mapPositions )
+        // Reads that do not map to the haplotype have likelihood 0 and are not aligned.
+        std::vector< std::size_t > mappedReadIndices;
+        std::vector< ReadToAlign > readsToAlign;
+        for ( std::size_t readIndex = 0; readIndex < reads.size(); ++readIndex )
+        {
+            const auto & theRead = *reads[readIndex];
+            const auto hintPosition = theRead.getStartPos() - haplotypeStart;
+            auto mapPositions = mapper.mapSequence( theRead.sequence(), int64_to_sizet( hintPosition ) );
+            if ( not mapPositions.empty() )
             {
-                const auto score = aligner.computeAlignmentPhredScore( readSeq, readQuals, candidatePos );
-                bestScore = std::min( bestScore, score );
+                mappedReadIndices.push_back( readIndex );
+                readsToAlign.push_back( {&theRead.sequence(), &theRead.getQualities(), std::move( mapPositions )} );
             }
+        }
 
-            const auto mapq = theRead.getMappingQuality();
-            const double probMappingWrong = stats::fromPhredQ( mapq );
-            const double bestAlignmentLikelihood = stats::fromPhredQ( bestScore );
-            return bestAlignmentLikelihood * ( 1.0 - probMappingWrong ) + probMappingWrong * 10.0e-20;
+        const auto bestScores = aligner.computeBestAlignmentPhredScores( readsToAlign );
+        for ( std::size_t i = 0; i < mappedReadIndices.size(); ++i )
+        {
+            const auto readIndex = mappedReadIndices[i];
+            likelihoods[readIndex] = likelihoodFromAlignmentScore( *reads[readIndex], bestScores[i] );
         }
+        return likelihoods;
     }
 }
 }
@@ -4,6 +4,8 @@
 
 #include "common.hpp"
 
+#include <vector>
+
 namespace wecall
 {
 namespace io
@@ -26,6 +28,16 @@ namespace alignment
                                                  const int64_t hintPosition,
                                                  const mapping::HashMapper & mapper,
                                                  const alignment::GAlign & aligner );
+
+    /// Likelihood of each read given the haplotype, as computeLikelihoodForReadAndHaplotype would compute them.
+    /// The reads are aligned together, so that reads of equal length share passes of the SIMD alignment kernel.
+    ///
+    /// @param haplotypeStart Position of the start of the haplotype sequence, from which hint positions of the
+    /// reads are computed.
+    std::vector< double > computeLikelihoodsForReadsAndHaplotype( const std::vector< const io::Read * > & reads,
+                                                                 const int64_t haplotypeStart,
+                                                                 const mapping::HashMapper & mapper,
+                                                                 const alignment::GAlign & aligner );
     //-----------------------------------------------------------------------------------------
 }
 }
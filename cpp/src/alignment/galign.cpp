@@ -4,6 +4,7 @@
 #include <cassert>
 #include <algorithm>
 #include <iostream>
+#include <limits>
 
 #include "align.hpp"
 #include "utils/sequence.hpp"
@@ -77,21 +78,12 @@ namespace alignment
                                             char * aln1,
                                             char * aln2 ) const
     {
-        assert( pos < 100000 );
         WECALL_ASSERT( qual.size() == readSeq.size(),
                         "Aligner was called with qual string of the wrong length:" + std::to_string( qual.size() ) +
                             " when it should be " + std::to_string( readSeq.size() ) + " to match the read length" );
 
         const unsigned int readLength = static_cast< int >( readSeq.size() );
-        {
-            const int haplotypeLength = static_cast< int >( m_haplotypeSequence.size() );
-            const auto goodStartPositions =
-                allowableStartPositionsForAlignment( haplotypeLength, readLength, constants::needlemanWunschPadding );
-
-            WECALL_ASSERT( goodStartPositions.contains( pos ), "Aligner provided an invalid position to align to: " +
-                                                                    std::to_string( pos ) + " not contained in " +
-                                                                    goodStartPositions.toString() );
-        }
+        const int offset = this->haplotypeSegmentOffset( readLength, pos );
 
         // the bottom-left and top-right corners of the DP table are just
         // included at the extreme ends of the diagonal, which measures
@@ -100,7 +92,6 @@ namespace alignment
         const unsigned int doublePadding = 2 * constants::needlemanWunschPadding - 1;
 
         const unsigned int haplotypeSegmentLength = readLength + doublePadding;
-        const int offset = pos - constants::needlemanWunschPadding;
         auto haplotypeSegmentForAlignment = m_haplotypeSequence.cbegin() + offset;
 
         int firstPos;
@@ -111,5 +102,111 @@ namespace alignment
     }
 
     //-----------------------------------------------------------------------------------------
+
+    int GAlign::computeBestAlignmentPhredScore( const utils::BasePairSequence & readSeq,
+                                                const utils::QualitySequence & qual,
+                                                const std::vector< std::size_t > & positions ) const
+    {
+        return this->computeBestAlignmentPhredScores( {{&readSeq, &qual, positions}} ).front();
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    std::vector< int > GAlign::computeBestAlignmentPhredScores( const std::vector< ReadToAlign > & reads ) const
+    {
+        struct Alignment
+        {
+            std::size_t m_readIndex;
+            unsigned int m_readLength;
+            int m_position;
+        };
+
+        std::vector< Alignment > alignments;
+        for ( std::size_t readIndex = 0; readIndex < reads.size(); ++readIndex )
+        {
+            const auto & read = reads[readIndex];
+            WECALL_ASSERT( not read.m_positions.empty(), "Aligner was called without positions to align to" );
+            WECALL_ASSERT( read.m_qualities->size() == read.m_sequence->size(),
+                            "Aligner was called with qual string of the wrong length:" +
+                                std::to_string( read.m_qualities->size() ) + " when it should be " +
+                                std::to_string( read.m_sequence->size() ) + " to match the read length" );
+
+            for ( const auto pos : read.m_positions )
+            {
+                alignments.push_back(
+                    {readIndex, static_cast< unsigned int >( read.m_sequence->size() ), static_cast< int >( pos )} );
+            }
+        }
+
+        // Alignments of reads of equal length can share a pass of the kernel.
+        std::stable_sort( alignments.begin(), alignments.end(), []( const Alignment & lhs, const Alignment & rhs )
+                          {
+                              return lhs.m_readLength < rhs.m_readLength;
+                          } );
+
+        std::vector< int > bestScores( reads.size(), std::numeric_limits< int >::max() );
+        std::vector< NeedlemanWunschTask > tasks;
+        std::vector< int > scores;
+
+        auto first = alignments.cbegin();
+        while ( first != alignments.cend() )
+        {
+            const auto readLength = first->m_readLength;
+            const auto last = std::find_if( first, alignments.cend(), [readLength]( const Alignment & alignment )
+                                            {
+                                                return alignment.m_readLength != readLength;
+                                            } );
+
+            if ( std::distance( first, last ) == 1 )
+            {
+                const auto & read = reads[first->m_readIndex];
+                bestScores[first->m_readIndex] = std::min(
+                    bestScores[first->m_readIndex],
+                    this->computeAlignmentPhredScore( *read.m_sequence, *read.m_qualities, first->m_position ) );
+            }
+            else
+            {
+                tasks.clear();
+                for ( auto alignment = first; alignment != last; ++alignment )
+                {
+                    const auto & read = reads[alignment->m_readIndex];
+                    const int offset = this->haplotypeSegmentOffset( readLength, alignment->m_position );
+                    tasks.push_back( {m_haplotypeSequence.cbegin() + offset, read.m_sequence->cbegin(),
+                                      read.m_qualities->c_str(), m_localGapOpen.data() + offset} );
+                }
+
+                scores.resize( tasks.size() );
+                needlemanWunschScores( tasks, readLength, m_gapExtend, m_nucPrior, scores.data() );
+
+                for ( auto alignment = first; alignment != last; ++alignment )
+                {
+                    const auto score = scores[static_cast< std::size_t >( std::distance( first, alignment ) )];
+                    bestScores[alignment->m_readIndex] = std::min( bestScores[alignment->m_readIndex], score );
+                }
+            }
+            first = last;
+        }
+
+        return bestScores;
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    int GAlign::haplotypeSegmentOffset( const unsigned int readLength, const int pos ) const
+    {
+        assert( pos < 100000 );
+
+        const int haplotypeLength = static_cast< int >( m_haplotypeSequence.size() );
+        const auto goodStartPositions =
+            allowableStartPositionsForAlignment( haplotypeLength, readLength, constants::needlemanWunschPadding );
+
+        WECALL_ASSERT( goodStartPositions.contains( pos ), "Aligner provided an invalid position to align to: " +
+                                                                std::to_string( pos ) + " not contained in " +
+                                                                goodStartPositions.toString() );
+
+        return pos - constants::needlemanWunschPadding;
+    }
+
+    //-----------------------------------------------------------------------------------------
 }
 }
@@ -19,6 +19,14 @@ namespace alignment
                                                          const int64_t readLength,
                                                          const int paddingLength );
 
+    /// A read to align against a haplotype, and the positions in the haplotype it may align at.
+    struct ReadToAlign
+    {
+        const utils::BasePairSequence * m_sequence;
+        const utils::QualitySequence * m_qualities;
+        std::vector< std::size_t > m_positions;
+    };
+
     class GAlign
     {
     public:
@@ -33,7 +41,21 @@ namespace alignment
                                         char * aln1 = NULL,
                                         char * aln2 = NULL ) const;
 
+        /// Lowest alignment score of the read over all the positions. The alignments at different positions are
+        /// computed together, as many at a time as the CPU's SIMD registers hold.
+        int computeBestAlignmentPhredScore( const utils::BasePairSequence & readSeq,
+                                            const utils::QualitySequence & qual,
+                                            const std::vector< std::size_t > & positions ) const;
+
+        /// Lowest alignment score of each read over its positions. Alignments of all reads of the same length are
+        /// computed together, as many at a time as the CPU's SIMD registers hold; a read whose length no other
+        /// alignment shares is aligned on its own.
+        std::vector< int > computeBestAlignmentPhredScores( const std::vector< ReadToAlign > & reads ) const;
+
     private:
+        /// Offset into the haplotype of the segment a read aligning at pos is aligned against.
+        int haplotypeSegmentOffset( const unsigned int readLength, const int pos ) const;
+
         const utils::BasePairSequence m_haplotypeSequence;
         const unsigned short m_gapExtend;
         const unsigned short m_nucPrior;
@@ -5,10 +5,14 @@
 
 #include <emmintrin.h>
 #include <cstddef>
+#include <cstdint>
 
 struct short_array8
 {
 public:
+    /// Number of independent 8-entry arrays held, one per 128-bit lane.
+    static constexpr std::size_t lanes = 1;
+
     short_array8( short value ) : m_value( _mm_set1_epi16( value ) ) {}
     short_array8( short v0, short v1, short v2, short v3, short v4, short v5, short v6, short v7 )
         : m_value( _mm_set_epi16( v7, v6, v5, v4, v3, v2, v1, v0 ) )
@@ -17,7 +21,13 @@ public:
     short_array8() : m_value() {}
     explicit short_array8( __m128i value ) : m_value( value ) {}
     short_array8( const short_array8 & value ) : m_value( value.m_value ) {}
-    short operator[]( std::size_t index ) const { return ( (const int16_t *)&m_value )[index]; }
+    short operator[]( std::size_t index ) const
+    {
+        // Store rather than reading m_value through a short pointer, which breaks strict aliasing.
+        short values[8];
+        _mm_storeu_si128( (__m128i *)values, m_value );
+        return values[index];
+    }
     template < typename FUNC >
     short_array8( FUNC f )
         : short_array8( f( 0 ), f( 1 ), f( 2 ), f( 3 ), f( 4 ), f( 5 ), f( 6 ), f( 7 ) )
@@ -50,6 +60,25 @@ public:
         return *this;
     }
 
+    static short_array8 load( const short * values )
+    {
+        return short_array8( _mm_loadu_si128( (const __m128i *)values ) );
+    }
+
+    /// Array with values[lane] as the first entry of each lane, and zeros elsewhere.
+    static short_array8 first_in_lanes( const short * values )
+    {
+        return short_array8( _mm_cvtsi32_si128( uint16_t( values[0] ) ) );
+    }
+
+    /// Array with values[lane] as the last entry of each lane, and zeros elsewhere.
+    static short_array8 last_in_lanes( const short * values )
+    {
+        return short_array8( _mm_set_epi64x( int64_t( uint64_t( uint16_t( values[0] ) ) << 48 ), 0 ) );
+    }
+
+    void store( short * values ) const { _mm_storeu_si128( (__m128i *)values, m_value ); }
+
     __m128i m_value;
 };
 
@@ -97,4 +126,132 @@ inline short_array8 shift_right( const short_array8 & v ) { return short_array8(
 
 inline short_array8 shift_left( const short_array8 & v ) { return short_array8( _mm_slli_si128( v.m_value, 2 ) ); }
 
+//-----------------------------------------------------------------------------------------
+
+/// Plain C++ version of short_array8 (without the element access operators), used as a reference for the
+/// vectorised versions.
+struct reference_short_array8
+{
+public:
+    static constexpr std::size_t lanes = 1;
+
+    reference_short_array8( short value )
+    {
+        for ( std::size_t i = 0; i < 8; ++i )
+        {
+            m_value[i] = value;
+        }
+    }
+
+    reference_short_array8() : reference_short_array8( short( 0 ) ) {}
+
+    static reference_short_array8 load( const short * values )
+    {
+        reference_short_array8 result;
+        for ( std::size_t i = 0; i < 8; ++i )
+        {
+            result.m_value[i] = values[i];
+        }
+        return result;
+    }
+
+    static reference_short_array8 first_in_lanes( const short * values )
+    {
+        reference_short_array8 result;
+        result.m_value[0] = values[0];
+        return result;
+    }
+
+    static reference_short_array8 last_in_lanes( const short * values )
+    {
+        reference_short_array8 result;
+        result.m_value[7] = values[0];
+        return result;
+    }
+
+    void store( short * values ) const
+    {
+        for ( std::size_t i = 0; i < 8; ++i )
+        {
+            values[i] = m_value[i];
+        }
+    }
+
+    short m_value[8];
+};
+
+template < typename OP >
+inline reference_short_array8 elementwise( const reference_short_array8 & v1,
+                                           const reference_short_array8 & v2,
+                                           OP op )
+{
+    reference_short_array8 result;
+    for ( std::size_t i = 0; i < 8; ++i )
+    {
+        result.m_value[i] = op( v1.m_value[i], v2.m_value[i] );
+    }
+    return result;
+}
+
+inline reference_short_array8 min( const reference_short_array8 & v1, const reference_short_array8 & v2 )
+{
+    return elementwise( v1, v2, []( short a, short b )
+                        {
+                            return a < b ? a : b;
+                        } );
+}
+
+inline reference_short_array8 andnot( const reference_short_array8 & v1, const reference_short_array8 & v2 )
+{
+    return elementwise( v1, v2, []( short a, short b )
+                        {
+                            return short( ~a & b );
+                        } );
+}
+
+inline reference_short_array8 cmpeq( const reference_short_array8 & v1, const reference_short_array8 & v2 )
+{
+    return elementwise( v1, v2, []( short a, short b )
+                        {
+                            return short( a == b ? -1 : 0 );
+                        } );
+}
+
+inline reference_short_array8 operator+( const reference_short_array8 & v1, const reference_short_array8 & v2 )
+{
+    // 16-bit additions wrap around, as they do in the SIMD versions.
+    return elementwise( v1, v2, []( short a, short b )
+                        {
+                            return short( uint16_t( a ) + uint16_t( b ) );
+                        } );
+}
+
+inline reference_short_array8 operator|( const reference_short_array8 & v1, const reference_short_array8 & v2 )
+{
+    return elementwise( v1, v2, []( short a, short b )
+                        {
+                            return short( a | b );
+                        } );
+}
+
+inline reference_short_array8 shift_right( const reference_short_array8 & v )
+{
+    reference_short_array8 result;
+    for ( std::size_t i = 0; i < 7; ++i )
+    {
+        result.m_value[i] = v.m_value[i + 1];
+    }
+    return result;
+}
+
+inline reference_short_array8 shift_left( const reference_short_array8 & v )
+{
+    reference_short_array8 result;
+    for ( std::size_t i = 1; i < 8; ++i )
+    {
+        result.m_value[i] = v.m_value[i - 1];
+    }
+    return result;
+}
+
 #endif  // WECALL_MM_HELPERS_H
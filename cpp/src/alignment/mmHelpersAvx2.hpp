@@ -0,0 +1,79 @@
+// All content Copyright (C) 2018 Genomics plc
+
+#ifndef WECALL_MM_HELPERS_AVX2_H
+#define WECALL_MM_HELPERS_AVX2_H
+
+// Only include this from translation units compiled with AVX2 enabled.
+
+#include <immintrin.h>
+#include <cstddef>
+#include <cstdint>
+
+/// Two independent short_array8s, one per 128-bit lane of an AVX2 register. The shifts move entries within each
+/// lane, as the AVX2 byte shifts do.
+struct short_array16
+{
+public:
+    static constexpr std::size_t lanes = 2;
+
+    short_array16( short value ) : m_value( _mm256_set1_epi16( value ) ) {}
+    short_array16() : m_value( _mm256_setzero_si256() ) {}
+    explicit short_array16( __m256i value ) : m_value( value ) {}
+
+    static short_array16 load( const short * values )
+    {
+        return short_array16( _mm256_loadu_si256( (const __m256i *)values ) );
+    }
+
+    static short_array16 first_in_lanes( const short * values )
+    {
+        return short_array16( _mm256_set_epi64x( 0, uint16_t( values[1] ), 0, uint16_t( values[0] ) ) );
+    }
+
+    static short_array16 last_in_lanes( const short * values )
+    {
+        return short_array16( _mm256_set_epi64x( int64_t( uint64_t( uint16_t( values[1] ) ) << 48 ), 0,
+                                                 int64_t( uint64_t( uint16_t( values[0] ) ) << 48 ), 0 ) );
+    }
+
+    void store( short * values ) const { _mm256_storeu_si256( (__m256i *)values, m_value ); }
+
+    __m256i m_value;
+};
+
+inline short_array16 min( const short_array16 & v1, const short_array16 & v2 )
+{
+    return short_array16( _mm256_min_epi16( v1.m_value, v2.m_value ) );
+}
+
+inline short_array16 andnot( const short_array16 & v1, const short_array16 & v2 )
+{
+    return short_array16( _mm256_andnot_si256( v1.m_value, v2.m_value ) );
+}
+
+inline short_array16 cmpeq( const short_array16 & v1, const short_array16 & v2 )
+{
+    return short_array16( _mm256_cmpeq_epi16( v1.m_value, v2.m_value ) );
+}
+
+inline short_array16 operator+( const short_array16 & v1, const short_array16 & v2 )
+{
+    return short_array16( _mm256_add_epi16( v1.m_value, v2.m_value ) );
+}
+
+inline short_array16 operator|( const short_array16 & v1, const short_array16 & v2 )
+{
+    return short_array16( _mm256_or_si256( v1.m_value, v2.m_value ) );
+}
+
+inline short_array16 shift_right( const short_array16 & v )
+{
+    return short_array16( _mm256_srli_si256( v.m_value, 2 ) );
+}
+
+inline short_array16 shift_left( const short_array16 & v )
+{
+    return short_array16( _mm256_slli_si256( v.m_value, 2 ) );
+}
+
+#endif  // WECALL_MM_HELPERS_AVX2_H
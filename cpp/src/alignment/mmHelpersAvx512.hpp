@@ -0,0 +1,80 @@
+// All content Copyright (C) 2018 Genomics plc
+
+#ifndef WECALL_MM_HELPERS_AVX512_H
+#define WECALL_MM_HELPERS_AVX512_H
+
+// Only include this from translation units compiled with AVX-512BW enabled.
+
+#include <immintrin.h>
+#include <cstddef>
+#include <cstdint>
+
+/// Four independent short_array8s, one per 128-bit lane of an AVX-512 register. The shifts move entries within
+/// each lane, as the AVX-512BW byte shifts do.
+struct short_array32
+{
+public:
+    static constexpr std::size_t lanes = 4;
+
+    short_array32( short value ) : m_value( _mm512_set1_epi16( value ) ) {}
+    short_array32() : m_value( _mm512_setzero_si512() ) {}
+    explicit short_array32( __m512i value ) : m_value( value ) {}
+
+    static short_array32 load( const short * values ) { return short_array32( _mm512_loadu_si512( values ) ); }
+
+    static short_array32 first_in_lanes( const short * values )
+    {
+        return short_array32( _mm512_set_epi64( 0, uint16_t( values[3] ), 0, uint16_t( values[2] ), 0,
+                                                uint16_t( values[1] ), 0, uint16_t( values[0] ) ) );
+    }
+
+    static short_array32 last_in_lanes( const short * values )
+    {
+        return short_array32( _mm512_set_epi64( int64_t( uint64_t( uint16_t( values[3] ) ) << 48 ), 0,
+                                                int64_t( uint64_t( uint16_t( values[2] ) ) << 48 ), 0,
+                                                int64_t( uint64_t( uint16_t( values[1] ) ) << 48 ), 0,
+                                                int64_t( uint64_t( uint16_t( values[0] ) ) << 48 ), 0 ) );
+    }
+
+    void store( short * values ) const { _mm512_storeu_si512( values, m_value ); }
+
+    __m512i m_value;
+};
+
+inline short_array32 min( const short_array32 & v1, const short_array32 & v2 )
+{
+    return short_array32( _mm512_min_epi16( v1.m_value, v2.m_value ) );
+}
+
+inline short_array32 andnot( const short_array32 & v1, const short_array32 & v2 )
+{
+    // Same as _mm512_andnot_si512, which trips a false maybe-uninitialized warning in some versions of gcc.
+    return short_array32( ~v1.m_value & v2.m_value );
+}
+
+inline short_array32 cmpeq( const short_array32 & v1, const short_array32 & v2 )
+{
+    return short_array32( _mm512_movm_epi16( _mm512_cmpeq_epi16_mask( v1.m_value, v2.m_value ) ) );
+}
+
+inline short_array32 operator+( const short_array32 & v1, const short_array32 & v2 )
+{
+    return short_array32( _mm512_add_epi16( v1.m_value, v2.m_value ) );
+}
+
+inline short_array32 operator|( const short_array32 & v1, const short_array32 & v2 )
+{
+    return short_array32( _mm512_or_si512( v1.m_value, v2.m_value ) );
+}
+
+inline short_array32 shift_right( const short_array32 & v )
+{
+    return short_array32( _mm512_bsrli_epi128( v.m_value, 2 ) );
+}
+
+inline short_array32 shift_left( const short_array32 & v )
+{
+    return short_array32( _mm512_bslli_epi128( v.m_value, 2 ) );
+}
+
+#endif  // WECALL_MM_HELPERS_AVX512_H
@@ -395,7 +395,8 @@ namespace assembly
 
         for ( std::size_t i = indentFromStart; i < indentFromStart + length - m_kmerSize; ++i )
         {
-            const auto nodes = this->addEdge( &referenceSequence->sequence(), i, 0 );
+            // Kmers point into the bases, so take them from the buffer, which outlives the sequence viewing it.
+            const auto nodes = this->addEdge( &referenceSequence->buffer(), referenceSequence->bufferOffset() + i, 0 );
 
             if ( this->labelAsReference( nodes.first, referenceSequence->start() + i ) or
                  this->labelAsReference( nodes.second, referenceSequence->start() + i + 1 ) )
@@ -138,7 +138,8 @@ namespace caller
                                 const utils::referenceSequencePtr_t & referenceSequence,
                                 const io::perSampleRegionsReads_t & mergedRegionReads,
                                 const Region & regionPrevCluster,
-                                const Region & combinedRegion )
+                                const Region & combinedRegion,
+                                ReadLikelihoodCache * likelihoodCache )
     {
         // Idea:
         // (1) generate possible combinations of haplotypes from merged calls of the two clusters
@@ -180,7 +181,8 @@ namespace caller
 
         // run model for combined haplotypes for one sample
         model::Model m_model( 1, ploidy * ploidy, {sampleName} );
-        const auto results = m_model.getResults( mergedRegionReads, combinedHaplotypes, variants, {ploidy} );
+        const auto results =
+            m_model.getResults( mergedRegionReads, combinedHaplotypes, variants, {ploidy}, likelihoodCache );
 
         // change annotation in correspondence to called genotype
         const auto genotypes = results.getCalledGenotypes();
@@ -225,7 +227,8 @@ namespace caller
                                       const utils::referenceSequencePtr_t & referenceSequence,
                                       const std::vector< size_t > & ploidyPerSample,
                                       const io::perSampleRegionsReads_t mergedRegionReads,
-                                      const std::vector< std::string > & sampleNames )
+                                      const std::vector< std::string > & sampleNames,
+                                      ReadLikelihoodCache * likelihoodCache )
     {
         // do not try to align if one of the clusters does not contain variants
         if ( callsCurrentCluster.empty() or callsPrevCluster.empty() )
@@ -284,7 +287,7 @@ namespace caller
         {
             alignPhasingForSample( callsCurrentCluster, callsPrevCluster, ploidyPerSample[sampleIndex], sampleIndex,
                                    sampleNames[sampleIndex], referenceSequence, mergedRegionReads, regionPrevCluster,
-                                   combinedRegion );
+                                   combinedRegion, likelihoodCache );
         }
     }
 }
@@ -45,7 +45,8 @@ namespace caller
                                 const utils::referenceSequencePtr_t & referenceSequence,
                                 const io::perSampleRegionsReads_t & mergedRegionReads,
                                 const Region & regionPrevCluster,
-                                const Region & region );
+                                const Region & region,
+                                ReadLikelihoodCache * likelihoodCache = nullptr );
 
     void alignPhasingBetweenClusters( callVector_t & callsCurrentCluster,
                                       const callVector_t & callsPrevCluster,
@@ -55,7 +56,8 @@ namespace caller
                                       const utils::referenceSequencePtr_t & referenceSequence,
                                       const std::vector< size_t > & ploidyPerSample,
                                       const io::perSampleRegionsReads_t mergedRegionReads,
-                                      const std::vector< std::string > & sampleNames );
+                                      const std::vector< std::string > & sampleNames,
+                                      ReadLikelihoodCache * likelihoodCache = nullptr );
 }
 }
 
@@ -153,10 +153,12 @@ namespace caller
 
         Model::Model( const int badReadsWindowSize,
                       const std::size_t maxHaplotypesPerCluster,
-                      const std::vector< std::string > & samples )
+                      const std::vector< std::string > & samples,
+                      utils::TaskPool * taskPool )
             : m_badReadsWindowSize( badReadsWindowSize ),
               m_maxHaplotypesPerCluster( maxHaplotypesPerCluster ),
-              m_samples( samples )
+              m_samples( samples ),
+              m_taskPool( taskPool )
         {
         }
 
@@ -165,16 +167,19 @@ namespace caller
                                              const io::RegionsReads & readRange,
                                              const std::vector< variant::varPtr_t > & variants,
                                              const variant::HaplotypeVector & mergedHaplotypes,
-                                             std::map< std::string, variant::GenotypeVector > & perSampleGenotypes,
+                                             const variant::HaplotypeMembership & haplotypeMembership,
                                              variant::genotypePtr_t & calledGenotype,
                                              GenotypeMetadata & genotypeMetadata,
-                                             std::vector< double > & genotypeLikelihoods,
-                                             std::vector< double > & totalHaplotypeFrequencies,
-                                             std::vector< VariantMetadata > & variantAnnotation ) const
+                                             SampleGenotypeStatistics & genotypeStatistics,
+                                             std::vector< double > & haplotypeFrequencies,
+                                             std::vector< VariantMetadata > & variantAnnotation,
+                                             ReadLikelihoodCache * likelihoodCache,
+                                             HaplotypeIndex & haplotypeIndex ) const
         {
-            const auto haplotypeLikelihoods = computeHaplotypeLikelihoods( mergedHaplotypes, readRange );
-            const bool hasReadData = haplotypeLikelihoods.size1() > 0;
-            const auto haplotypeFrequencies = caller::computeHaplotypeFrequencies( haplotypeLikelihoods );
+            const auto haplotypeLikelihoods =
+                computeHaplotypeLikelihoods( mergedHaplotypes, readRange, likelihoodCache, &haplotypeIndex );
+            const bool hasReadData = haplotypeLikelihoods.nRows() > 0;
+            haplotypeFrequencies = caller::computeHaplotypeFrequencies( haplotypeLikelihoods );
 
             if ( false )
             {
@@ -187,21 +192,16 @@ namespace caller
                 }
             }
 
-            for ( std::size_t haplotypeIndex = 0; haplotypeIndex != mergedHaplotypes.size(); ++haplotypeIndex )
-            {
-                totalHaplotypeFrequencies[haplotypeIndex] += haplotypeFrequencies[haplotypeIndex];
-            }
-
-            variantAnnotation = annotate::computeVariantAnnotation( haplotypeLikelihoods, readRange,
-                                                                    m_badReadsWindowSize, variants, mergedHaplotypes );
+            variantAnnotation =
+                annotate::computeVariantAnnotation( haplotypeLikelihoods, readRange, m_badReadsWindowSize, variants,
+                                                    mergedHaplotypes, haplotypeMembership );
 
             const auto bestIndicies = utils::indiciesWithHighestValues< double >(
                 haplotypeFrequencies, this->m_maxHaplotypesPerCluster, 1.0, 1.0e5 );
 
-            perSampleGenotypes.emplace( std::piecewise_construct, std::forward_as_tuple( sample ),
-                                        std::forward_as_tuple( ploidy, mergedHaplotypes, bestIndicies, variants ) );
-
-            const auto & genotypes = perSampleGenotypes.at( sample );
+            const variant::GenotypeVector genotypes( ploidy, mergedHaplotypes, bestIndicies, variants,
+                                                     &haplotypeMembership );
+            std::vector< double > genotypeLikelihoods;
 
             if ( hasReadData and genotypes.size() > 0 )
             {
@@ -226,7 +226,7 @@ namespace caller
                 if ( hasReadData and genotypes.size() > 0 )
                 {
                     variantAnnotation[variantIndex].genotypeLikelihoods =
-                        annotate::get_RR_RA_AA_Likelihoods_as_phred_scores( variants[variantIndex], mergedHaplotypes,
+                        annotate::get_RR_RA_AA_Likelihoods_as_phred_scores( variantIndex, haplotypeMembership,
                                                                             genotypes, genotypeLikelihoods );
                 }
                 else
@@ -234,6 +234,9 @@ namespace caller
                     variantAnnotation[variantIndex].genotypeLikelihoods = {constants::unknownValue};
                 }
             }
+
+            const bool hasReads = readRange.begin() != readRange.end();
+            genotypeStatistics = getSampleGenotypeStatistics( hasReads, bestIndicies, genotypes, genotypeLikelihoods );
         }
 
         //-----------------------------------------------------------------------------------------
@@ -241,26 +244,65 @@ namespace caller
         ModelResults Model::getResults( const io::perSampleRegionsReads_t & readRangesPerSample,
                                         const variant::HaplotypeVector & mergedHaplotypes,
                                         const std::vector< variant::varPtr_t > & variants,
-                                        const std::vector< std::size_t > & perSamplePloidy ) const
+                                        const std::vector< std::size_t > & perSamplePloidy,
+                                        ReadLikelihoodCache * likelihoodCache,
+                                        HaplotypeIndex * haplotypeIndex ) const
         {
-            std::vector< std::vector< double > > genotypeLikelihoodsAllSamples( m_samples.size() );
+            // Samples share one index of the haplotype sequences.
+            HaplotypeIndex localHaplotypeIndex;
+            auto & index = haplotypeIndex == nullptr ? localHaplotypeIndex : *haplotypeIndex;
+
             std::vector< variant::genotypePtr_t > calledGenotypes( m_samples.size(), nullptr );
             std::vector< std::vector< VariantMetadata > > variantAnnotationPerSample( m_samples.size() );
             std::vector< GenotypeMetadata > genotypeMetadataPerSample( m_samples.size(), GenotypeMetadata() );
-            std::vector< double > totalHaplotypeFrequencies( mergedHaplotypes.size(), 0 );
+            std::vector< std::vector< double > > haplotypeFrequenciesPerSample( m_samples.size() );
+            std::vector< SampleGenotypeStatistics > genotypeStatisticsPerSample( m_samples.size() );
+            const variant::HaplotypeMembership haplotypeMembership( mergedHaplotypes, variants );
 
-            std::map< std::string, variant::GenotypeVector > perSampleGenotypes;
-
-            for ( std::size_t sampleIndex = 0; sampleIndex < m_samples.size(); ++sampleIndex )
+            const auto computeSample = [&]( const std::size_t sampleIndex )
             {
                 const auto & sample = m_samples[sampleIndex];
                 const auto & readRange = readRangesPerSample.at( sample );
                 const auto ploidy = perSamplePloidy[sampleIndex];
                 this->computeResultsPerSample( sample, ploidy, readRange, variants, mergedHaplotypes,
-                                               perSampleGenotypes, calledGenotypes[sampleIndex],
+                                               haplotypeMembership, calledGenotypes[sampleIndex],
                                                genotypeMetadataPerSample[sampleIndex],
-                                               genotypeLikelihoodsAllSamples[sampleIndex], totalHaplotypeFrequencies,
-                                               variantAnnotationPerSample[sampleIndex] );
+                                               genotypeStatisticsPerSample[sampleIndex],
+                                               haplotypeFrequenciesPerSample[sampleIndex],
+                                               variantAnnotationPerSample[sampleIndex], likelihoodCache, index );
+            };
+
+            if ( m_taskPool == nullptr or m_samples.size() <= 1 )
+            {
+                for ( std::size_t sampleIndex = 0; sampleIndex < m_samples.size(); ++sampleIndex )
+                {
+                    computeSample( sampleIndex );
+                }
+            }
+            else
+            {
+                // The pool is shared with the rest of the job, so a sample per thread on top of a cluster per thread
+                // does not add threads.
+                std::vector< utils::TaskPool::task_t > tasks;
+                for ( std::size_t sampleIndex = 0; sampleIndex < m_samples.size(); ++sampleIndex )
+                {
+                    tasks.push_back( [&computeSample, sampleIndex]()
+                                     {
+                                         computeSample( sampleIndex );
+                                     } );
+                }
+                m_taskPool->run( tasks );
+            }
+
+            // Combine the samples in sample order so the sums do not depend on the order the samples finished in.
+            std::vector< double > totalHaplotypeFrequencies( mergedHaplotypes.size(), 0 );
+            for ( std::size_t sampleIndex = 0; sampleIndex < m_samples.size(); ++sampleIndex )
+            {
+                const auto & haplotypeFrequencies = haplotypeFrequenciesPerSample[sampleIndex];
+                for ( std::size_t haplotypeIndex = 0; haplotypeIndex != mergedHaplotypes.size(); ++haplotypeIndex )
+                {
+                    totalHaplotypeFrequencies[haplotypeIndex] += haplotypeFrequencies[haplotypeIndex];
+                }
             }
 
             const double haplotypeFrequencySum =
@@ -271,12 +313,19 @@ namespace caller
                 frequency /= haplotypeFrequencySum;
             }
 
-            const auto variantQualities =
-                VariantQualityCalculator( totalHaplotypeFrequencies, genotypeLikelihoodsAllSamples, readRangesPerSample,
-                                          m_samples, variants, mergedHaplotypes, perSampleGenotypes ).getQualities();
+            std::vector< double > variantPriors;
+            for ( const auto & variant : variants )
+            {
+                variantPriors.push_back( variant->prior() );
+            }
+
+            const auto variantQualities = VariantQualityCalculator( totalHaplotypeFrequencies,
+                                                                    genotypeStatisticsPerSample, variantPriors,
+                                                                    haplotypeMembership ).getQualities();
 
             return ModelResults( calledGenotypes, genotypeMetadataPerSample, variantQualities,
-                                 variantAnnotationPerSample );
+                                 variantAnnotationPerSample, haplotypeFrequenciesPerSample,
+                                 genotypeStatisticsPerSample );
         }
 
         //-----------------------------------------------------------------------------------------
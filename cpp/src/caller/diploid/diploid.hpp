@@ -9,11 +9,15 @@
 #include "variant/genotype.hpp"
 #include "caller/callSet.hpp"
 #include "caller/diploid/readSupportAccountant.hpp"
+#include "caller/diploid/variantQualityCalculator.hpp"
 #include "io/read.hpp"
 #include "io/readRange.hpp"
 #include "io/readDataSet.hpp"
 #include "utils/matrix.hpp"
+#include "utils/taskPool.hpp"
 #include "caller/metadata.hpp"
+#include "caller/haplotypeIndex.hpp"
+#include "caller/readLikelihoodCache.hpp"
 
 namespace wecall
 {
@@ -59,11 +63,15 @@ namespace caller
             ModelResults( const std::vector< variant::genotypePtr_t > & calledGenotypes,
                           const std::vector< GenotypeMetadata > & genotypeMetadata,
                           const std::vector< double > & variantQualities,
-                          const std::vector< std::vector< VariantMetadata > > & variantMetadata )
+                          const std::vector< std::vector< VariantMetadata > > & variantMetadata,
+                          const std::vector< std::vector< double > > & haplotypeFrequencies,
+                          const std::vector< SampleGenotypeStatistics > & genotypeStatistics )
                 : m_calledGenotypes( calledGenotypes ),
                   m_genotypeMetadata( genotypeMetadata ),
                   m_variantQualities( variantQualities ),
-                  m_variantMetadata( variantMetadata )
+                  m_variantMetadata( variantMetadata ),
+                  m_haplotypeFrequencies( haplotypeFrequencies ),
+                  m_genotypeStatistics( genotypeStatistics )
             {
             }
 
@@ -76,25 +84,43 @@ namespace caller
                 return m_variantMetadata;
             };
 
+            /// Per-sample haplotype frequencies, before normalising over samples, and the per-sample statistics
+            /// variant quality was computed from.
+            const std::vector< std::vector< double > > & getHaplotypeFrequencies() const
+            {
+                return m_haplotypeFrequencies;
+            }
+            const std::vector< SampleGenotypeStatistics > & getGenotypeStatistics() const
+            {
+                return m_genotypeStatistics;
+            }
+
         private:
             const std::vector< variant::genotypePtr_t > m_calledGenotypes;
             const std::vector< GenotypeMetadata > m_genotypeMetadata;
 
             const std::vector< double > m_variantQualities;
             const std::vector< std::vector< VariantMetadata > > m_variantMetadata;
+            const std::vector< std::vector< double > > m_haplotypeFrequencies;
+            const std::vector< SampleGenotypeStatistics > m_genotypeStatistics;
         };
 
         class Model
         {
         public:
+            /// @param taskPool Pool the results of the samples are computed concurrently on in getResults, or null to
+            /// compute them one sample at a time.
             Model( const int badReadsWindowSize,
                    const std::size_t maxHaplotypesPerCluster,
-                   const std::vector< std::string > & samples );
+                   const std::vector< std::string > & samples,
+                   utils::TaskPool * taskPool = nullptr );
 
             ModelResults getResults( const io::perSampleRegionsReads_t & readRangesPerSample,
                                      const variant::HaplotypeVector & mergedHaplotypes,
                                      const std::vector< variant::varPtr_t > & variants,
-                                     const std::vector< std::size_t > & perSamplePloidy ) const;
+                                     const std::vector< std::size_t > & perSamplePloidy,
+                                     ReadLikelihoodCache * likelihoodCache = nullptr,
+                                     HaplotypeIndex * haplotypeIndex = nullptr ) const;
 
         private:
             void computeResultsPerSample( const std::string & sample,
@@ -102,16 +128,19 @@ namespace caller
                                           const io::RegionsReads & readRange,
                                           const std::vector< variant::varPtr_t > & variants,
                                           const variant::HaplotypeVector & mergedHaplotypes,
-                                          std::map< std::string, variant::GenotypeVector > & perSampleGenotypes,
+                                          const variant::HaplotypeMembership & haplotypeMembership,
                                           variant::genotypePtr_t & calledGenotype,
                                           GenotypeMetadata & genotypeMetadata,
-                                          std::vector< double > & genotypeLikelihoods,
-                                          std::vector< double > & totalHaplotypeFrequencies,
-                                          std::vector< VariantMetadata > & variantAnnotation ) const;
+                                          SampleGenotypeStatistics & genotypeStatistics,
+                                          std::vector< double > & haplotypeFrequencies,
+                                          std::vector< VariantMetadata > & variantAnnotation,
+                                          ReadLikelihoodCache * likelihoodCache,
+                                          HaplotypeIndex & haplotypeIndex ) const;
 
             const int m_badReadsWindowSize;
             const std::size_t m_maxHaplotypesPerCluster;
             const std::vector< std::string > m_samples;
+            utils::TaskPool * const m_taskPool;
         };
     }
 }
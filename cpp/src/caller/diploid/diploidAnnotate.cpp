@@ -15,44 +15,29 @@ namespace caller
     namespace annotate
     {
         std::pair< utils::matrix_t, utils::matrix_t > computePosteriorForReadSupportingVariantsAndReference(
-            const utils::matrix_t & probReadsGivenHaplotypes,
-            const std::vector< variant::varPtr_t > & candidateVariants,
-            const variant::HaplotypeVector & mergedHaplotypes )
+            const utils::likelihoodMatrix_t & probReadsGivenHaplotypes,
+            const variant::HaplotypeMembership & membership )
         {
-            const std::size_t nReads = probReadsGivenHaplotypes.size1();
+            const std::size_t nReads = probReadsGivenHaplotypes.nRows();
 
             // compute denominator
-            std::vector< double > sumOfReadLikelihoodsOverAllHaplotypes( nReads );
-            for ( std::size_t readIndex = 0; readIndex < nReads; ++readIndex )
-            {
-                const utils::matrixRow_t probReadGivenHaplotypes( probReadsGivenHaplotypes, readIndex );
-                sumOfReadLikelihoodsOverAllHaplotypes[readIndex] =
-                    utils::sumMatrixRowOverAllIndices( probReadGivenHaplotypes );
-            }
+            const auto sumOfReadLikelihoodsOverAllHaplotypes = utils::rowSums( probReadsGivenHaplotypes );
 
             // compute matrix p(v|r) and p(ref_at_v|r)
-            const auto nVariants = candidateVariants.size();
+            const auto nVariants = membership.nVariants();
             utils::matrix_t resultsForVariants( nVariants, nReads );
             utils::matrix_t resultsForReference( nVariants, nReads );
 
-            for ( std::size_t variantIndex = 0; variantIndex < nVariants; ++variantIndex )
+            for ( std::size_t readIndex = 0; readIndex < nReads; ++readIndex )
             {
-                const auto thisVar = candidateVariants[variantIndex];
-
-                const auto & haplotypeIndicesForThisVariant = mergedHaplotypes.getHaplotypeIndicesForVariant( thisVar );
-
-                const auto & haplotypeIndicesForReferenceAtThisVariantPosition =
-                    mergedHaplotypes.getIndicesForReference( thisVar->region() );
+                const auto probReadGivenHaplotypes = probReadsGivenHaplotypes.row( readIndex );
 
-                for ( std::size_t readIndex = 0; readIndex < nReads; ++readIndex )
+                for ( std::size_t variantIndex = 0; variantIndex < nVariants; ++variantIndex )
                 {
-                    const utils::matrixRow_t probReadGivenHaplotypes( probReadsGivenHaplotypes, readIndex );
-
                     resultsForVariants( variantIndex, readIndex ) =
-                        utils::sumMatrixRowOverIndexSubset( probReadGivenHaplotypes, haplotypeIndicesForThisVariant );
-
-                    resultsForReference( variantIndex, readIndex ) = utils::sumMatrixRowOverIndexSubset(
-                        probReadGivenHaplotypes, haplotypeIndicesForReferenceAtThisVariantPosition );
+                        membership.sumOverHaplotypesContainingVariant( variantIndex, probReadGivenHaplotypes );
+                    resultsForReference( variantIndex, readIndex ) =
+                        membership.sumOverReferenceHaplotypes( variantIndex, probReadGivenHaplotypes );
                 }
             }
 
@@ -83,11 +68,12 @@ namespace caller
         }
 
         std::vector< model::VariantMetadata > computeVariantAnnotation(
-            const utils::matrix_t & probReadsGivenHaplotypes,
+            const utils::likelihoodMatrix_t & probReadsGivenHaplotypes,
             const io::RegionsReads & readRange,
             const int badReadsWindowSize,
             const std::vector< variant::varPtr_t > & candidateVariants,
-            const variant::HaplotypeVector & mergedHaplotypes )
+            const variant::HaplotypeVector & mergedHaplotypes,
+            const variant::HaplotypeMembership & membership )
         {
             const auto nVariants = candidateVariants.size();
 
@@ -101,8 +87,7 @@ namespace caller
             }
 
             const auto posteriorForReadSupportingVariantsAndReference =
-                computePosteriorForReadSupportingVariantsAndReference( probReadsGivenHaplotypes, candidateVariants,
-                                                                       mergedHaplotypes );
+                computePosteriorForReadSupportingVariantsAndReference( probReadsGivenHaplotypes, membership );
             const auto & posteriorForReadSupportingVariants = posteriorForReadSupportingVariantsAndReference.first;
             const auto & posteriorForReadSupportingReference = posteriorForReadSupportingVariantsAndReference.second;
 
@@ -218,13 +203,24 @@ namespace caller
             const variant::HaplotypeVector & haplotypes,
             const variant::GenotypeVector & genotypes,
             const std::vector< double > & genotypeLikelihoods )
+        {
+            return get_RR_RA_AA_Likelihoods_as_phred_scores( 0, variant::HaplotypeMembership( haplotypes, {var} ),
+                                                             genotypes, genotypeLikelihoods );
+        }
+
+        std::vector< phred_t > get_RR_RA_AA_Likelihoods_as_phred_scores(
+            const std::size_t variantIndex,
+            const variant::HaplotypeMembership & membership,
+            const variant::GenotypeVector & genotypes,
+            const std::vector< double > & genotypeLikelihoods )
         {
             std::vector< double > totalLikelihood( 1 + genotypes.ploidy(), 0.0 );  // RR, RA, AA
             std::vector< phred_t > retVals( 1 + genotypes.ploidy() );
 
             for ( std::size_t genotypeIndex = 0; genotypeIndex < genotypes.size(); ++genotypeIndex )
             {
-                const auto nStrandsWithVar = genotypes[genotypeIndex]->nStrandsContainingVariant( haplotypes, var );
+                const auto nStrandsWithVar =
+                    genotypes[genotypeIndex]->nStrandsContainingVariant( membership, variantIndex );
                 const auto factor = genotypes[genotypeIndex]->nCombinationsThisGenotype();
 
                 totalLikelihood[nStrandsWithVar] += genotypeLikelihoods[genotypeIndex] * factor;
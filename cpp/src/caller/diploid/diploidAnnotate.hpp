@@ -18,11 +18,12 @@ namespace caller
     namespace annotate
     {
         std::vector< model::VariantMetadata > computeVariantAnnotation(
-            const utils::matrix_t & probReadsGivenHaplotypes,
+            const utils::likelihoodMatrix_t & probReadsGivenHaplotypes,
             const io::RegionsReads & readRange,
             const int badReadsWindowSize,
             const std::vector< variant::varPtr_t > & candidateVariants,
-            const variant::HaplotypeVector & mergedHaplotypes );
+            const variant::HaplotypeVector & mergedHaplotypes,
+            const variant::HaplotypeMembership & membership );
 
         GenotypeMetadata computeGenotypeMetaData( const std::size_t calledGenotypeIndex,
                                                   const variant::GenotypeVector & genotypes,
@@ -41,6 +42,13 @@ namespace caller
             const variant::GenotypeVector & genotypes,
             const std::vector< double > & genotypeLikelihoods );
 
+        /// As above for the variant at variantIndex of a cluster's haplotype membership.
+        std::vector< phred_t > get_RR_RA_AA_Likelihoods_as_phred_scores(
+            const std::size_t variantIndex,
+            const variant::HaplotypeMembership & membership,
+            const variant::GenotypeVector & genotypes,
+            const std::vector< double > & genotypeLikelihoods );
+
         void annotate( Call & call,
                        const std::size_t varIndex,
                        const std::vector< std::vector< caller::model::VariantMetadata > > & variantAnnotationPerSample,
@@ -1,7 +1,4 @@
 // All content Copyright (C) 2018 Genomics plc
-#include <boost/numeric/ublas/matrix.hpp>
-#include <boost/numeric/ublas/matrix_proxy.hpp>
-
 #include "caller/diploid/genotypeUtils.hpp"
 #include "utils/indexedProduct.hpp"
 
@@ -12,32 +9,67 @@ namespace caller
     namespace model
     {
         std::vector< double > computeGenotypeLikelihoods( const variant::GenotypeVector & genotypes,
-                                                          const utils::matrix_t & probReadsGivenHaplotypes,
+                                                          const utils::likelihoodMatrix_t & probReadsGivenHaplotypes,
                                                           const variant::HaplotypeVector & haplotypes )
         {
             std::vector< double > genotypeLikelihoods( genotypes.size() );
-            const auto nReads = probReadsGivenHaplotypes.size1();
+            const auto nReads = probReadsGivenHaplotypes.nRows();
+            const auto nHaplotypes = probReadsGivenHaplotypes.nColumns();
             WECALL_ASSERT( nReads > 0, "Only makes sense to compute likelihoods if there is read-data" );
 
+            // The columns are copied out once so that the sums over the haplotypes of each genotype run over
+            // contiguous memory.
+            std::vector< double > columns( nHaplotypes * nReads );
+            for ( std::size_t readIndex = 0; readIndex < nReads; ++readIndex )
+            {
+                const auto row = probReadsGivenHaplotypes.row( readIndex );
+                for ( std::size_t hapIndex = 0; hapIndex < nHaplotypes; ++hapIndex )
+                {
+                    columns[hapIndex * nReads + readIndex] = row[hapIndex];
+                }
+            }
+
+            std::vector< double > probReadsGivenGenotype( nReads );
             for ( std::size_t genotypeIndex = 0; genotypeIndex < genotypes.size(); ++genotypeIndex )
             {
-                double thisGenotypeLogLikelihood = 0.0;
-                const auto hapIndicies = genotypes.getHaplotypeIndices( genotypeIndex );
+                const auto & hapIndicies = genotypes.getHaplotypeIndices( genotypeIndex );
 
                 // prior probability of any haplotype (given genotype).  Assumes uniform distribution across haplotypes
                 const auto haplotypePriorProbability = 1.0 / static_cast< double >( hapIndicies.size() );
 
-                for ( std::size_t readIndex = 0; readIndex < nReads; ++readIndex )
+                if ( hapIndicies.size() == 2 )
+                {
+                    // Diploid genotypes, by far the most common, are a pair of columns.
+                    const double * first = columns.data() + hapIndicies[0] * nReads;
+                    const double * second = columns.data() + hapIndicies[1] * nReads;
+                    for ( std::size_t readIndex = 0; readIndex < nReads; ++readIndex )
+                    {
+                        probReadsGivenGenotype[readIndex] =
+                            ( first[readIndex] + second[readIndex] ) * haplotypePriorProbability;
+                    }
+                }
+                else
                 {
-                    double sumReadLikelihoodsOverHaplotypes = 0.0;
+                    std::fill( probReadsGivenGenotype.begin(), probReadsGivenGenotype.end(), 0.0 );
                     for ( const auto & hapIndex : hapIndicies )
                     {
-                        sumReadLikelihoodsOverHaplotypes += probReadsGivenHaplotypes( readIndex, hapIndex );
+                        const double * column = columns.data() + hapIndex * nReads;
+                        for ( std::size_t readIndex = 0; readIndex < nReads; ++readIndex )
+                        {
+                            probReadsGivenGenotype[readIndex] += column[readIndex];
+                        }
+                    }
+                    for ( auto & prob : probReadsGivenGenotype )
+                    {
+                        prob *= haplotypePriorProbability;
                     }
-                    thisGenotypeLogLikelihood +=
-                        std::log( sumReadLikelihoodsOverHaplotypes * haplotypePriorProbability );
                 }
 
+                double thisGenotypeLogLikelihood = 0.0;
+                for ( const auto prob : probReadsGivenGenotype )
+                {
+                    thisGenotypeLogLikelihood += std::log( prob );
+                }
                 genotypeLikelihoods[genotypeIndex] = thisGenotypeLogLikelihood;
             }
 
@@ -3,8 +3,8 @@
 #define GENOTYPE_UTILS_HPP
 
 #include <algorithm>
-#include <boost/numeric/ublas/matrix.hpp>
-#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <cmath>
+#include <limits>
 #include "utils/matrix.hpp"
 #include "variant/genotype.hpp"
 
@@ -35,7 +35,7 @@ namespace caller
         }
 
         std::vector< double > computeGenotypeLikelihoods( const variant::GenotypeVector & genotypes,
-                                                          const utils::matrix_t & probReadsGivenHaplotypes,
+                                                          const utils::likelihoodMatrix_t & probReadsGivenHaplotypes,
                                                           const variant::HaplotypeVector & haplotypes );
     }
 }
@@ -21,15 +21,15 @@ namespace caller
         {
             if ( read.isReverse() )
             {
-                m_reverseSupportingVariant += probReadSupportsVariant;
-                m_reverseNotSupportingVariant += 1.0 - probReadSupportsVariant;
-                m_reverseSupportingReference += probReadSupportsReference;
+                m_readSupport.reverseSupportingVariant += probReadSupportsVariant;
+                m_readSupport.reverseNotSupportingVariant += 1.0 - probReadSupportsVariant;
+                m_readSupport.reverseSupportingReference += probReadSupportsReference;
             }
             else
             {
-                m_forwardSupportingVariant += probReadSupportsVariant;
-                m_forwardNotSupportingVariant += 1.0 - probReadSupportsVariant;
-                m_forwardSupportingReference += probReadSupportsReference;
+                m_readSupport.forwardSupportingVariant += probReadSupportsVariant;
+                m_readSupport.forwardNotSupportingVariant += 1.0 - probReadSupportsVariant;
+                m_readSupport.forwardSupportingReference += probReadSupportsReference;
             }
 
             if ( probReadSupportsVariant >= constants::thresholdForReadSupportingVariant )
@@ -38,52 +38,54 @@ namespace caller
 
                 const auto interval = m_regions.getSpan().interval();
 
-                m_minBaseQualitiesPerRead.push_back(
+                m_readSupport.minBaseQualitiesPerRead.push_back(
                     io::read::minBaseQualityInReadAroundInterval( read, interval, m_badReadsWindowSize ) );
-                m_mappingQuals.push_back( read.getMappingQuality() );
+                m_readSupport.mappingQuals.push_back( read.getMappingQuality() );
             }
         }
 
         phred_t VariantMetadata::getMedianMinBaseQualities() const
         {
-            if ( m_minBaseQualitiesPerRead.empty() )
+            if ( m_readSupport.minBaseQualitiesPerRead.empty() )
             {
                 return std::numeric_limits< phred_t >::quiet_NaN();
             }
             else
             {
-                return utils::functional::median( m_minBaseQualitiesPerRead );
+                return utils::functional::median( m_readSupport.minBaseQualitiesPerRead );
             }
         }
 
         int64_t VariantMetadata::getTotalForwardReads() const
         {
-            return static_cast< int64_t >( std::round( m_forwardSupportingVariant + m_forwardNotSupportingVariant ) );
+            return static_cast< int64_t >(
+                std::round( m_readSupport.forwardSupportingVariant + m_readSupport.forwardNotSupportingVariant ) );
         }
 
         int64_t VariantMetadata::getTotalReverseReads() const
         {
-            return static_cast< int64_t >( std::round( m_reverseSupportingVariant + m_reverseNotSupportingVariant ) );
+            return static_cast< int64_t >(
+                std::round( m_readSupport.reverseSupportingVariant + m_readSupport.reverseNotSupportingVariant ) );
         }
 
         int64_t VariantMetadata::getVariantSupportingForwardReads() const
         {
-            return static_cast< int64_t >( std::round( m_forwardSupportingVariant ) );
+            return static_cast< int64_t >( std::round( m_readSupport.forwardSupportingVariant ) );
         }
 
         int64_t VariantMetadata::getVariantSupportingReverseReads() const
         {
-            return static_cast< int64_t >( std::round( m_reverseSupportingVariant ) );
+            return static_cast< int64_t >( std::round( m_readSupport.reverseSupportingVariant ) );
         }
 
         int64_t VariantMetadata::getReferenceSupportingForwardReads() const
         {
-            return static_cast< int64_t >( std::round( m_forwardSupportingReference ) );
+            return static_cast< int64_t >( std::round( m_readSupport.forwardSupportingReference ) );
         }
 
         int64_t VariantMetadata::getReferenceSupportingReverseReads() const
         {
-            return static_cast< int64_t >( std::round( m_reverseSupportingReference ) );
+            return static_cast< int64_t >( std::round( m_readSupport.reverseSupportingReference ) );
         }
 
         int64_t VariantMetadata::getReferenceSupportingReads() const
@@ -96,10 +98,10 @@ namespace caller
         std::string VariantMetadata::toString() const
         {
             std::stringstream ss;
-            ss << "Forward supporting variant: " << m_forwardSupportingVariant << "\n"
-               << "Reverse supporting variant: " << m_reverseSupportingVariant << "\n"
-               << "Forward not supporting variant: " << m_forwardNotSupportingVariant << "\n"
-               << "Reverse not supporting variant: " << m_reverseNotSupportingVariant;
+            ss << "Forward supporting variant: " << m_readSupport.forwardSupportingVariant << "\n"
+               << "Reverse supporting variant: " << m_readSupport.reverseSupportingVariant << "\n"
+               << "Forward not supporting variant: " << m_readSupport.forwardNotSupportingVariant << "\n"
+               << "Reverse not supporting variant: " << m_readSupport.reverseNotSupportingVariant;
 
             return ss.str();
         }
@@ -18,10 +18,32 @@ namespace caller
         class VariantMetadata
         {
         public:
+            /// The reads accounted for, which is all the annotation of the variant needs once the reads are gone.
+            struct ReadSupport
+            {
+                double forwardSupportingVariant = 0.0;
+                double reverseSupportingVariant = 0.0;
+
+                double forwardNotSupportingVariant = 0.0;
+                double reverseNotSupportingVariant = 0.0;
+
+                double forwardSupportingReference = 0.0;
+                double reverseSupportingReference = 0.0;
+
+                std::vector< phred_t > minBaseQualitiesPerRead;
+                std::vector< int64_t > mappingQuals;
+            };
+
             VariantMetadata( const caller::SetRegions & regions, const int badReadsWindowSize )
                 : m_regions( regions ), m_badReadsWindowSize( badReadsWindowSize )
             {
             }
+
+            /// Metadata restored from the read support of a variant, to which no more reads can be added.
+            explicit VariantMetadata( const ReadSupport & readSupport )
+                : m_regions(), m_badReadsWindowSize( 0 ), m_readSupport( readSupport )
+            {
+            }
             void accountForRead( const double probReadSupportsVariant,
                                  const double probReadSupportsReference,
                                  const io::Read & read );
@@ -36,26 +58,19 @@ namespace caller
             int64_t getReferenceSupportingReverseReads() const;
             int64_t getReferenceSupportingReads() const;
 
-            double getRootMeanSquareMappingQuality() const { return stats::rootMeanSquare( m_mappingQuals ); }
+            double getRootMeanSquareMappingQuality() const
+            {
+                return stats::rootMeanSquare( m_readSupport.mappingQuals );
+            }
             phred_t getMedianMinBaseQualities() const;
 
             const caller::SetRegions & regions() const { return m_regions; }
+            const ReadSupport & readSupport() const { return m_readSupport; }
 
         private:
             const caller::SetRegions m_regions;
             const int m_badReadsWindowSize;
-
-            double m_forwardSupportingVariant = 0.0;
-            double m_reverseSupportingVariant = 0.0;
-
-            double m_forwardNotSupportingVariant = 0.0;
-            double m_reverseNotSupportingVariant = 0.0;
-
-            double m_forwardSupportingReference = 0.0;
-            double m_reverseSupportingReference = 0.0;
-
-            std::vector< phred_t > m_minBaseQualitiesPerRead;
-            std::vector< int64_t > m_mappingQuals;
+            ReadSupport m_readSupport;
 
         public:
             std::vector< phred_t > genotypeLikelihoods;
@@ -1,6 +1,7 @@
 // All content Copyright (C) 2018 Genomics plc
 #include "caller/diploid/variantQualityCalculator.hpp"
 #include "utils/indexedProduct.hpp"
+#include "utils/combinationGenerator.hpp"
 
 #include <numeric>
 
@@ -12,17 +13,89 @@ namespace caller
     {
         //-----------------------------------------------------------------------------------------
 
+        SampleGenotypeStatistics getSampleGenotypeStatistics( const bool hasReads,
+                                                              const std::vector< std::size_t > & haplotypesUsed,
+                                                              const variant::GenotypeVector & genotypes,
+                                                              const std::vector< double > & genotypeLikelihoods )
+        {
+            SampleGenotypeStatistics statistics;
+            statistics.hasReads = hasReads;
+            statistics.ploidy = genotypes.ploidy();
+            if ( not hasReads )
+            {
+                return statistics;
+            }
+
+            statistics.haplotypesUsed = haplotypesUsed;
+            statistics.weightedLikelihoods.reserve( genotypes.size() );
+            for ( std::size_t genotypeIndex = 0; genotypeIndex < genotypes.size(); ++genotypeIndex )
+            {
+                statistics.weightedLikelihoods.push_back( genotypeLikelihoods[genotypeIndex] *
+                                                          genotypes[genotypeIndex]->nCombinationsThisGenotype() );
+            }
+            return statistics;
+        }
+
+        //-----------------------------------------------------------------------------------------
+
+        VariantQualityCalculator::VariantQualityCalculator(
+            const std::vector< double > & haplotypeFrequencies,
+            const std::vector< SampleGenotypeStatistics > & sampleStatistics,
+            const std::vector< double > & variantPriors,
+            const variant::HaplotypeMembership & haplotypeMembership )
+            : m_haplotypeFrequencies( haplotypeFrequencies ),
+              m_sampleStatistics( sampleStatistics ),
+              m_variantPriors( variantPriors ),
+              m_haplotypeMembership( haplotypeMembership )
+        {
+            // Samples mostly share a ploidy and a number of haplotypes, so each genotype enumeration is built once
+            // rather than once per sample and variant.
+            for ( const auto & statistics : m_sampleStatistics )
+            {
+                if ( not statistics.hasReads )
+                {
+                    continue;
+                }
+
+                const auto key = std::make_pair( statistics.ploidy, statistics.haplotypesUsed.size() );
+                if ( m_genotypePositions.count( key ) == 0 )
+                {
+                    auto & positions = m_genotypePositions[key];
+                    if ( key.first > 0 )
+                    {
+                        for ( const std::vector< unsigned long > & combination :
+                              CombinationGenerator( key.first, key.second ) )
+                        {
+                            positions.insert( positions.end(), combination.cbegin(), combination.cend() );
+                        }
+                    }
+                }
+
+                WECALL_ASSERT( statistics.weightedLikelihoods.size() * statistics.ploidy ==
+                                   m_genotypePositions.at( key ).size(),
+                               "Genotype likelihoods do not match the genotypes of the haplotypes used" );
+            }
+        }
+
+        const std::vector< std::size_t > & VariantQualityCalculator::genotypePositions(
+            const SampleGenotypeStatistics & statistics ) const
+        {
+            return m_genotypePositions.at( std::make_pair( statistics.ploidy, statistics.haplotypesUsed.size() ) );
+        }
+
+        //-----------------------------------------------------------------------------------------
+
         std::vector< double > VariantQualityCalculator::computeReweightedHaplotypeFrequencies(
             const std::size_t variantIndex ) const
         {
             std::vector< double > reweightedFrequenciesWithoutVariant = m_haplotypeFrequencies;
 
-            const auto hapIndexesThisVariant =
-                m_candidateHaplotypes.getHaplotypeIndicesForVariant( m_candidateVariants[variantIndex] );
-
-            for ( const auto hapIndex : hapIndexesThisVariant )
+            for ( std::size_t hapIndex = 0; hapIndex < m_haplotypeFrequencies.size(); ++hapIndex )
             {
-                reweightedFrequenciesWithoutVariant[hapIndex] = 0.0;
+                if ( m_haplotypeMembership.containsVariant( variantIndex, hapIndex ) )
+                {
+                    reweightedFrequenciesWithoutVariant[hapIndex] = 0.0;
+                }
             }
 
             const auto sumFreqsWithoutVariant = std::accumulate( reweightedFrequenciesWithoutVariant.begin(),
@@ -30,7 +103,8 @@ namespace caller
 
             if ( sumFreqsWithoutVariant > 0.0 )
             {
-                for ( std::size_t haplotypeIndex = 0; haplotypeIndex < m_candidateHaplotypes.size(); ++haplotypeIndex )
+                for ( std::size_t haplotypeIndex = 0; haplotypeIndex < m_haplotypeFrequencies.size();
+                      ++haplotypeIndex )
                 {
                     reweightedFrequenciesWithoutVariant[haplotypeIndex] /= sumFreqsWithoutVariant;
                 }
@@ -41,8 +115,8 @@ namespace caller
 
         std::vector< double > VariantQualityCalculator::getQualities() const
         {
-            std::vector< double > variantQualities( m_candidateVariants.size() );
-            for ( std::size_t varIndex = 0; varIndex < m_candidateVariants.size(); ++varIndex )
+            std::vector< double > variantQualities( m_variantPriors.size() );
+            for ( std::size_t varIndex = 0; varIndex < m_variantPriors.size(); ++varIndex )
             {
                 variantQualities[varIndex] = this->computeVariantQuality( varIndex );
             }
@@ -53,13 +127,8 @@ namespace caller
 
         double VariantQualityCalculator::computeVariantQuality( const std::size_t variantIndex ) const
         {
-            const auto variant = m_candidateVariants[variantIndex];
-            const auto prior = variant->prior();
+            const auto prior = m_variantPriors[variantIndex];
             const auto logOfMinDouble = log( std::numeric_limits< double >::min() );
-            const auto & samples = m_samples;
-            const auto nSamples = m_samples.size();
-
-            const auto & reads = m_readRangesPerSample;
 
             const auto reweightedFrequenciesWithoutVariant =
                 this->computeReweightedHaplotypeFrequencies( variantIndex );
@@ -67,14 +136,9 @@ namespace caller
             auto sumLogProbNoVariant = 0.0;
             auto sumLogTotalEvents = 0.0;
 
-            for ( std::size_t sampleIndex = 0; sampleIndex < nSamples; ++sampleIndex )
+            for ( const auto & statistics : m_sampleStatistics )
             {
-                const auto & sample = samples[sampleIndex];
-                const auto nGenotypes = m_candidateGenotypes.at( sample ).size();
-                const auto & readItPair = reads.at( sample );
-                const auto nReads = std::distance( readItPair.begin(), readItPair.end() );
-
-                if ( nReads == 0 )
+                if ( not statistics.hasReads )
                 {
                     continue;
                 }
@@ -82,19 +146,26 @@ namespace caller
                 auto sumProbNoVariantThisIndividual = 0.0;
                 auto sumProbTotalThisIndividual = 0.0;
 
+                const auto & positions = this->genotypePositions( statistics );
+                std::vector< std::size_t > hapIndicies( statistics.ploidy );
+
+                const auto nGenotypes = statistics.weightedLikelihoods.size();
                 for ( std::size_t genotypeIndex = 0; genotypeIndex < nGenotypes; ++genotypeIndex )
                 {
-                    const auto hapIndicies = m_candidateGenotypes.at( sample ).getHaplotypeIndices( genotypeIndex );
+                    for ( std::size_t i = 0; i < statistics.ploidy; ++i )
+                    {
+                        hapIndicies[i] = statistics.haplotypesUsed[positions[genotypeIndex * statistics.ploidy + i]];
+                    }
+                    const auto hapIndiciesBegin = hapIndicies.cbegin();
+                    const auto hapIndiciesEnd = hapIndicies.cend();
 
-                    const auto adjustedGenotypeLikelihood =
-                        m_genotypeLikelihoods[sampleIndex][genotypeIndex] *
-                        m_candidateGenotypes.at( sample )[genotypeIndex]->nCombinationsThisGenotype();
+                    const auto adjustedGenotypeLikelihood = statistics.weightedLikelihoods[genotypeIndex];
 
-                    sumProbTotalThisIndividual += utils::indexedProduct(
-                        m_haplotypeFrequencies, hapIndicies.cbegin(), hapIndicies.cend(), adjustedGenotypeLikelihood );
+                    sumProbTotalThisIndividual += utils::indexedProduct( m_haplotypeFrequencies, hapIndiciesBegin,
+                                                                         hapIndiciesEnd, adjustedGenotypeLikelihood );
                     sumProbNoVariantThisIndividual +=
-                        utils::indexedProduct( reweightedFrequenciesWithoutVariant, hapIndicies.cbegin(),
-                                               hapIndicies.cend(), adjustedGenotypeLikelihood );
+                        utils::indexedProduct( reweightedFrequenciesWithoutVariant, hapIndiciesBegin, hapIndiciesEnd,
+                                               adjustedGenotypeLikelihood );
                 }
 
                 sumLogTotalEvents +=
@@ -113,9 +184,9 @@ namespace caller
             {
                 WECALL_LOG( SUPER_DEBUG, "sumLogProbNoVariant " << sumLogProbNoVariant );
                 WECALL_LOG( SUPER_DEBUG, "sumLogTotalEvents " << sumLogTotalEvents );
-                WECALL_LOG( SUPER_DEBUG, "Prior is " << prior << " for var " << variant->toString() );
-                WECALL_LOG( SUPER_DEBUG, "Ratio is " << weightedRatio << " for var " << variant->toString() );
-                WECALL_LOG( SUPER_DEBUG, "Posterior is " << posterior << " for var " << variant->toString() );
+                WECALL_LOG( SUPER_DEBUG, "Prior is " << prior << " for var " << variantIndex );
+                WECALL_LOG( SUPER_DEBUG, "Ratio is " << weightedRatio << " for var " << variantIndex );
+                WECALL_LOG( SUPER_DEBUG, "Posterior is " << posterior << " for var " << variantIndex );
             }
 
             return posterior;
@@ -2,10 +2,9 @@
 #ifndef WECALL_VARIANT_QUALITY_CALCULATOR_HPP
 #define WECALL_VARIANT_QUALITY_CALCULATOR_HPP
 
-#include <boost/numeric/ublas/matrix.hpp>
+#include <map>
 #include <vector>
 #include "utils/logging.hpp"
-#include "io/readRange.hpp"
 #include "variant/genotype.hpp"
 
 namespace wecall
@@ -14,27 +13,40 @@ namespace caller
 {
     namespace model
     {
+        /// What variant quality needs to know about one sample at a cluster. It is extracted as soon as the sample
+        /// has been genotyped, so the sample's GenotypeVector and read likelihoods can be released. Variant quality
+        /// needs the cohort haplotype frequencies, which are only known once every sample is done, so one of these
+        /// is still kept per sample: a cluster's memory grows linearly with the number of samples.
+        struct SampleGenotypeStatistics
+        {
+            SampleGenotypeStatistics() : hasReads( false ), ploidy( 0 ) {}
+
+            /// Samples without reads at the cluster do not contribute to variant quality.
+            bool hasReads;
+            std::size_t ploidy;
+
+            /// The haplotypes the sample's genotypes are formed from. The genotypes are every multiset of ploidy of
+            /// them, in the order variant::GenotypeVector enumerates them.
+            std::vector< std::size_t > haplotypesUsed;
+
+            /// The likelihood of each genotype multiplied by the number of orderings of its haplotypes.
+            std::vector< double > weightedLikelihoods;
+        };
+
+        SampleGenotypeStatistics getSampleGenotypeStatistics( const bool hasReads,
+                                                              const std::vector< std::size_t > & haplotypesUsed,
+                                                              const variant::GenotypeVector & genotypes,
+                                                              const std::vector< double > & genotypeLikelihoods );
+
         class VariantQualityCalculator
         {
         public:
             VariantQualityCalculator() = delete;
 
             VariantQualityCalculator( const std::vector< double > & haplotypeFrequencies,
-                                      const std::vector< std::vector< double > > & genotypeLikelihoods,
-                                      const io::perSampleRegionsReads_t & readRangesPerSample,
-                                      const std::vector< std::string > & samples,
-                                      const std::vector< variant::varPtr_t > & candidateVariants,
-                                      const variant::HaplotypeVector & candiateHaplotypes,
-                                      const std::map< std::string, variant::GenotypeVector > & candidateGenotypes )
-                : m_haplotypeFrequencies( haplotypeFrequencies ),
-                  m_genotypeLikelihoods( genotypeLikelihoods ),
-                  m_readRangesPerSample( readRangesPerSample ),
-                  m_samples( samples ),
-                  m_candidateVariants( candidateVariants ),
-                  m_candidateHaplotypes( candiateHaplotypes ),
-                  m_candidateGenotypes( candidateGenotypes )
-            {
-            }
+                                      const std::vector< SampleGenotypeStatistics > & sampleStatistics,
+                                      const std::vector< double > & variantPriors,
+                                      const variant::HaplotypeMembership & haplotypeMembership );
 
             std::vector< double > getQualities() const;
 
@@ -43,14 +55,16 @@ namespace caller
 
             std::vector< double > computeReweightedHaplotypeFrequencies( const std::size_t variantIndex ) const;
 
+            /// Positions in SampleGenotypeStatistics::haplotypesUsed of the haplotypes of each genotype, ploidy
+            /// entries per genotype, keyed by ploidy and number of haplotypes used.
+            const std::vector< std::size_t > & genotypePositions( const SampleGenotypeStatistics & statistics ) const;
+
         private:
             const std::vector< double > & m_haplotypeFrequencies;
-            const std::vector< std::vector< double > > & m_genotypeLikelihoods;
-            const io::perSampleRegionsReads_t & m_readRangesPerSample;
-            const std::vector< std::string > m_samples;
-            const std::vector< variant::varPtr_t > & m_candidateVariants;
-            const variant::HaplotypeVector & m_candidateHaplotypes;
-            const std::map< std::string, variant::GenotypeVector > & m_candidateGenotypes;
+            const std::vector< SampleGenotypeStatistics > & m_sampleStatistics;
+            const std::vector< double > & m_variantPriors;
+            const variant::HaplotypeMembership & m_haplotypeMembership;
+            std::map< std::pair< std::size_t, std::size_t >, std::vector< std::size_t > > m_genotypePositions;
         };
     }
 }
@@ -0,0 +1,111 @@
+// All content Copyright (C) 2018 Genomics plc
+#include "caller/haplotypeIndex.hpp"
+#include "caller/haplotypeLikelihoods.hpp"
+#include "common.hpp"
+
+#include <unordered_map>
+
+namespace wecall
+{
+namespace caller
+{
+    namespace
+    {
+        struct IdenticalReadHash
+        {
+            std::size_t operator()( const io::Read * read ) const
+            {
+                std::size_t hash = 14695981039346656037ULL;
+                const auto combine = [&hash]( const std::size_t value )
+                {
+                    hash = ( hash ^ value ) * 1099511628211ULL;
+                };
+                for ( auto it = read->sequence().cbegin(); it != read->sequence().cend(); ++it )
+                {
+                    combine( static_cast< std::size_t >( *it ) );
+                }
+                combine( std::hash< std::string >()( read->getQualities() ) );
+                combine( std::hash< int64_t >()( read->getStartPos() ) );
+                combine( std::hash< int64_t >()( read->getMappingQuality() ) );
+                return hash;
+            }
+        };
+
+        struct IdenticalReadEqual
+        {
+            bool operator()( const io::Read * lhs, const io::Read * rhs ) const
+            {
+                return lhs->getStartPos() == rhs->getStartPos() and
+                       lhs->getMappingQuality() == rhs->getMappingQuality() and
+                       lhs->getQualities() == rhs->getQualities() and lhs->sequence() == rhs->sequence();
+            }
+        };
+    }
+
+    IdenticalReadGroups::IdenticalReadGroups( const io::RegionsReads & readRange )
+    {
+        std::unordered_map< const io::Read *, std::size_t, IdenticalReadHash, IdenticalReadEqual > groups;
+        for ( const auto & read : readRange )
+        {
+            const auto inserted = groups.emplace( &read, m_firstReads.size() );
+            if ( inserted.second )
+            {
+                m_firstReads.push_back( &read );
+            }
+            m_readGroups.push_back( inserted.first->second );
+        }
+    }
+
+    HaplotypeSequenceIndex::HaplotypeSequenceIndex( const utils::BasePairSequence & paddedHaplotypeSequence )
+        : m_hashMapper( paddedHaplotypeSequence, constants::needlemanWunschPadding, constants::needlemanWunschPadding ),
+          m_aligner( paddedHaplotypeSequence,
+                     constants::gapExtendPenalty,
+                     constants::nucleotidePrior,
+                     alignment::computeGapOpen( paddedHaplotypeSequence, errorModels::illuminaErrorModel ) )
+    {
+    }
+
+    const HaplotypeSequenceIndex & HaplotypeIndex::get( const utils::BasePairSequence & paddedHaplotypeSequence )
+    {
+        Entry< HaplotypeSequenceIndex > * entry = nullptr;
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            // The sequence is only copied into the key when its entry is added.
+            entry = &m_entries[paddedHaplotypeSequence];
+        }
+
+        // Built outside the lock so that indices of different sequences can be built concurrently.
+        std::call_once( entry->m_built, [this, entry, &paddedHaplotypeSequence]()
+                        {
+                            const auto start = std::chrono::steady_clock::now();
+                            entry->m_index.reset( new HaplotypeSequenceIndex( paddedHaplotypeSequence ) );
+                            if ( m_timer )
+                            {
+                                m_timer->addDuration( std::chrono::duration_cast< std::chrono::microseconds >(
+                                    std::chrono::steady_clock::now() - start ) );
+                            }
+                        } );
+        return *entry->m_index;
+    }
+    const IdenticalReadGroups & HaplotypeIndex::identicalReads( const io::RegionsReads & readRange )
+    {
+        std::vector< const io::Read * > reads;
+        for ( const auto & read : readRange )
+        {
+            reads.push_back( &read );
+        }
+
+        Entry< IdenticalReadGroups > * entry = nullptr;
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            entry = &m_readGroups[reads];
+        }
+
+        std::call_once( entry->m_built, [entry, &readRange]()
+                        {
+                            entry->m_index.reset( new IdenticalReadGroups( readRange ) );
+                        } );
+        return *entry->m_index;
+    }
+}
+}
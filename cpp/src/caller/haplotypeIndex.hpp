@@ -0,0 +1,76 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef HAPLOTYPE_INDEX_HPP
+#define HAPLOTYPE_INDEX_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "alignment/galign.hpp"
+#include "io/readRange.hpp"
+#include "mapping/hashMapper.hpp"
+#include "utils/sequence.hpp"
+#include "utils/timer.hpp"
+
+namespace wecall
+{
+namespace caller
+{
+    /// Everything needed to compute likelihoods of reads given a padded haplotype sequence: the hash mapper that
+    /// finds where reads could align, and the aligner with the gap open penalties of the sequence.
+    struct HaplotypeSequenceIndex
+    {
+        explicit HaplotypeSequenceIndex( const utils::BasePairSequence & paddedHaplotypeSequence );
+
+        const mapping::HashMapper m_hashMapper;
+        const alignment::GAlign m_aligner;
+    };
+
+    /// The reads of a read range grouped by identical sequence, qualities, start and mapping quality. These are
+    /// all a likelihood depends on, so every read of a group has the same likelihood on every haplotype and only
+    /// the first of each needs aligning; grouping never changes the results.
+    struct IdenticalReadGroups
+    {
+        explicit IdenticalReadGroups( const io::RegionsReads & readRange );
+
+        /// First read of each group.
+        std::vector< const io::Read * > m_firstReads;
+
+        /// Group of each read of the range, in range order.
+        std::vector< std::size_t > m_readGroups;
+    };
+
+    /// Indices of the padded haplotype sequences of a cluster, and groups of identical reads of its read ranges.
+    /// Each is built the first time it is asked for, and is then shared read-only by the haplotype ranker and all
+    /// samples, on any thread.
+    class HaplotypeIndex
+    {
+    public:
+        /// @param timer Timer to add the time spent building indices to, if any.
+        explicit HaplotypeIndex( utils::timerPtr_t timer = nullptr ) : m_timer( timer ) {}
+
+        const HaplotypeSequenceIndex & get( const utils::BasePairSequence & paddedHaplotypeSequence );
+
+        /// Groups of identical reads of readRange. Ranges are known by the reads they hold, so every ranker pass
+        /// and the model share the groups of a sample.
+        const IdenticalReadGroups & identicalReads( const io::RegionsReads & readRange );
+
+    private:
+        template < typename Index >
+        struct Entry
+        {
+            std::once_flag m_built;
+            std::unique_ptr< const Index > m_index;
+        };
+
+        const utils::timerPtr_t m_timer;
+        std::mutex m_mutex;
+        std::unordered_map< utils::BasePairSequence, Entry< HaplotypeSequenceIndex > > m_entries;
+        std::map< std::vector< const io::Read * >, Entry< IdenticalReadGroups > > m_readGroups;
+    };
+}
+}
+
+#endif
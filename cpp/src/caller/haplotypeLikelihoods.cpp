@@ -1,5 +1,4 @@
 // All content Copyright (C) 2018 Genomics plc
-#include <boost/numeric/ublas/matrix_proxy.hpp>
 #include "caller/haplotypeLikelihoods.hpp"
 #include "alignment/aligner.hpp"
 #include "utils/matrix.hpp"
@@ -8,55 +7,60 @@ namespace wecall
 {
 namespace caller
 {
-    std::vector< double > computeHaplotypeFrequencies( const utils::matrix_t & haplotypeLikelihoods )
+    std::vector< double > computeHaplotypeFrequencies( const utils::likelihoodMatrix_t & haplotypeLikelihoods )
     {
-        std::vector< double > haplotypeFrequencies( haplotypeLikelihoods.size2(), 0.0 );
-        for ( std::size_t haplotypeIndex = 0; haplotypeIndex != haplotypeLikelihoods.size2(); ++haplotypeIndex )
-        {
-            const auto column = utils::matrixColumn_t( haplotypeLikelihoods, haplotypeIndex );
-            const auto hapFreq = std::accumulate( column.begin(), column.end(), 0.0 );
-            haplotypeFrequencies[haplotypeIndex] = hapFreq;
-        }
-        return haplotypeFrequencies;
+        return utils::columnSums( haplotypeLikelihoods );
     }
 
-    utils::matrix_t computeHaplotypeLikelihoods( const variant::HaplotypeVector & haplotypes,
-                                                 const io::RegionsReads & readRange )
+    utils::likelihoodMatrix_t computeHaplotypeLikelihoods( const variant::HaplotypeVector & haplotypes,
+                                                           const io::RegionsReads & readRange,
+                                                           ReadLikelihoodCache * likelihoodCache,
+                                                           HaplotypeIndex * haplotypeIndex )
     {
+        HaplotypeIndex localHaplotypeIndex;
+        auto & index = haplotypeIndex == nullptr ? localHaplotypeIndex : *haplotypeIndex;
+
         const auto nReads = static_cast< std::size_t >( std::distance( readRange.begin(), readRange.end() ) );
         const auto haplotypeSeqStart = haplotypes.paddedReferenceSequence()->start();
 
-        utils::matrix_t readScores( nReads, haplotypes.size() );
+        utils::likelihoodMatrix_t readScores( nReads, haplotypes.size() );
+
+        // Identical reads are only aligned once. Each read keeps its own row of the result, as annotation needs
+        // per-read likelihoods, so the rest of a group get a copy of the likelihoods of its first read.
+        const auto & identicalReads = index.identicalReads( readRange );
+        const auto & reads = identicalReads.m_firstReads;
+        const auto nUniqueReads = reads.size();
 
         for ( std::size_t haplotypeIndex = 0; haplotypeIndex < haplotypes.size(); ++haplotypeIndex )
         {
             const auto & paddedHaplotypeSequences = haplotypes[haplotypeIndex].paddedSequences();
 
-            std::vector< mapping::HashMapper > hashMappers;
-            std::vector< alignment::GAlign > aligners;
+            std::vector< double > maxReadScores( nUniqueReads, 0.0 );
             for ( const auto & paddedHaplotypeSequence : paddedHaplotypeSequences )
             {
-                hashMappers.emplace_back( paddedHaplotypeSequence, constants::needlemanWunschPadding,
-                                          constants::needlemanWunschPadding );
-                aligners.emplace_back(
-                    paddedHaplotypeSequence, constants::gapExtendPenalty, constants::nucleotidePrior,
-                    alignment::computeGapOpen( paddedHaplotypeSequence, errorModels::illuminaErrorModel ) );
-            }
+                // All reads are aligned against a haplotype sequence together, so that reads of equal length share
+                // passes of the alignment kernel.
+                const auto computeLikelihoods = [&]( const std::vector< const io::Read * > & readsToAlign )
+                {
+                    const auto & sequenceIndex = index.get( paddedHaplotypeSequence );
+                    return alignment::computeLikelihoodsForReadsAndHaplotype(
+                        readsToAlign, haplotypeSeqStart, sequenceIndex.m_hashMapper, sequenceIndex.m_aligner );
+                };
 
-            std::size_t readIndex = 0;
-            for ( const auto & read : readRange )
-            {
-                const auto hintPosition = read.getStartPos() - haplotypeSeqStart;
-                double maxReadScore = 0.0;
-                for ( std::size_t sequenceIndex = 0; sequenceIndex < paddedHaplotypeSequences.size(); ++sequenceIndex )
+                const auto likelihoods =
+                    likelihoodCache == nullptr
+                        ? computeLikelihoods( reads )
+                        : likelihoodCache->getLikelihoods( paddedHaplotypeSequence.str(), haplotypeSeqStart, reads,
+                                                           computeLikelihoods );
+                for ( std::size_t readIndex = 0; readIndex < nUniqueReads; ++readIndex )
                 {
-                    maxReadScore = std::max(
-                        maxReadScore, computeLikelihoodForReadAndHaplotype(
-                                          read, hintPosition, hashMappers[sequenceIndex], aligners[sequenceIndex] ) );
+                    maxReadScores[readIndex] = std::max( maxReadScores[readIndex], likelihoods[readIndex] );
                 }
+            }
 
-                readScores( readIndex, haplotypeIndex ) = maxReadScore;
-                ++readIndex;
+            for ( std::size_t readIndex = 0; readIndex < nReads; ++readIndex )
+            {
+                readScores( readIndex, haplotypeIndex ) = maxReadScores[identicalReads.m_readGroups[readIndex]];
             }
         }
 
@@ -83,10 +87,10 @@ namespace caller
                 }
 
                 debugMessage << std::endl;
-                for ( std::size_t hap_index = 0; hap_index < readScores.size2(); ++hap_index )
+                for ( std::size_t hap_index = 0; hap_index < readScores.nColumns(); ++hap_index )
                 {
                     debugMessage << "\tHaplotype scores for : " << haplotypes[hap_index].toString() << std::endl;
-                    for ( std::size_t read_index = 0; read_index < readScores.size1(); ++read_index )
+                    for ( std::size_t read_index = 0; read_index < readScores.nRows(); ++read_index )
                     {
                         debugMessage << readScores( read_index, hap_index ) << ", ";
                     }
@@ -6,6 +6,8 @@
 #include "variant/haplotype.hpp"
 #include "io/readRange.hpp"
 #include "alignment/galign.hpp"
+#include "caller/haplotypeIndex.hpp"
+#include "caller/readLikelihoodCache.hpp"
 
 namespace wecall
 {
@@ -18,10 +20,15 @@ namespace caller
             7,  6,  6,  6,  5,  5,  5,  4,  4,  4,  3,  3,  3,  3,  2,  2,  2,  2,  2,  1, 1, 1, 1, 1};
     }
 
-    utils::matrix_t computeHaplotypeLikelihoods( const variant::HaplotypeVector & haplotypes,
-                                                 const io::RegionsReads & readRange );
+    /// Likelihood of each read given each haplotype, taking and storing likelihoods in likelihoodCache if one is
+    /// given. Haplotype sequences are indexed in haplotypeIndex if one is given, so that callers computing
+    /// likelihoods for several samples index each sequence once.
+    utils::likelihoodMatrix_t computeHaplotypeLikelihoods( const variant::HaplotypeVector & haplotypes,
+                                                           const io::RegionsReads & readRange,
+                                                           ReadLikelihoodCache * likelihoodCache = nullptr,
+                                                           HaplotypeIndex * haplotypeIndex = nullptr );
 
-    std::vector< double > computeHaplotypeFrequencies( const utils::matrix_t & haplotypeLikelihoods );
+    std::vector< double > computeHaplotypeFrequencies( const utils::likelihoodMatrix_t & haplotypeLikelihoods );
 }
 }
 
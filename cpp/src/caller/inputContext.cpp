@@ -0,0 +1,47 @@
+// All content Copyright (C) 2018 Genomics plc
+#include "caller/inputContext.hpp"
+#include "utils/logging.hpp"
+
+#include <algorithm>
+
+namespace wecall
+{
+namespace caller
+{
+    InputContext::InputContext( const params::Data & dataParams,
+                                const params::System & systemParams,
+                                const params::PrivateData & privateDataParams )
+        : m_reference( std::make_shared< const io::ReferenceStore >(
+              dataParams.refFile(),
+              std::make_shared< const io::FastaIndex >( io::fastaIndexFileName( dataParams.refFile() ) ) ) ),
+          m_candidateVariantsFile(
+              privateDataParams.m_candidateVariantsFile.empty()
+                  ? nullptr
+                  : std::make_shared< io::TabixVCFFile >( privateDataParams.m_candidateVariantsFile,
+                                                          privateDataParams.m_candidateVariantsFile + ".tbi" ) ),
+          m_genotypeAllelesFile( privateDataParams.genotypingMode()
+                                     ? std::make_shared< io::TabixVCFFile >(
+                                           privateDataParams.genotypeAllelesFile(),
+                                           privateDataParams.genotypeAllelesFile() + ".tbi" )
+                                     : nullptr )
+    {
+        for ( const auto & sourceName : dataParams.inputDataSources() )
+        {
+            WECALL_LOG( DEBUG, "Opening data source " << sourceName );
+            m_bamFiles.push_back( std::make_shared< io::BamFile >( sourceName, systemParams.m_decompressionThreads ) );
+
+            // Duplicate samples are merged, as io::ReadDataReader does.
+            for ( const auto & sampleName : m_bamFiles.back()->getSampleNames() )
+            {
+                if ( std::find( m_sampleNames.begin(), m_sampleNames.end(), sampleName ) == m_sampleNames.end() )
+                {
+                    m_sampleNames.push_back( sampleName );
+                }
+            }
+        }
+
+        m_intermediateOutputWriter = std::make_shared< corrector::IntermediateOutputWriter >(
+            m_bamFiles, privateDataParams.m_intermediateRecalibFileStem );
+    }
+}
+}
@@ -0,0 +1,63 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef INPUT_CONTEXT_HPP
+#define INPUT_CONTEXT_HPP
+
+#include <memory>
+#include <vector>
+
+#include "caller/params.hpp"
+#include "io/bamFile.hpp"
+#include "io/fastaFile.hpp"
+#include "io/referenceStore.hpp"
+#include "io/tabixVCFFile.hpp"
+#include "readrecalibration/intermediateOutputWriter.hpp"
+
+namespace wecall
+{
+namespace caller
+{
+    /// The inputs of a run that do not change while it runs: the headers, indices and samples of the BAM files,
+    /// the reference and its index, and the candidate and genotyping allele files. They are loaded once
+    /// and shared by all jobs of the run, which read through cursors of their own on top of them.
+    class InputContext
+    {
+    public:
+        InputContext( const params::Data & dataParams,
+                      const params::System & systemParams,
+                      const params::PrivateData & privateDataParams );
+
+        InputContext( const InputContext & rhs ) = delete;
+        InputContext & operator=( const InputContext & ) = delete;
+
+        const std::vector< io::bamFilePtr_t > & bamFiles() const { return m_bamFiles; }
+
+        /// Samples of all BAM files, in the order the jobs of the run see them.
+        const std::vector< std::string > & sampleNames() const { return m_sampleNames; }
+
+        io::referenceStorePtr_t reference() const { return m_reference; }
+
+        /// Null unless candidate variants are read from a file.
+        std::shared_ptr< io::TabixVCFFile > candidateVariantsFile() const { return m_candidateVariantsFile; }
+
+        /// Null unless running in genotyping mode.
+        std::shared_ptr< io::TabixVCFFile > genotypeAllelesFile() const { return m_genotypeAllelesFile; }
+
+        std::shared_ptr< corrector::IntermediateOutputWriter > intermediateOutputWriter() const
+        {
+            return m_intermediateOutputWriter;
+        }
+
+    private:
+        std::vector< io::bamFilePtr_t > m_bamFiles;
+        std::vector< std::string > m_sampleNames;
+        io::referenceStorePtr_t m_reference;
+        std::shared_ptr< io::TabixVCFFile > m_candidateVariantsFile;
+        std::shared_ptr< io::TabixVCFFile > m_genotypeAllelesFile;
+        std::shared_ptr< corrector::IntermediateOutputWriter > m_intermediateOutputWriter;
+    };
+
+    using inputContextPtr_t = std::shared_ptr< const InputContext >;
+}
+}
+
+#endif
@@ -25,9 +25,13 @@
 #include "utils/exceptions.hpp"
 #include "utils/logging.hpp"
 #include "utils/flatten.hpp"
+#include "utils/taskPool.hpp"
 
 #include <algorithm>
+#include <iterator>
 #include <limits>
+#include <numeric>
+#include <thread>
 #include <boost/filesystem/operations.hpp>
 
 using namespace wecall::io;
@@ -39,6 +43,79 @@ namespace caller
 {
     //-----------------------------------------------------------------------------------------
 
+    namespace
+    {
+        // Cluster and sample threads share one pool per job, which is capped so that the jobs run at once do not
+        // start more threads than there are cores. Returns null if calling is not to be threaded.
+        utils::TaskPool * makeTaskPool( const caller::params::System & systemParams )
+        {
+            const auto requestedThreads = std::max( systemParams.m_clusterThreads, systemParams.m_sampleThreads );
+            auto numberOfThreads = requestedThreads;
+
+            const std::size_t numberOfCores = std::thread::hardware_concurrency();
+            if ( numberOfCores > 0 )
+            {
+                const auto concurrentJobs = std::max( systemParams.m_numberOfJobs, std::size_t( 1 ) );
+                const auto coresPerJob = std::max( numberOfCores / concurrentJobs, std::size_t( 1 ) );
+                numberOfThreads = std::min( numberOfThreads, coresPerJob );
+            }
+
+            if ( numberOfThreads < requestedThreads )
+            {
+                WECALL_LOG( DEBUG, "Calling each job on " << numberOfThreads << " threads rather than "
+                                                           << requestedThreads << " to stay within "
+                                                           << numberOfCores << " cores" );
+            }
+
+            return numberOfThreads > 1 ? new utils::TaskPool( numberOfThreads ) : nullptr;
+        }
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    void writeVCFHeader( io::VCFWriter & vcOut,
+                         const caller::params::Application & applicationParams,
+                         const caller::params::Data & dataParams,
+                         const caller::params::PrivateCalling & privateCallingParams,
+                         const caller::params::Calling & callingParams,
+                         const std::vector< std::string > & sampleNames,
+                         const io::FastaIndex & refIndex )
+    {
+        const auto outputRegions = utils::functional::flatten( dataParams.dataRegions() );
+        writeVCFHeader( vcOut, applicationParams, dataParams.outputFormat(), dataParams.refFile(), privateCallingParams,
+                        callingParams, sampleNames, caller::getContigsFromRegions( outputRegions, refIndex.contigs() ) );
+    }
+
+    void writeVCFHeader( io::VCFWriter & vcOut,
+                         const caller::params::Application & applicationParams,
+                         const std::string & outputFormat,
+                         const std::string & refFile,
+                         const caller::params::PrivateCalling & privateCallingParams,
+                         const caller::params::Calling & callingParams,
+                         const std::vector< std::string > & sampleNames,
+                         const std::vector< Region > & contigs )
+    {
+        WECALL_LOG( DEBUG, "Writing VCF header" );
+
+        const varfilters::VariantSoftFilterBank variantSoftFilterBank( privateCallingParams.m_varFilterIDs,
+                                                                       callingParams.m_minAlleleBiasP,
+                                                                       callingParams.m_minStrandBiasP,
+                                                                       callingParams.m_minAllelePlusStrandBiasP,
+                                                                       callingParams.m_minRMSMappingQ,
+                                                                       callingParams.m_minSNPQOverDepth,
+                                                                       callingParams.m_minIndelQOverDepth,
+                                                                       callingParams.m_minBadReadsScore,
+                                                                       callingParams.m_minCallQual );
+
+        std::vector< vcf::FilterDesc > filterDescs = variantSoftFilterBank.getFilterDescs();
+        filterDescs.emplace_back( vcf::filter::NC_key,
+                                  "Not called: Indicates a variant that was not positively genotyped in any sample." );
+
+        vcOut.writeHeader( outputFormat, applicationParams, refFile, sampleNames, filterDescs, contigs );
+    }
+
+    //-----------------------------------------------------------------------------------------
+
     Job::Job( caller::params::Application applicationParams,
               caller::params::Data dataParams,
               caller::params::System systemParams,
@@ -46,7 +123,9 @@ namespace caller
               caller::params::Filters filterParams,
               caller::params::PrivateCalling privateCallingParams,
               caller::params::Calling callingParams,
-              caller::params::PrivateData privateDataParams )
+              caller::params::PrivateData privateDataParams,
+              std::function< void( const std::string & ) > commitOutput,
+              inputContextPtr_t inputContext )
         : m_applicationParams( applicationParams ),
           m_dataParams( dataParams ),
           m_systemParams( systemParams ),
@@ -55,17 +134,12 @@ namespace caller
           m_privateCallingParams( privateCallingParams ),
           m_callingParams( callingParams ),
           m_privateDataParams( privateDataParams ),
-          m_candidateVCFFile(
-              privateDataParams.m_candidateVariantsFile.empty()
-                  ? nullptr
-                  : std::make_shared< io::TabixVCFFile >( privateDataParams.m_candidateVariantsFile,
-                                                          privateDataParams.m_candidateVariantsFile + ".tbi" ) ),
-          m_genotypeAllelesVCFFile(
-              privateDataParams.genotypingMode()
-                  ? std::make_shared< io::TabixVCFFile >( privateDataParams.genotypeAllelesFile(),
-                                                          privateDataParams.genotypeAllelesFile() + ".tbi" )
-                  : nullptr ),
-          m_intermediateOutputWriter( dataParams.inputDataSources(), privateDataParams.m_intermediateRecalibFileStem ),
+          m_inputs( inputContext != nullptr
+                        ? inputContext
+                        : std::make_shared< const InputContext >( dataParams, systemParams, privateDataParams ) ),
+          m_candidateVCFFile( m_inputs->candidateVariantsFile() ),
+          m_genotypeAllelesVCFFile( m_inputs->genotypeAllelesFile() ),
+          m_intermediateOutputWriter( m_inputs->intermediateOutputWriter() ),
           m_variantSoftFilterBank( privateCallingParams.m_varFilterIDs,
                                    callingParams.m_minAlleleBiasP,
                                    callingParams.m_minStrandBiasP,
@@ -79,37 +153,88 @@ namespace caller
                             privateSystemParams,
                             filterParams,
                             privateSystemParams.m_biteSize,
-                            dataParams.inputDataSources() ),
-          m_vcOut( dataParams.outputDataSink(), dataParams.outputRefCalls(), callingParams.m_outputPhasedGenotypes ),
-          m_ref( dataParams.refFile() ),
+                            m_inputs->bamFiles() ),
+          m_commitOutput( commitOutput ),
+          m_ref( m_inputs->reference() ),
           // TODO(ES): Tie together contig, calling and output regions together into nice container.
           m_outputRegions( utils::functional::flatten( dataParams.dataRegions() ) ),
           m_callingRegions( utils::functional::flatten(
               caller::padPartitionedRegions( dataParams.dataRegions(), m_privateCallingParams.m_regionPadding ) ) ),
+          m_taskPool( makeTaskPool( systemParams ) ),
           m_model( callingParams.m_badReadsWindowSize,
                    privateCallingParams.m_maxHaplotypesPerCluster,
-                   m_readDataReader.getSampleNames() ),
+                   m_readDataReader.getSampleNames(),
+                   systemParams.m_sampleThreads > 1 ? m_taskPool.get() : nullptr ),
           m_variantCallBuilder( dataParams.outputRefCalls(),
                                 callingParams.m_outputPhasedGenotypes,
                                 privateCallingParams.m_allVariants,
                                 privateDataParams.genotypingMode(),
-                                m_readDataReader.getSampleNames().size() )
+                                m_readDataReader.getSampleNames().size() ),
+          m_haplotypeIndexTimer(
+              std::make_shared< utils::Timer >( "HaplotypeIndex", utils::fileMetaData( dataParams.outputDataSink() ) ) )
     {
+        if ( m_commitOutput )
+        {
+            m_vcOut.reset( new io::VCFWriter( m_outputBuffer, dataParams.outputDataSink(),
+                                              dataParams.outputRefCalls(), callingParams.m_outputPhasedGenotypes ) );
+        }
+        else
+        {
+            m_vcOut.reset( new io::VCFWriter( dataParams.outputDataSink(), dataParams.outputRefCalls(),
+                                              callingParams.m_outputPhasedGenotypes ) );
+        }
     }
 
     //-----------------------------------------------------------------------------------------
 
-    void Job::process()
+    void Job::writeHeader()
     {
-        WECALL_LOG( DEBUG, "Writing VCF header" );
+        writeVCFHeader( *m_vcOut, m_applicationParams, m_dataParams, m_privateCallingParams, m_callingParams,
+                        m_readDataReader.getSampleNames(), m_ref.indexFile() );
+    }
 
-        std::vector< vcf::FilterDesc > filterDescs = m_variantSoftFilterBank.getFilterDescs();
-        filterDescs.emplace_back( vcf::filter::NC_key,
-                                  "Not called: Indicates a variant that was not positively genotyped in any sample." );
+    //-----------------------------------------------------------------------------------------
+
+    void Job::commitBufferedOutput()
+    {
+        if ( m_commitOutput )
+        {
+            m_commitOutput( m_outputBuffer.str() );
+            m_outputBuffer.str( "" );
+        }
+
+        if ( m_commitLikelihoodRecords and not m_likelihoodRecords.empty() )
+        {
+            // Clusters of a block may finish in any order on the cluster threads, but the files are merged as sorted
+            // streams. The records of a cluster stay in sample order.
+            std::stable_sort( m_likelihoodRecords.begin(), m_likelihoodRecords.end(),
+                              []( const ClusterLikelihoodRecord & lhs, const ClusterLikelihoodRecord & rhs )
+                              {
+                                  return lhs.region.interval() < rhs.region.interval();
+                              } );
+
+            std::string serialisedRecords;
+            for ( const auto & record : m_likelihoodRecords )
+            {
+                serialisedRecords += serialiseLikelihoodRecord( record );
+            }
+            m_commitLikelihoodRecords( serialisedRecords );
+            m_likelihoodRecords.clear();
+        }
+    }
 
-        m_vcOut.writeHeader( m_dataParams.outputFormat(), m_applicationParams, m_dataParams.refFile(),
-                             m_readDataReader.getSampleNames(), filterDescs,
-                             caller::getContigsFromRegions( m_outputRegions, m_ref.indexFile().contigs() ) );
+    //-----------------------------------------------------------------------------------------
+
+    void Job::process()
+    {
+        if ( m_commitOutput )
+        {
+            m_vcOut->headerWrittenElsewhere();
+        }
+        else
+        {
+            this->writeHeader();
+        }
 
         // Currently defaulting to same ploidy all samples.
         const std::vector< std::size_t > ploidyPerSample( m_readDataReader.getSampleNames().size(),
@@ -118,7 +243,7 @@ namespace caller
         for ( const Region & region : m_callingRegions )
         {
             const auto contig = region.contig();
-            const auto refContigs = m_ref.indexFile().contigs();
+            const auto & refContigs = m_ref.indexFile().contigs();
             const auto contigLookup = refContigs.find( contig );
 
             if ( contigLookup == refContigs.end() )
@@ -135,23 +260,23 @@ namespace caller
 
             const auto callingRegion = contigRegion.getIntersect( region );
 
-            if ( callingRegion.size() == 0 )
+            // Anything past the owned part of a split job is called by the job that took it over.
+            if ( callingRegion.size() == 0 or callingRegion.start() >= this->callingRegionLimit() )
             {
                 continue;
             }
 
-            m_vcOut.contig( contig );
+            m_vcOut->contig( contig );
 
             // Get required reference.
             const auto maxReadLength =
                 1000;  // TODO made sure Read construction doesn't fail it it goes byond this limit
             const auto assemblePadding = 3 * params::defaults::maxBreakpointKmerSize;
             const caller::Region paddedRefRegion = callingRegion.getPadded( maxReadLength + assemblePadding );
-            m_ref.cacheSequence( paddedRefRegion );
-            const auto referenceSequence =
-                std::make_shared< utils::ReferenceSequence >( m_ref.getSequence( paddedRefRegion ) );
+            m_callingReference = std::make_shared< utils::ReferenceSequence >( m_ref.getSequence( paddedRefRegion ) );
 
-            auto blockIterator = m_readDataReader.readRegion( callingRegion, referenceSequence );
+            auto blockIterator = m_readDataReader.readRegion( callingRegion, m_callingReference );
+            blockIterator.truncateRegion( this->callingRegionLimit() );
 
             while ( auto readDataset = blockIterator.getReadDatasetForNextBlock() )
             {
@@ -160,7 +285,10 @@ namespace caller
                 if ( not readDataset->isEmpty() or m_dataParams.outputRefCalls() or
                      m_privateDataParams.genotypingMode() )
                 {
-                    const auto actualEnd = processBlock( readDataset, blockIterator.isLastBlock(), ploidyPerSample );
+                    int64_t callingBytes = 0;
+                    const auto actualEnd =
+                        processBlock( readDataset, blockIterator.isLastBlock(), ploidyPerSample, callingBytes );
+                    blockIterator.addCallingBytes( callingBytes );
 
                     if ( actualEnd < block.end() )
                     {
@@ -171,14 +299,96 @@ namespace caller
                 {
                     WECALL_LOG( INFO, "Skipping " << block << " due to no read data." );
                 }
+
+                this->commitBufferedOutput();
+
+                if ( m_hasIdleWorkers and not blockIterator.isLastBlock() and m_hasIdleWorkers() and
+                     this->splitRemainingWork( contig, blockIterator.nextBlockStart() ) )
+                {
+                    blockIterator.truncateRegion( this->callingRegionLimit() );
+                }
             }
         }
 
+        if ( m_likelihoodCacheHits + m_likelihoodCacheMisses > 0 )
+        {
+            WECALL_LOG( INFO, "Read likelihood cache: " << m_likelihoodCacheHits << " hits, " << m_likelihoodCacheMisses
+                                                         << " misses." );
+        }
         WECALL_LOG( INFO, "Job completed successfully." );
     }
 
     //-----------------------------------------------------------------------------------------
 
+    void Job::setWorkSplitter( std::function< bool() > hasIdleWorkers,
+                               std::function< void( const caller::params::Data & ) > submitWork )
+    {
+        m_hasIdleWorkers = hasIdleWorkers;
+        m_submitWork = submitWork;
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    bool Job::splitRemainingWork( const std::string & contig, int64_t position )
+    {
+        const auto ownedInterval = m_dataParams.shardInterval();
+        const auto remainingStart = std::max( position, ownedInterval.start() );
+        if ( remainingStart >= ownedInterval.end() )
+        {
+            return false;
+        }
+        const utils::Interval remaining( remainingStart, ownedInterval.end() );
+
+        std::vector< utils::Interval > remainingIntervals;
+        int64_t remainingSize = 0;
+        for ( const auto & region : m_outputRegions )
+        {
+            if ( region.contig() == contig and region.interval().overlaps( remaining ) )
+            {
+                remainingIntervals.push_back( region.interval().getIntersect( remaining ) );
+                remainingSize += remainingIntervals.back().size();
+            }
+        }
+
+        if ( remainingSize < 2 * static_cast< int64_t >( params::defaults::minShardSize ) )
+        {
+            return false;
+        }
+
+        int64_t splitPosition = remainingIntervals.front().start();
+        int64_t sizeBeforeSplit = 0;
+        for ( const auto & interval : remainingIntervals )
+        {
+            if ( sizeBeforeSplit + interval.size() >= remainingSize / 2 )
+            {
+                splitPosition = interval.start() + remainingSize / 2 - sizeBeforeSplit;
+                break;
+            }
+            sizeBeforeSplit += interval.size();
+        }
+
+        const auto tail = m_dataParams.splitAt( splitPosition );
+        WECALL_LOG( INFO, "Split off work on " << contig << " from " << splitPosition << " to new job writing to "
+                                                << tail.outputDataSink() );
+        m_submitWork( tail );
+        return true;
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    int64_t Job::callingRegionLimit() const
+    {
+        const auto ownedEnd = m_dataParams.shardInterval().end();
+        const int64_t padding = m_privateCallingParams.m_regionPadding;
+        if ( ownedEnd > std::numeric_limits< int64_t >::max() - padding )
+        {
+            return std::numeric_limits< int64_t >::max();
+        }
+        return ownedEnd + padding;
+    }
+
+    //-----------------------------------------------------------------------------------------
+
     std::vector< variant::VariantCluster > Job::generateVariantClustersInBlock(
         const caller::Region & blockRegion,
         io::perSampleRegionsReads_t allReads,
@@ -251,7 +461,8 @@ namespace caller
 
     int64_t Job::processBlock( io::readDataset_t readDataset,
                                bool lastBlock,
-                               const std::vector< std::size_t > & ploidyPerSample )
+                               const std::vector< std::size_t > & ploidyPerSample,
+                               int64_t & callingBytes )
     {
         auto blockRegion = readDataset->region();
         WECALL_LOG( INFO, "Processing:\t" << blockRegion );
@@ -262,10 +473,12 @@ namespace caller
         const auto maxReadLength = io::perSampleMaxAlignedReadLength( allReads );
         const auto assemblePadding = 3 * params::defaults::maxBreakpointKmerSize;
         const caller::Region paddedRefRegion = blockRegion.getPadded( maxReadLength + assemblePadding );
-        m_ref.cacheSequence( paddedRefRegion );
 
+        // Reads longer than the padding of the calling region need more reference than it holds.
         const auto referenceSequence =
-            std::make_shared< utils::ReferenceSequence >( m_ref.getSequence( paddedRefRegion ) );
+            m_callingReference != nullptr and m_callingReference->region().contains( paddedRefRegion )
+                ? std::make_shared< utils::ReferenceSequence >( m_callingReference->subseq( paddedRefRegion ) )
+                : std::make_shared< utils::ReferenceSequence >( m_ref.getSequence( paddedRefRegion ) );
 
         auto clusters = this->generateVariantClustersInBlock( blockRegion, allReads, referenceSequence );
         if ( not lastBlock )
@@ -275,6 +488,20 @@ namespace caller
 
         WECALL_LOG( INFO, "Calling variants:\t" << blockRegion );
 
+        callingBytes = 0;
+        for ( const auto & cluster : clusters )
+        {
+            for ( const auto & variant : cluster.variants() )
+            {
+                callingBytes += sizeof( variant::Variant ) + variant->nReads() * sizeof( io::readPtr_t );
+            }
+        }
+
+        // Likelihoods of reads given haplotypes are shared between the clusters of the block and phasing between
+        // them. Recalibration changes read qualities between clusters, so cached likelihoods would go stale.
+        ReadLikelihoodCache blockLikelihoodCache;
+        const auto likelihoodCache = m_callingParams.m_recalibrateBaseQs ? nullptr : &blockLikelihoodCache;
+
         if ( clusters.empty() )
         {
             this->callReference( readDataset->region().contig(), blockRegion.start(), blockRegion.end(), readDataset,
@@ -282,22 +509,31 @@ namespace caller
         }
         else
         {
+            // With several cluster threads the clusters are called up front, otherwise each is called as it is reached.
+            const auto concurrentCalls =
+                this->callClustersConcurrently( clusters, readDataset, referenceSequence, ploidyPerSample,
+                                                likelihoodCache );
+            const auto callCluster = [&]( std::size_t clusterIndex )
+            {
+                if ( concurrentCalls.empty() )
+                {
+                    return this->processBigCluster( clusters[clusterIndex], readDataset, referenceSequence,
+                                                    ploidyPerSample, likelihoodCache );
+                }
+                return concurrentCalls[clusterIndex];
+            };
+
             // init with first cluster
-            std::vector< variant::VariantCluster >::iterator clusterIterator = clusters.begin();
-            auto firstCluster = *clusterIterator;
-            auto callsPrevCluster =
-                this->processBigCluster( firstCluster, readDataset, referenceSequence, ploidyPerSample );
-            this->writeCallsForCluster( callsPrevCluster, firstCluster, blockRegion.start(), readDataset,
+            auto callsPrevCluster = callCluster( 0 );
+            this->writeCallsForCluster( callsPrevCluster, clusters.front(), blockRegion.start(), readDataset,
                                         ploidyPerSample );
-            Region regionPrevCluster = firstCluster.region();
+            Region regionPrevCluster = clusters.front().region();
 
-            // iterate over remaining clusters
-            clusterIterator++;
-            for ( ; clusterIterator != clusters.cend(); ++clusterIterator )
+            // iterate over remaining clusters in genomic order, phasing each against the one before
+            for ( std::size_t clusterIndex = 1; clusterIndex < clusters.size(); ++clusterIndex )
             {
-                // call variants in cluster
-                const auto cluster = *clusterIterator;
-                auto calls = this->processBigCluster( cluster, readDataset, referenceSequence, ploidyPerSample );
+                const auto & cluster = clusters[clusterIndex];
+                auto calls = callCluster( clusterIndex );
 
                 callVector_t aligned_calls;
 
@@ -320,7 +556,7 @@ namespace caller
                     // attempt to phase clusters
                     alignPhasingBetweenClusters( calls, callsPrevCluster, cluster.region(), regionPrevCluster,
                                                  combinedRegion, paddedReferenceSequence, ploidyPerSample,
-                                                 combinedRegionReads, readDataset->getSampleNames() );
+                                                 combinedRegionReads, readDataset->getSampleNames(), likelihoodCache );
                     aligned_calls = calls;
                 }
 
@@ -336,11 +572,65 @@ namespace caller
             this->callReference( readDataset->region().contig(), regionPrevCluster.end(), blockRegion.end(),
                                  readDataset, ploidyPerSample );
         }
+
+        WECALL_LOG( DEBUG, "Read likelihood cache for " << blockRegion << ": " << blockLikelihoodCache.hits()
+                                                         << " hits, " << blockLikelihoodCache.misses()
+                                                         << " misses, hit rate " << blockLikelihoodCache.hitRate() );
+        m_likelihoodCacheHits += blockLikelihoodCache.hits();
+        m_likelihoodCacheMisses += blockLikelihoodCache.misses();
+        callingBytes += blockLikelihoodCache.bytesUsed();
         return blockRegion.end();
     }
 
     //-----------------------------------------------------------------------------------------
 
+    std::vector< callVector_t > Job::callClustersConcurrently(
+        const std::vector< variant::VariantCluster > & clusters,
+        io::readDataset_t readDataset,
+        const utils::referenceSequencePtr_t & referenceSequence,
+        const std::vector< std::size_t > & ploidyPerSample,
+        ReadLikelihoodCache * likelihoodCache )
+    {
+        // Recalibration rewrites the reads shared between clusters, and the phasing and reference calls made
+        // between clusters must see them as they were in serial mode, so it rules out calling ahead.
+        if ( m_taskPool == nullptr or m_systemParams.m_clusterThreads <= 1 or clusters.size() <= 1 or
+             m_callingParams.m_recalibrateBaseQs )
+        {
+            return {};
+        }
+
+        // Reads overlapping two clusters are reached from both of their threads, so the sequences of reads that
+        // match the reference are built now rather than on first use.
+        readDataset->buildReadSequences();
+
+        std::vector< callVector_t > clusterCalls( clusters.size() );
+
+        // Start the clusters with the most variants first, as they dominate the time spent on the block.
+        std::vector< std::size_t > clusterOrder( clusters.size() );
+        std::iota( clusterOrder.begin(), clusterOrder.end(), 0 );
+        std::stable_sort( clusterOrder.begin(), clusterOrder.end(), [&clusters]( std::size_t lhs, std::size_t rhs )
+                          {
+                              return clusters[lhs].variants().size() > clusters[rhs].variants().size();
+                          } );
+
+        std::vector< utils::TaskPool::task_t > tasks;
+        for ( const auto clusterIndex : clusterOrder )
+        {
+            tasks.push_back( [this, &clusters, &clusterCalls, &readDataset, &referenceSequence, &ploidyPerSample,
+                              likelihoodCache, clusterIndex]()
+                             {
+                                 clusterCalls[clusterIndex] =
+                                     this->processBigCluster( clusters[clusterIndex], readDataset, referenceSequence,
+                                                              ploidyPerSample, likelihoodCache );
+                             } );
+        }
+        m_taskPool->run( tasks );
+
+        return clusterCalls;
+    }
+
+    //-----------------------------------------------------------------------------------------
+
     void Job::writeCallsForCluster( const callVector_t calls,
                                     const variant::VariantCluster cluster,
                                     const int64_t refStart,
@@ -354,7 +644,7 @@ namespace caller
 
         // write calls (variant + ref calls) for current cluster
         m_variantSoftFilterBank.applyFilterAnnotation( outputCalls );
-        m_vcOut.writeCallSet( m_ref, outputCalls );
+        m_vcOut->writeCallSet( m_ref, outputCalls );
     }
 
     //-----------------------------------------------------------------------------------------
@@ -365,6 +655,10 @@ namespace caller
                              io::readDataset_t readDataset,
                              const std::vector< std::size_t > & ploidyPerSample )
     {
+        // Reference calls are clipped to the owned part of the contig so adjacent shards tile without overlap.
+        start = std::max( start, m_dataParams.shardInterval().start() );
+        end = std::min( end, m_dataParams.shardInterval().end() );
+
         if ( m_dataParams.outputRefCalls() and start < end )
         {
             const caller::Region refInterval( contig, start, end );
@@ -386,7 +680,7 @@ namespace caller
 
             const auto outputCalls = this->filterOutputCalls( contig, calls );
 
-            m_vcOut.writeCallSet( m_ref, outputCalls );
+            m_vcOut->writeCallSet( m_ref, outputCalls );
         }
     }
 
@@ -397,7 +691,7 @@ namespace caller
     {
         const auto errorCorrectionParameters = corrector::ErrorCorrectionParameters();
         corrector::recalibrateReads( readRangesPerSample, m_ref, region, errorCorrectionParameters );
-        m_intermediateOutputWriter.writeReads( readRangesPerSample, region.contig() );
+        m_intermediateOutputWriter->writeReads( readRangesPerSample, region.contig() );
     }
 
     std::vector< varPtr_t > getCandidateVariants( const std::vector< varPtr_t > & variants,
@@ -445,7 +739,8 @@ namespace caller
     callVector_t Job::processBigCluster( const variant::VariantCluster & cluster,
                                          io::readDataset_t readDataset,
                                          const utils::referenceSequencePtr_t & blockReferenceSequence,
-                                         const std::vector< std::size_t > & ploidyPerSample )
+                                         const std::vector< std::size_t > & ploidyPerSample,
+                                         ReadLikelihoodCache * likelihoodCache )
     {
         variant::setDefaultPriors( cluster.variants() );
 
@@ -466,7 +761,8 @@ namespace caller
 
         if ( not hasLargeVariant )
         {
-            return processCluster( cluster, bigClusterReads, allReads, blockReferenceSequence, ploidyPerSample );
+            return processCluster( cluster, bigClusterReads, allReads, blockReferenceSequence, ploidyPerSample,
+                                   likelihoodCache );
         }
         else
         {
@@ -487,7 +783,8 @@ namespace caller
 
             const auto lvcReads = io::reduceRegionSet( bigClusterReads, lvcCluster.readRegions() );
             const auto lvcCalls =
-                processCluster( lvcCluster, lvcReads, allReads, blockReferenceSequence, ploidyPerSample );
+                processCluster( lvcCluster, lvcReads, allReads, blockReferenceSequence, ploidyPerSample,
+                                likelihoodCache );
 
             callVector_t allCalls = lvcCalls;
             for ( const auto & leftOverCluster : smallVariantClustersNotTouchingLargeVariants )
@@ -495,7 +792,8 @@ namespace caller
                 const auto clusterReads = io::reduceRegionSet( bigClusterReads, leftOverCluster.readRegions() );
                 const auto thisAreasPloidy = getReducedPloidies( lvcCalls, ploidyPerSample, leftOverCluster.region() );
                 const auto leftOverCalls =
-                    processCluster( leftOverCluster, clusterReads, allReads, blockReferenceSequence, thisAreasPloidy );
+                    processCluster( leftOverCluster, clusterReads, allReads, blockReferenceSequence, thisAreasPloidy,
+                                    likelihoodCache );
                 allCalls.insert( allCalls.end(), leftOverCalls.begin(), leftOverCalls.end() );
             }
 
@@ -524,7 +822,8 @@ namespace caller
                                       const io::perSampleRegionsReads_t & regionReads,
                                       const io::perSampleRegionsReads_t & allReads,
                                       const utils::referenceSequencePtr_t & blockReferenceSequence,
-                                      const std::vector< std::size_t > & ploidyPerSample )
+                                      const std::vector< std::size_t > & ploidyPerSample,
+                                      ReadLikelihoodCache * likelihoodCache )
     {
         WECALL_LOG( DEBUG, "Processing: " << cluster.toString() );
 
@@ -535,6 +834,8 @@ namespace caller
 
         const auto paddedRefSequence = this->getReferenceForCluster( cluster, regionReads, blockReferenceSequence );
 
+        // Haplotype sequences are indexed once for the cluster, for both haplotype ranking and genotyping.
+        HaplotypeIndex haplotypeIndex( m_haplotypeIndexTimer );
         variant::HaplotypeVector haplotypes( cluster.readRegions(), paddedRefSequence );
 
         if ( cluster.allCombinationsComputed() )
@@ -553,7 +854,7 @@ namespace caller
             const variant::AlignmentHaplotypeGenerator hapGen(
                 cluster.variants(), cluster.readRegions(), regionReads, paddedRefSequence,
                 m_privateCallingParams.m_maxHaplotypesPerCluster,
-                m_privateCallingParams.m_minReadsToMakeCombinationClaim );
+                m_privateCallingParams.m_minReadsToMakeCombinationClaim, likelihoodCache, &haplotypeIndex );
 
             haplotypes = hapGen.generateHaplotypes();
             if ( haplotypes.size() <= 1 )
@@ -584,7 +885,14 @@ namespace caller
             candidateVariants = cluster.variants();
         }
 
-        const auto results = m_model.getResults( regionReads, haplotypes, candidateVariants, ploidyPerSample );
+        const auto results =
+            m_model.getResults( regionReads, haplotypes, candidateVariants, ploidyPerSample, likelihoodCache,
+                                &haplotypeIndex );
+
+        if ( m_commitLikelihoodRecords )
+        {
+            this->addLikelihoodRecords( cluster, haplotypes, candidateVariants, results );
+        }
 
         const auto calls = m_variantCallBuilder.getAnnotatedVariantCalls(
             cluster.region().start(), haplotypes.region(), regionReads, allReads, candidateVariants,
@@ -595,6 +903,65 @@ namespace caller
         return calls;
     }
 
+    void Job::addLikelihoodRecords( const variant::VariantCluster & cluster,
+                                    const variant::HaplotypeVector & haplotypes,
+                                    const std::vector< variant::varPtr_t > & candidateVariants,
+                                    const model::ModelResults & results )
+    {
+        // Clusters in the padding of a shard are written by the job which owns them.
+        const auto clusterRegion = cluster.region();
+        const auto overlapCluster = [&clusterRegion]( const Region & outputRegion )
+        {
+            return outputRegion.overlaps( clusterRegion );
+        };
+        if ( not m_dataParams.shardInterval().contains( clusterRegion.start() ) or
+             std::none_of( m_outputRegions.begin(), m_outputRegions.end(), overlapCluster ) )
+        {
+            return;
+        }
+
+        ClusterLikelihoodRecord record;
+        record.region = clusterRegion;
+        for ( const auto & var : candidateVariants )
+        {
+            record.variants.push_back(
+                {var->start(), var->end(), var->sequence().str(), var->prior(), var->isGenotypingVariant()} );
+        }
+        record.nHaplotypes = haplotypes.size();
+        record.haplotypeFlags = getHaplotypeFlags( variant::HaplotypeMembership( haplotypes, candidateVariants ) );
+
+        std::vector< ClusterLikelihoodRecord > sampleRecords;
+        const auto & samples = m_readDataReader.getSampleNames();
+        for ( std::size_t sampleIndex = 0; sampleIndex < samples.size(); ++sampleIndex )
+        {
+            record.sample = samples[sampleIndex];
+            record.haplotypeFrequencies = results.getHaplotypeFrequencies()[sampleIndex];
+            record.genotypeStatistics = results.getGenotypeStatistics()[sampleIndex];
+
+            record.calledHaplotypes.clear();
+            const auto & calledGenotype = results.getCalledGenotypes()[sampleIndex];
+            if ( calledGenotype != nullptr )
+            {
+                const auto haplotypeIndices = calledGenotype->getHaplotypeIndices();
+                record.calledHaplotypes.assign( haplotypeIndices.cbegin(), haplotypeIndices.cend() );
+            }
+            record.genotypeMetadata = results.getGenotypeMetadata()[sampleIndex];
+
+            record.readSupport.clear();
+            record.genotypeLikelihoods.clear();
+            for ( const auto & variantMetadata : results.getVariantMetadata()[sampleIndex] )
+            {
+                record.readSupport.push_back( variantMetadata.readSupport() );
+                record.genotypeLikelihoods.push_back( variantMetadata.genotypeLikelihoods );
+            }
+
+            sampleRecords.push_back( record );
+        }
+
+        std::lock_guard< std::mutex > lock( m_likelihoodRecordsMutex );
+        std::move( sampleRecords.begin(), sampleRecords.end(), std::back_inserter( m_likelihoodRecords ) );
+    }
+
     callVector_t Job::filterOutputCalls( const std::string & contig, const callVector_t & calls ) const
     {
         callVector_t outputCalls;
@@ -607,7 +974,8 @@ namespace caller
             };
 
             // TODO: Replace with better handling than linear scan.
-            if ( std::any_of( m_outputRegions.begin(), m_outputRegions.end(), overlapCall ) )
+            if ( m_dataParams.shardInterval().contains( call.interval.start() ) and
+                 std::any_of( m_outputRegions.begin(), m_outputRegions.end(), overlapCall ) )
             {
                 outputCalls.push_back( call );
             }
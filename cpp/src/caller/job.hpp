@@ -7,23 +7,53 @@
 #include "caller/region.hpp"
 #include "caller/params.hpp"
 #include "caller/candidateVariantBank.hpp"
+#include "caller/haplotypeIndex.hpp"
+#include "caller/inputContext.hpp"
+#include "caller/likelihoodRecords.hpp"
+#include "caller/readLikelihoodCache.hpp"
 #include "io/readDataReader.hpp"
 #include "io/readRange.hpp"
 #include "io/fastaFile.hpp"
 #include "io/vcfWriter.hpp"
 #include "io/tabixVCFFile.hpp"
 #include "readrecalibration/intermediateOutputWriter.hpp"
+#include "utils/taskPool.hpp"
 #include "variant/clustering.hpp"
 #include "variant/type/variant.hpp"
 #include "varfilters/variantSoftFilterBank.hpp"
 
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
 namespace wecall
 {
 namespace caller
 {
+    /// Write the VCF header of the output of a run, which is the same for every job of it.
+    void writeVCFHeader( io::VCFWriter & vcOut,
+                         const caller::params::Application & applicationParams,
+                         const caller::params::Data & dataParams,
+                         const caller::params::PrivateCalling & privateCallingParams,
+                         const caller::params::Calling & callingParams,
+                         const std::vector< std::string > & sampleNames,
+                         const io::FastaIndex & refIndex );
+
+    /// Write a VCF header for the given contigs, for output that does not come from the data regions of a run.
+    void writeVCFHeader( io::VCFWriter & vcOut,
+                         const caller::params::Application & applicationParams,
+                         const std::string & outputFormat,
+                         const std::string & refFile,
+                         const caller::params::PrivateCalling & privateCallingParams,
+                         const caller::params::Calling & callingParams,
+                         const std::vector< std::string > & sampleNames,
+                         const std::vector< Region > & contigs );
+
     class Job
     {
     public:
+        /// @param inputContext Inputs shared with the other jobs of the run. A job without one opens its own.
         Job( caller::params::Application applicationParams,
              caller::params::Data dataParams,
              caller::params::System systemParams,
@@ -31,29 +61,73 @@ namespace caller
              caller::params::Filters filterParams,
              caller::params::PrivateCalling privateCallingParams,
              caller::params::Calling callingParams,
-             caller::params::PrivateData privateDataParams );
+             caller::params::PrivateData privateDataParams,
+             std::function< void( const std::string & ) > commitOutput = nullptr,
+             inputContextPtr_t inputContext = nullptr );
 
+        /// Call the data regions of this job. The VCF header is written first unless the output is committed
+        /// elsewhere, in which case the owner of the final output writes a header for all jobs.
         void process();
 
+        /// Allow the job to hand the rest of its work to other workers. At each block boundary hasIdleWorkers is
+        /// asked whether another worker is waiting; if so the remaining owned regions are halved and the second
+        /// half is passed to submitWork as a new job.
+        void setWorkSplitter( std::function< bool() > hasIdleWorkers,
+                              std::function< void( const caller::params::Data & ) > submitWork );
+
+        /// Pass the serialised per-sample likelihood records of the owned clusters of each block to
+        /// commitLikelihoodRecords, in the order of the clusters.
+        void setLikelihoodRecordCommitter( std::function< void( const std::string & ) > commitLikelihoodRecords )
+        {
+            m_commitLikelihoodRecords = commitLikelihoodRecords;
+        }
+
+        /// Keep the memory of the blocks of reads within budget, which may be shared between jobs.
+        void setMemoryBudget( utils::memoryBudgetPtr_t budget ) { m_readDataReader.setMemoryBudget( budget ); }
+
     private:
+        void writeHeader();
+
+        /// Split off the second half of the owned regions on contig from position onwards, if both halves are
+        /// worth a job of their own.
+        ///
+        /// @return True if work was split off.
+        bool splitRemainingWork( const std::string & contig, int64_t position );
+
+        /// End of the region that needs calling to cover the owned part of the data regions.
+        int64_t callingRegionLimit() const;
+
         /// Second tier of processing - job is split into manageable blocks
         /// within process() and each is processed in turn. Within a block, reads
         /// are filtered and candidate variants generated from them. These are then
-        /// split into clusters from which variants are called.
+        /// split into clusters from which variants are called. The memory held by the candidate variants and cached
+        /// likelihoods of the block is returned in callingBytes.
         int64_t processBlock( io::readDataset_t readDataset,
                               bool lastBlock,
-                              const std::vector< std::size_t > & ploidyPerSample );
+                              const std::vector< std::size_t > & ploidyPerSample,
+                              int64_t & callingBytes );
+
+        /// Call the variants in all clusters of a block on the cluster threads, returning the calls in cluster
+        /// order. Returns nothing if the clusters must be called one at a time.
+        std::vector< callVector_t > callClustersConcurrently(
+            const std::vector< variant::VariantCluster > & clusters,
+            io::readDataset_t readDataset,
+            const utils::referenceSequencePtr_t & referenceSequence,
+            const std::vector< std::size_t > & ploidyPerSample,
+            ReadLikelihoodCache * likelihoodCache );
 
         callVector_t processBigCluster( const variant::VariantCluster & cluster,
                                         io::readDataset_t readDataset,
                                         const utils::referenceSequencePtr_t & referenceSequence,
-                                        const std::vector< std::size_t > & ploidyPerSample );
+                                        const std::vector< std::size_t > & ploidyPerSample,
+                                        ReadLikelihoodCache * likelihoodCache );
 
         callVector_t processCluster( const variant::VariantCluster & cluster,
                                      const io::perSampleRegionsReads_t & regionReads,
                                      const io::perSampleRegionsReads_t & allReads,
                                      const utils::referenceSequencePtr_t & blockReferenceSequence,
-                                     const std::vector< std::size_t > & ploidyPerSample );
+                                     const std::vector< std::size_t > & ploidyPerSample,
+                                     ReadLikelihoodCache * likelihoodCache );
 
         utils::referenceSequencePtr_t getReferenceForCluster(
             const variant::VariantCluster & cluster,
@@ -82,8 +156,18 @@ namespace caller
 
         callVector_t filterOutputCalls( const std::string & contig, const callVector_t & calls ) const;
 
+        /// Keep the per-sample likelihood records of an owned cluster until the end of the block.
+        void addLikelihoodRecords( const variant::VariantCluster & cluster,
+                                   const variant::HaplotypeVector & haplotypes,
+                                   const std::vector< variant::varPtr_t > & candidateVariants,
+                                   const model::ModelResults & results );
+
+        /// Pass the output written since the last commit to commitOutput, if output is committed elsewhere, and
+        /// the likelihood records of the block, sorted by cluster, to commitLikelihoodRecords.
+        void commitBufferedOutput();
+
         const caller::params::Application m_applicationParams;
-        const caller::params::Data m_dataParams;
+        caller::params::Data m_dataParams;
         const caller::params::System m_systemParams;
         const caller::params::PrivateSystem m_privateSystemParams;
         const caller::params::Filters m_filterParams;
@@ -91,21 +175,47 @@ namespace caller
         const caller::params::Calling m_callingParams;
         const caller::params::PrivateData m_privateDataParams;
 
+        const inputContextPtr_t m_inputs;
+
         std::shared_ptr< io::TabixVCFFile > m_candidateVCFFile;
         std::shared_ptr< io::TabixVCFFile > m_genotypeAllelesVCFFile;
 
-        corrector::IntermediateOutputWriter m_intermediateOutputWriter;
+        std::shared_ptr< corrector::IntermediateOutputWriter > m_intermediateOutputWriter;
 
         varfilters::VariantSoftFilterBank m_variantSoftFilterBank;
         io::ReadDataReader m_readDataReader;
-        io::VCFWriter m_vcOut;
+        std::function< void( const std::string & ) > m_commitOutput;
+        std::ostringstream m_outputBuffer;
+        std::unique_ptr< io::VCFWriter > m_vcOut;
         io::FastaFile m_ref;
 
         const regions_t m_outputRegions;
         const regions_t m_callingRegions;
 
+        // Threads the clusters of each block, and the samples of each cluster, are called on, if there is more than
+        // one.
+        const std::unique_ptr< utils::TaskPool > m_taskPool;
+
         const model::Model m_model;
+
         const model::VCFCallVectorBuilder m_variantCallBuilder;
+
+        // Time spent indexing haplotype sequences, over all clusters of the job.
+        const utils::timerPtr_t m_haplotypeIndexTimer;
+
+        std::function< bool() > m_hasIdleWorkers;
+        std::function< void( const caller::params::Data & ) > m_submitWork;
+
+        std::function< void( const std::string & ) > m_commitLikelihoodRecords;
+        std::mutex m_likelihoodRecordsMutex;
+        std::vector< ClusterLikelihoodRecord > m_likelihoodRecords;
+
+        // Reference of the calling region being processed, which the references of its blocks are views onto.
+        utils::referenceSequencePtr_t m_callingReference;
+
+        // Read likelihood cache lookups over all blocks of the job.
+        std::size_t m_likelihoodCacheHits = 0;
+        std::size_t m_likelihoodCacheMisses = 0;
     };
 }
 }
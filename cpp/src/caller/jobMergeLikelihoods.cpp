@@ -0,0 +1,503 @@
+// All content Copyright (C) 2018 Genomics plc
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "caller/jobMergeLikelihoods.hpp"
+#include "caller/job.hpp"
+#include "caller/regionUtils.hpp"
+#include "caller/diploid/diploidAnnotate.hpp"
+#include "caller/diploid/variantQualityCalculator.hpp"
+#include "io/vcfWriter.hpp"
+#include "utils/logging.hpp"
+#include "vcf/field.hpp"
+
+namespace wecall
+{
+namespace caller
+{
+    namespace
+    {
+        const std::size_t noRecord = std::numeric_limits< std::size_t >::max();
+
+        bool covers( const ClusterLikelihoodRecord & record, const LikelihoodRecordVariant & variant )
+        {
+            return record.region.start() <= variant.start and variant.end <= record.region.end();
+        }
+
+        bool overlaps( const LikelihoodRecordVariant & lhs, const LikelihoodRecordVariant & rhs )
+        {
+            return lhs.start == rhs.start or std::max( lhs.start, rhs.start ) < std::min( lhs.end, rhs.end );
+        }
+
+        /// Whether a haplotype of a record carries a candidate of the record which overlaps variant, in which case
+        /// it is not reference at variant although variant is not one of its candidates.
+        bool carriesOverlappingVariant( const ClusterLikelihoodRecord & record,
+                                        const std::size_t haplotypeIndex,
+                                        const LikelihoodRecordVariant & variant )
+        {
+            for ( std::size_t variantIndex = 0; variantIndex < record.variants.size(); ++variantIndex )
+            {
+                if ( overlaps( record.variants[variantIndex], variant ) and
+                     ( record.flags( variantIndex, haplotypeIndex ) & ClusterLikelihoodRecord::containsVariantFlag ) )
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        Call::Type callType( const uint8_t flags )
+        {
+            if ( flags & ClusterLikelihoodRecord::containsVariantFlag )
+            {
+                return Call::VAR;
+            }
+            else if ( flags & ClusterLikelihoodRecord::isReferenceFlag )
+            {
+                return Call::REF;
+            }
+            else
+            {
+                return Call::UNKNOWN;
+            }
+        }
+    }
+
+    callVector_t mergeCluster( const std::vector< ClusterLikelihoodRecord > & records,
+                               const std::vector< std::string > & samples,
+                               const std::vector< std::size_t > & ploidyPerSample,
+                               const utils::referenceSequencePtr_t & reference,
+                               const bool outputPhasedGenotypes,
+                               const bool outputAllVariants,
+                               const bool genotypingMode )
+    {
+        WECALL_ASSERT( not records.empty(), "Cannot merge a cluster without records" );
+        const auto nSamples = samples.size();
+        const auto & contig = records.front().region.contig();
+        const auto phaseSetID = records.front().region.start();
+
+        std::map< std::string, std::size_t > sampleIndices;
+        for ( std::size_t sampleIndex = 0; sampleIndex < nSamples; ++sampleIndex )
+        {
+            sampleIndices.emplace( samples[sampleIndex], sampleIndex );
+        }
+
+        std::vector< std::size_t > recordSampleIndices;
+        for ( const auto & record : records )
+        {
+            const auto sampleIt = sampleIndices.find( record.sample );
+            WECALL_ASSERT( sampleIt != sampleIndices.end(), "Likelihood record of unknown sample " + record.sample );
+            recordSampleIndices.push_back( sampleIt->second );
+        }
+
+        // The candidate variants of all records, and where each record has them.
+        std::map< LikelihoodRecordVariant, std::size_t > variantIndices;
+        std::vector< LikelihoodRecordVariant > variants;
+        for ( const auto & record : records )
+        {
+            for ( const auto & variant : record.variants )
+            {
+                const auto inserted = variantIndices.emplace( variant, variants.size() );
+                if ( inserted.second )
+                {
+                    variants.push_back( variant );
+                }
+                else if ( variant.isGenotypingVariant )
+                {
+                    variants[inserted.first->second].isGenotypingVariant = true;
+                }
+            }
+        }
+
+        std::vector< std::vector< std::size_t > > recordVariantIndices(
+            records.size(), std::vector< std::size_t >( variants.size(), noRecord ) );
+        for ( std::size_t recordIndex = 0; recordIndex < records.size(); ++recordIndex )
+        {
+            const auto & record = records[recordIndex];
+            for ( std::size_t variantIndex = 0; variantIndex < record.variants.size(); ++variantIndex )
+            {
+                recordVariantIndices[recordIndex][variantIndices.at( record.variants[variantIndex] )] = variantIndex;
+            }
+        }
+
+        std::vector< variant::varPtr_t > varPtrs;
+        for ( const auto & variant : variants )
+        {
+            const auto var = std::make_shared< variant::Variant >(
+                reference, Region( contig, variant.start, variant.end ), utils::BasePairSequence( variant.added ) );
+            var->prior( variant.prior );
+            if ( variant.isGenotypingVariant )
+            {
+                var->setGenotypingVariant();
+            }
+            varPtrs.push_back( var );
+        }
+
+        // Each sample's call of a variant comes from its first record with the variant as a candidate, or else its
+        // first record covering the variant. Variants whose calls come from the same records are scored together.
+        std::map< std::vector< std::size_t >, std::vector< std::size_t > > variantsPerRecordChoice;
+        for ( std::size_t variantIndex = 0; variantIndex < variants.size(); ++variantIndex )
+        {
+            std::vector< std::size_t > recordChoice( nSamples, noRecord );
+            for ( std::size_t recordIndex = 0; recordIndex < records.size(); ++recordIndex )
+            {
+                auto & chosenRecord = recordChoice[recordSampleIndices[recordIndex]];
+                const bool hasCandidate = recordVariantIndices[recordIndex][variantIndex] != noRecord;
+                const bool chosenHasCandidate =
+                    chosenRecord != noRecord and recordVariantIndices[chosenRecord][variantIndex] != noRecord;
+
+                if ( ( hasCandidate and not chosenHasCandidate ) or
+                     ( chosenRecord == noRecord and covers( records[recordIndex], variants[variantIndex] ) ) )
+                {
+                    chosenRecord = recordIndex;
+                }
+            }
+            variantsPerRecordChoice[recordChoice].push_back( variantIndex );
+        }
+
+        callVector_t calls;
+        for ( const auto & choiceVariants : variantsPerRecordChoice )
+        {
+            const auto & recordChoice = choiceVariants.first;
+            const auto & scoredVariants = choiceVariants.second;
+            const auto nScored = scoredVariants.size();
+
+            // Haplotypes of different samples are the same haplotype if they agree on the scored variants.
+            std::map< std::vector< uint8_t >, std::size_t > haplotypeIndices;
+            std::vector< std::vector< uint8_t > > haplotypeFlags;
+            std::vector< std::vector< std::size_t > > mergedIndicesPerSample( nSamples );
+            for ( std::size_t sampleIndex = 0; sampleIndex < nSamples; ++sampleIndex )
+            {
+                const auto recordIndex = recordChoice[sampleIndex];
+                if ( recordIndex == noRecord )
+                {
+                    continue;
+                }
+
+                const auto & record = records[recordIndex];
+                for ( std::size_t haplotypeIndex = 0; haplotypeIndex < record.nHaplotypes; ++haplotypeIndex )
+                {
+                    std::vector< uint8_t > flags( nScored, 0 );
+                    for ( std::size_t scoredIndex = 0; scoredIndex < nScored; ++scoredIndex )
+                    {
+                        const auto variantIndex = scoredVariants[scoredIndex];
+                        const auto recordVariantIndex = recordVariantIndices[recordIndex][variantIndex];
+                        if ( recordVariantIndex != noRecord )
+                        {
+                            flags[scoredIndex] = record.flags( recordVariantIndex, haplotypeIndex );
+                        }
+                        else if ( covers( record, variants[variantIndex] ) and
+                                  not carriesOverlappingVariant( record, haplotypeIndex, variants[variantIndex] ) )
+                        {
+                            flags[scoredIndex] = ClusterLikelihoodRecord::isReferenceFlag;
+                        }
+                    }
+
+                    const auto inserted = haplotypeIndices.emplace( flags, haplotypeFlags.size() );
+                    if ( inserted.second )
+                    {
+                        haplotypeFlags.push_back( flags );
+                    }
+                    mergedIndicesPerSample[sampleIndex].push_back( inserted.first->second );
+                }
+            }
+
+            const auto nHaplotypes = haplotypeFlags.size();
+            variant::HaplotypeMembership membership( nScored, nHaplotypes );
+            for ( std::size_t haplotypeIndex = 0; haplotypeIndex < nHaplotypes; ++haplotypeIndex )
+            {
+                for ( std::size_t scoredIndex = 0; scoredIndex < nScored; ++scoredIndex )
+                {
+                    const auto flags = haplotypeFlags[haplotypeIndex][scoredIndex];
+                    if ( flags & ClusterLikelihoodRecord::containsVariantFlag )
+                    {
+                        membership.setContainsVariant( scoredIndex, haplotypeIndex );
+                    }
+                    if ( flags & ClusterLikelihoodRecord::isReferenceFlag )
+                    {
+                        membership.setIsReference( scoredIndex, haplotypeIndex );
+                    }
+                }
+            }
+
+            // Combine the samples in sample order, as Model::getResults does.
+            std::vector< double > totalHaplotypeFrequencies( nHaplotypes, 0.0 );
+            std::vector< model::SampleGenotypeStatistics > genotypeStatisticsPerSample( nSamples );
+            std::vector< std::vector< std::size_t > > calledHaplotypesPerSample( nSamples );
+            for ( std::size_t sampleIndex = 0; sampleIndex < nSamples; ++sampleIndex )
+            {
+                auto & statistics = genotypeStatisticsPerSample[sampleIndex];
+                const auto recordIndex = recordChoice[sampleIndex];
+                if ( recordIndex == noRecord )
+                {
+                    statistics.ploidy = ploidyPerSample[sampleIndex];
+                    continue;
+                }
+
+                const auto & record = records[recordIndex];
+                const auto & mergedIndices = mergedIndicesPerSample[sampleIndex];
+                for ( std::size_t haplotypeIndex = 0; haplotypeIndex < record.nHaplotypes; ++haplotypeIndex )
+                {
+                    totalHaplotypeFrequencies[mergedIndices[haplotypeIndex]] +=
+                        record.haplotypeFrequencies[haplotypeIndex];
+                }
+
+                statistics = record.genotypeStatistics;
+                for ( auto & haplotypeIndex : statistics.haplotypesUsed )
+                {
+                    haplotypeIndex = mergedIndices[haplotypeIndex];
+                }
+                for ( const auto haplotypeIndex : record.calledHaplotypes )
+                {
+                    calledHaplotypesPerSample[sampleIndex].push_back( mergedIndices[haplotypeIndex] );
+                }
+            }
+
+            const double haplotypeFrequencySum =
+                std::accumulate( totalHaplotypeFrequencies.cbegin(), totalHaplotypeFrequencies.cend(), 0.0 );
+            if ( haplotypeFrequencySum > 0.0 )
+            {
+                for ( auto && frequency : totalHaplotypeFrequencies )
+                {
+                    frequency /= haplotypeFrequencySum;
+                }
+            }
+
+            std::vector< double > variantPriors;
+            for ( const auto variantIndex : scoredVariants )
+            {
+                variantPriors.push_back( varPtrs[variantIndex]->prior() );
+            }
+
+            const auto variantQualities = model::VariantQualityCalculator( totalHaplotypeFrequencies,
+                                                                           genotypeStatisticsPerSample, variantPriors,
+                                                                           membership ).getQualities();
+
+            for ( std::size_t scoredIndex = 0; scoredIndex < nScored; ++scoredIndex )
+            {
+                const auto variantIndex = scoredVariants[scoredIndex];
+                const auto & var = varPtrs[variantIndex];
+
+                genoCalls_t genoCalls( nSamples );
+                std::vector< std::vector< model::VariantMetadata > > variantAnnotationPerSample( nSamples );
+                std::vector< GenotypeMetadata > genotypeMetadataPerSample( nSamples, GenotypeMetadata() );
+                for ( std::size_t sampleIndex = 0; sampleIndex < nSamples; ++sampleIndex )
+                {
+                    const auto recordIndex = recordChoice[sampleIndex];
+                    const auto & calledHaplotypes = calledHaplotypesPerSample[sampleIndex];
+                    if ( calledHaplotypes.empty() )
+                    {
+                        genoCalls[sampleIndex] = genoCall_t( ploidyPerSample[sampleIndex], Call::UNKNOWN );
+                    }
+                    for ( const auto haplotypeIndex : calledHaplotypes )
+                    {
+                        genoCalls[sampleIndex].push_back( callType( haplotypeFlags[haplotypeIndex][scoredIndex] ) );
+                    }
+
+                    const auto recordVariantIndex =
+                        recordIndex == noRecord ? noRecord : recordVariantIndices[recordIndex][variantIndex];
+                    if ( recordVariantIndex != noRecord )
+                    {
+                        const auto & record = records[recordIndex];
+                        variantAnnotationPerSample[sampleIndex].emplace_back( record.readSupport[recordVariantIndex] );
+                        variantAnnotationPerSample[sampleIndex].back().genotypeLikelihoods =
+                            record.genotypeLikelihoods[recordVariantIndex];
+                    }
+                    else
+                    {
+                        // No reads of the sample were scored against the variant.
+                        variantAnnotationPerSample[sampleIndex].emplace_back( model::VariantMetadata::ReadSupport() );
+                        variantAnnotationPerSample[sampleIndex].back().genotypeLikelihoods = {
+                            constants::unknownValue};
+                    }
+
+                    if ( recordIndex != noRecord )
+                    {
+                        genotypeMetadataPerSample[sampleIndex] = records[recordIndex].genotypeMetadata;
+                    }
+                }
+
+                const auto variantQuality = variantQualities[scoredIndex];
+                const auto variantCalled =
+                    caller::variantCalled( genoCalls ) and variantQuality >= constants::minAllowedQualityScore;
+                const bool outputVariant = genotypingMode ? var->isGenotypingVariant() : variantCalled;
+                if ( not outputAllVariants and not outputVariant )
+                {
+                    continue;
+                }
+
+                Call call( var, utils::Interval( var->zeroIndexedVcfPosition(), var->end() ), variantQuality, nSamples,
+                           genoCalls );
+                annotate::annotate( call, 0, variantAnnotationPerSample, genotypeMetadataPerSample,
+                                    outputPhasedGenotypes, phaseSetID );
+                if ( not variantCalled )
+                {
+                    call.filters.insert( vcf::filter::NC_key );
+                }
+                calls.push_back( call );
+            }
+        }
+
+        std::stable_sort( calls.begin(), calls.end(), CallComp() );
+        return calls;
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    JobMergeLikelihoods::JobMergeLikelihoods( const caller::params::MergeLikelihoods & mergeParams,
+                                              const caller::params::Application & applicationParams,
+                                              const caller::params::PrivateCalling & privateCallingParams,
+                                              const caller::params::Calling & callingParams )
+        : m_mergeParams( mergeParams ),
+          m_applicationParams( applicationParams ),
+          m_privateCallingParams( privateCallingParams ),
+          m_callingParams( callingParams ),
+          m_ref( mergeParams.refFile() ),
+          m_variantSoftFilterBank( privateCallingParams.m_varFilterIDs,
+                                   callingParams.m_minAlleleBiasP,
+                                   callingParams.m_minStrandBiasP,
+                                   callingParams.m_minAllelePlusStrandBiasP,
+                                   callingParams.m_minRMSMappingQ,
+                                   callingParams.m_minSNPQOverDepth,
+                                   callingParams.m_minIndelQOverDepth,
+                                   callingParams.m_minBadReadsScore,
+                                   callingParams.m_minCallQual ),
+          m_genotypingMode( false ),
+          m_timer( std::make_shared< utils::Timer >( "IO", utils::fileMetaData( mergeParams.outputDataSink() ) ) )
+    {
+        // Samples are output in the order they are first seen in the inputs.
+        std::map< std::string, std::size_t > sampleIndices;
+        for ( const auto & input : m_mergeParams.inputs() )
+        {
+            m_readers.emplace_back( new LikelihoodRecordReader( input ) );
+            const auto & header = m_readers.back()->header();
+
+            WECALL_ERROR( m_readers.size() == 1 or header.genotypingMode == m_genotypingMode,
+                          "Cannot merge " + input + " with likelihood files written in another genotyping mode" );
+            m_genotypingMode = header.genotypingMode;
+
+            for ( const auto & sampleName : header.sampleNames )
+            {
+                const auto inserted = sampleIndices.emplace( sampleName, m_samples.size() );
+                if ( inserted.second )
+                {
+                    m_samples.push_back( sampleName );
+                    m_ploidyPerSample.push_back( header.ploidy );
+                }
+                else
+                {
+                    WECALL_ERROR( m_ploidyPerSample[inserted.first->second] == header.ploidy,
+                                  "Sample " + sampleName + " has different ploidy in " + input );
+                }
+            }
+        }
+
+        m_nextRecords.resize( m_readers.size() );
+        m_inputFinished.assign( m_readers.size(), false );
+        for ( std::size_t inputIndex = 0; inputIndex < m_readers.size(); ++inputIndex )
+        {
+            this->readNext( inputIndex );
+        }
+    }
+
+    void JobMergeLikelihoods::readNext( const std::size_t inputIndex )
+    {
+        ClusterLikelihoodRecord record;
+        if ( not m_readers[inputIndex]->read( record ) )
+        {
+            m_inputFinished[inputIndex] = true;
+            return;
+        }
+
+        const auto & filename = m_readers[inputIndex]->filename();
+        const auto & refIndex = m_ref.indexFile();
+        WECALL_ERROR( refIndex.contigs().count( record.region.contig() ) == 1,
+                      "Contig " + record.region.contig() + " of " + filename + " is not in " + m_mergeParams.refFile() );
+
+        // The first record of an input has nothing before it.
+        const auto & previousRegion = m_nextRecords[inputIndex].region;
+        WECALL_ERROR( previousRegion.contig().empty() or not RegionComp( refIndex )( record.region, previousRegion ),
+                      filename + " is not in genome order: " + record.region.toString() + " follows " +
+                          previousRegion.toString() );
+
+        m_nextRecords[inputIndex] = std::move( record );
+    }
+
+    std::size_t JobMergeLikelihoods::nextInput() const
+    {
+        RegionComp regionComp( m_ref.indexFile() );
+        auto nextIndex = m_readers.size();
+        for ( std::size_t inputIndex = 0; inputIndex < m_readers.size(); ++inputIndex )
+        {
+            if ( not m_inputFinished[inputIndex] and
+                 ( nextIndex == m_readers.size() or
+                   regionComp( m_nextRecords[inputIndex].region, m_nextRecords[nextIndex].region ) ) )
+            {
+                nextIndex = inputIndex;
+            }
+        }
+        return nextIndex;
+    }
+
+    void JobMergeLikelihoods::process()
+    {
+        utils::ScopedTimerTrigger scopedTimerTrigger( m_timer );
+        io::VCFWriter vcOut( m_mergeParams.outputDataSink(), false, m_callingParams.m_outputPhasedGenotypes );
+
+        std::vector< Region > contigs;
+        for ( const auto & contig : m_ref.indexFile().contigs() )
+        {
+            contigs.emplace_back( contig.first, contig.second );
+        }
+        std::sort( contigs.begin(), contigs.end(), RegionComp( m_ref.indexFile() ) );
+        writeVCFHeader( vcOut, m_applicationParams, constants::vcf42, m_mergeParams.refFile(),
+                        m_privateCallingParams, m_callingParams, m_samples, contigs );
+
+        std::size_t nGroups = 0;
+        std::vector< ClusterLikelihoodRecord > group;
+        int64_t groupEnd = 0;
+        const auto mergeGroup = [&]()
+        {
+            const auto & contig = group.front().region.contig();
+            const auto groupStart = group.front().region.start();
+
+            // Indels are written with the base before them.
+            const auto reference = std::make_shared< utils::ReferenceSequence >(
+                m_ref.getSequence( Region( contig, std::max( groupStart - 1, int64_t( 0 ) ), groupEnd + 1 ) ) );
+            auto calls = mergeCluster( group, m_samples, m_ploidyPerSample, reference,
+                                       m_callingParams.m_outputPhasedGenotypes, m_privateCallingParams.m_allVariants,
+                                       m_genotypingMode );
+
+            m_variantSoftFilterBank.applyFilterAnnotation( calls );
+            vcOut.contig( contig );
+            vcOut.writeCallSet( m_ref, calls );
+
+            ++nGroups;
+            group.clear();
+        };
+
+        // Records are taken in genome order across the inputs, and grouped while their regions overlap.
+        for ( auto inputIndex = this->nextInput(); inputIndex < m_readers.size(); inputIndex = this->nextInput() )
+        {
+            const auto & record = m_nextRecords[inputIndex];
+            if ( not group.empty() and ( record.region.contig() != group.front().region.contig() or
+                                         record.region.start() >= groupEnd ) )
+            {
+                mergeGroup();
+            }
+
+            groupEnd = group.empty() ? record.region.end() : std::max( groupEnd, record.region.end() );
+            group.push_back( record );
+            this->readNext( inputIndex );
+        }
+
+        if ( not group.empty() )
+        {
+            mergeGroup();
+        }
+
+        WECALL_LOG( INFO, "Merged " << nGroups << " groups of clusters of " << m_samples.size() << " samples" );
+    }
+}
+}
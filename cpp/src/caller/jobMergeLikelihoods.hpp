@@ -0,0 +1,85 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef JOB_MERGE_LIKELIHOODS_HPP
+#define JOB_MERGE_LIKELIHOODS_HPP
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "caller/callSet.hpp"
+#include "caller/likelihoodRecords.hpp"
+#include "caller/params.hpp"
+#include "io/fastaFile.hpp"
+#include "utils/referenceSequence.hpp"
+#include "utils/timer.hpp"
+#include "varfilters/variantSoftFilterBank.hpp"
+
+namespace wecall
+{
+namespace caller
+{
+    /// Joint calls of the likelihood records of one group of overlapping clusters, as if the samples had been called
+    /// together.
+    ///
+    /// Each variant is scored over the record of each sample that has it as a candidate, or else the record of the
+    /// sample that covers it, at which the sample is reference unless one of its candidates overlaps the variant. A
+    /// sample without a record covering a variant has no reads there. Haplotypes of different samples are the same
+    /// haplotype if they agree on the variants scored together, and their frequencies are summed over samples.
+    ///
+    /// @param records The records of the group, ordered by region.
+    /// @param samples The samples of the output, which include the samples of the records.
+    /// @param ploidyPerSample The ploidy each sample was called with.
+    /// @param reference The reference sequence of the group.
+    callVector_t mergeCluster( const std::vector< ClusterLikelihoodRecord > & records,
+                               const std::vector< std::string > & samples,
+                               const std::vector< std::size_t > & ploidyPerSample,
+                               const utils::referenceSequencePtr_t & reference,
+                               const bool outputPhasedGenotypes,
+                               const bool outputAllVariants,
+                               const bool genotypingMode );
+
+    /// Joint calls from likelihood files written by separate runs of weCall, without reading any BAM file.
+    ///
+    /// The files are in genome order, so they are merged as sorted streams: only the records of the group of
+    /// overlapping clusters being merged are held in memory. Runs need not share their clusters or candidate
+    /// variants, although calls are closest to a joint run if they do, e.g. through --genotypeAllelesFile.
+    class JobMergeLikelihoods
+    {
+    public:
+        JobMergeLikelihoods( const caller::params::MergeLikelihoods & mergeParams,
+                             const caller::params::Application & applicationParams,
+                             const caller::params::PrivateCalling & privateCallingParams,
+                             const caller::params::Calling & callingParams );
+
+        void process();
+
+    private:
+        /// Read the next record of an input, checking that the input is in genome order.
+        void readNext( const std::size_t inputIndex );
+
+        /// The input whose next record comes first in genome order, or the number of inputs if all are done.
+        std::size_t nextInput() const;
+
+    private:
+        const caller::params::MergeLikelihoods m_mergeParams;
+        const caller::params::Application m_applicationParams;
+        const caller::params::PrivateCalling m_privateCallingParams;
+        const caller::params::Calling m_callingParams;
+
+        io::FastaFile m_ref;
+        varfilters::VariantSoftFilterBank m_variantSoftFilterBank;
+
+        std::vector< std::unique_ptr< LikelihoodRecordReader > > m_readers;
+        std::vector< ClusterLikelihoodRecord > m_nextRecords;
+        std::vector< bool > m_inputFinished;
+
+        std::vector< std::string > m_samples;
+        std::vector< std::size_t > m_ploidyPerSample;
+        bool m_genotypingMode;
+
+        utils::timerPtr_t m_timer;
+    };
+}
+}
+
+#endif
@@ -0,0 +1,150 @@
+// All content Copyright (C) 2018 Genomics plc
+#include "caller/jobOutputQueue.hpp"
+#include "utils/exceptions.hpp"
+#include "utils/logging.hpp"
+
+#include <boost/filesystem.hpp>
+
+namespace wecall
+{
+namespace caller
+{
+    JobOutputQueue::JobOutputQueue( const std::string & outputFilename,
+                                    const std::string & workDir,
+                                    std::size_t maxHeldBytes )
+        : m_out( outputFilename, std::ios_base::out | std::ios_base::binary ),
+          m_workDir( workDir ),
+          m_maxHeldBytes( maxHeldBytes ),
+          m_timer( std::make_shared< utils::Timer >( "IO", utils::fileMetaData( outputFilename ) ) )
+    {
+        WECALL_ERROR( m_out.is_open(), "Could not open " + outputFilename + " for writing" );
+    }
+
+    JobOutputQueue::~JobOutputQueue()
+    {
+        // Spilled output is only left over if a job failed.
+        for ( auto & queuedJob : m_queuedJobs )
+        {
+            if ( queuedJob.second.m_spillFile != nullptr )
+            {
+                queuedJob.second.m_spillFile.reset();
+                boost::system::error_code ignored;
+                boost::filesystem::remove( queuedJob.second.m_spillFilename, ignored );
+            }
+        }
+    }
+
+    void JobOutputQueue::writeHeader( const std::string & header )
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        utils::ScopedTimerTrigger scopedTimerTrigger( m_timer );
+        m_out << header;
+    }
+
+    void JobOutputQueue::addJob( const std::string & jobName )
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        const auto inserted = m_queuedJobs.emplace( jobName, QueuedJob() ).second;
+        WECALL_ASSERT( inserted, "Job " + jobName + " already queued" );
+    }
+
+    void JobOutputQueue::commit( const std::string & jobName, const std::string & output )
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        const auto jobIt = m_queuedJobs.find( jobName );
+        WECALL_ASSERT( jobIt != m_queuedJobs.end() and not jobIt->second.m_finished,
+                        "Job " + jobName + " is not running" );
+
+        if ( jobIt == m_queuedJobs.begin() )
+        {
+            utils::ScopedTimerTrigger scopedTimerTrigger( m_timer );
+            m_out << output;
+            m_out.flush();
+        }
+        else if ( jobIt->second.m_spillFile != nullptr )
+        {
+            *jobIt->second.m_spillFile << output;
+        }
+        else
+        {
+            jobIt->second.m_heldOutput += output;
+            m_heldBytes += output.size();
+            if ( m_heldBytes > m_maxHeldBytes and not jobIt->second.m_heldOutput.empty() )
+            {
+                this->spill( jobName, jobIt->second );
+            }
+        }
+    }
+
+    void JobOutputQueue::spill( const std::string & jobName, QueuedJob & job )
+    {
+        utils::ScopedTimerTrigger scopedTimerTrigger( m_timer );
+        boost::filesystem::create_directories( m_workDir );
+        job.m_spillFilename =
+            ( boost::filesystem::path( m_workDir ) / boost::filesystem::unique_path( "%%%%-%%%%-" + jobName ) )
+                .string();
+        job.m_spillFile.reset(
+            new std::ofstream( job.m_spillFilename, std::ios_base::out | std::ios_base::binary ) );
+        WECALL_ERROR( job.m_spillFile->is_open(), "Could not open " + job.m_spillFilename + " for writing" );
+
+        WECALL_LOG( DEBUG, "Spilling output of job " << jobName << " to " << job.m_spillFilename );
+        *job.m_spillFile << job.m_heldOutput;
+        m_heldBytes -= job.m_heldOutput.size();
+        job.m_heldOutput.clear();
+        job.m_heldOutput.shrink_to_fit();
+    }
+
+    void JobOutputQueue::finishJob( const std::string & jobName )
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        const auto jobIt = m_queuedJobs.find( jobName );
+        WECALL_ASSERT( jobIt != m_queuedJobs.end(), "Job " + jobName + " is not queued" );
+
+        jobIt->second.m_finished = true;
+        this->writeFinishedJobs();
+    }
+
+    void JobOutputQueue::writeFinishedJobs()
+    {
+        utils::ScopedTimerTrigger scopedTimerTrigger( m_timer );
+        while ( not m_queuedJobs.empty() )
+        {
+            auto & firstJob = m_queuedJobs.begin()->second;
+            if ( firstJob.m_spillFile != nullptr )
+            {
+                firstJob.m_spillFile->close();
+                WECALL_ERROR( firstJob.m_spillFile->good(), "Could not write " + firstJob.m_spillFilename );
+                firstJob.m_spillFile.reset();
+
+                std::ifstream spilledOutput( firstJob.m_spillFilename, std::ios_base::in | std::ios_base::binary );
+                WECALL_ERROR( spilledOutput.is_open(), "Could not open " + firstJob.m_spillFilename );
+                m_out << spilledOutput.rdbuf();
+                spilledOutput.close();
+                boost::filesystem::remove( firstJob.m_spillFilename );
+            }
+
+            m_out << firstJob.m_heldOutput;
+            m_heldBytes -= firstJob.m_heldOutput.size();
+            firstJob.m_heldOutput.clear();
+            firstJob.m_heldOutput.shrink_to_fit();
+
+            if ( not firstJob.m_finished )
+            {
+                // Output of the new first job is written as it comes from now on.
+                break;
+            }
+
+            WECALL_LOG( DEBUG, "Wrote output of job " << m_queuedJobs.begin()->first );
+            m_queuedJobs.erase( m_queuedJobs.begin() );
+        }
+        m_out.flush();
+    }
+
+    void JobOutputQueue::close()
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        WECALL_ASSERT( m_queuedJobs.empty(), "Job " + m_queuedJobs.begin()->first + " did not finish" );
+        m_out.close();
+    }
+}
+}
@@ -0,0 +1,74 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef JOB_OUTPUT_QUEUE_HPP
+#define JOB_OUTPUT_QUEUE_HPP
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "utils/timer.hpp"
+
+namespace wecall
+{
+namespace caller
+{
+    /// Writes the output of jobs running in parallel to a single file in genome order, while the jobs run.
+    /// Jobs are known by the name of their output data sink, and names sort in genome order. Output of the first
+    /// unfinished job is written as soon as it is committed; output of later jobs is held until every job before
+    /// them has finished. Held output is kept in memory up to a limit, beyond which the job committing output
+    /// spills all of its output to a file in the working directory.
+    class JobOutputQueue
+    {
+    public:
+        /// @param workDir Directory for spilled output, created when first needed.
+        /// @param maxHeldBytes Most output of all jobs to hold in memory.
+        JobOutputQueue( const std::string & outputFilename, const std::string & workDir, std::size_t maxHeldBytes );
+        ~JobOutputQueue();
+
+        JobOutputQueue( const JobOutputQueue & rhs ) = delete;
+        JobOutputQueue & operator=( const JobOutputQueue & ) = delete;
+
+        /// Write output that precedes the output of every job, i.e. the VCF header.
+        void writeHeader( const std::string & header );
+
+        /// Add a job to the queue. A job must be added before any job sorting before it finishes.
+        void addJob( const std::string & jobName );
+
+        /// Append output of a job that has not finished yet.
+        void commit( const std::string & jobName, const std::string & output );
+
+        /// Mark a job as finished and write out any jobs that were waiting for it.
+        void finishJob( const std::string & jobName );
+
+        /// Check that every job has finished and close the output file.
+        void close();
+
+    private:
+        struct QueuedJob
+        {
+            std::string m_heldOutput;
+            std::string m_spillFilename;
+            std::unique_ptr< std::ofstream > m_spillFile;
+            bool m_finished = false;
+        };
+
+        /// Move the held output of job, and any it commits from now on, to a file in the working directory.
+        void spill( const std::string & jobName, QueuedJob & job );
+
+        void writeFinishedJobs();
+
+    private:
+        std::mutex m_mutex;
+        std::map< std::string, QueuedJob > m_queuedJobs;
+        std::ofstream m_out;
+        const std::string m_workDir;
+        const std::size_t m_maxHeldBytes;
+        std::size_t m_heldBytes = 0;
+        utils::timerPtr_t m_timer;
+    };
+}
+}
+
+#endif
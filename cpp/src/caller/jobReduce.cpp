@@ -2,6 +2,7 @@
 #include <iterator>
 #include <algorithm>
 #include <fstream>
+#include <set>
 
 #include <boost/filesystem.hpp>
 
@@ -59,6 +60,7 @@ namespace caller
     {
         bool commonContentWritten = false;
         std::string chromLine;
+        std::set< std::string > contigLinesWritten;
 
         for ( const auto & file : m_inputVCFFilePaths )
         {
@@ -73,11 +75,16 @@ namespace caller
                     break;
                 }
 
-                if ( not commonContentWritten )
+                // Shards cut from the same contig all declare it, so each contig line is written once.
+                const bool isContigLine =
+                    temp.substr( 0, vcf::Header::contigKey().size() ) == vcf::Header::contigKey();
+                if ( isContigLine and not contigLinesWritten.insert( temp ).second )
                 {
-                    out << temp << "\n";
+                    temp.clear();
+                    continue;
                 }
-                else if ( temp.substr( 0, vcf::Header::contigKey().size() ) == vcf::Header::contigKey() )
+
+                if ( not commonContentWritten or isContigLine )
                 {
                     out << temp << "\n";
                 }
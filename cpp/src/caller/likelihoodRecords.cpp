@@ -0,0 +1,275 @@
+// All content Copyright (C) 2018 Genomics plc
+#include <algorithm>
+#include <sstream>
+
+#include "caller/likelihoodRecords.hpp"
+#include "utils/logging.hpp"
+
+namespace wecall
+{
+namespace caller
+{
+    namespace
+    {
+        const std::string fileMagic = "WCLIKE03";
+
+        // Values are written in the byte order of the machine: the files are intermediate output, read back by
+        // weCall on the same platform.
+        template < typename T >
+        void writeValue( std::ostream & out, const T value )
+        {
+            out.write( reinterpret_cast< const char * >( &value ), sizeof( T ) );
+        }
+
+        template < typename T >
+        void writeVector( std::ostream & out, const std::vector< T > & values )
+        {
+            writeValue< uint64_t >( out, values.size() );
+            out.write( reinterpret_cast< const char * >( values.data() ),
+                       static_cast< std::streamsize >( values.size() * sizeof( T ) ) );
+        }
+
+        void writeString( std::ostream & out, const std::string & value )
+        {
+            writeValue< uint64_t >( out, value.size() );
+            out.write( value.data(), static_cast< std::streamsize >( value.size() ) );
+        }
+
+        template < typename T >
+        T readValue( std::istream & in )
+        {
+            T value;
+            in.read( reinterpret_cast< char * >( &value ), sizeof( T ) );
+            return value;
+        }
+
+        /// Reads the length of a vector or string of elements of elementSize bytes, and checks that the file holds
+        /// that many bytes after it, so that a corrupt length fails cleanly instead of allocating unbounded memory.
+        std::size_t readLength( std::istream & in,
+                                const std::size_t elementSize,
+                                const std::streamoff fileSize,
+                                const std::string & filename )
+        {
+            const auto length = readValue< uint64_t >( in );
+            WECALL_ERROR( in.good(), "Truncated likelihood record in " + filename );
+
+            const auto bytesLeft = static_cast< uint64_t >( fileSize - in.tellg() );
+            WECALL_ERROR( length <= bytesLeft / elementSize, "Corrupt likelihood record in " + filename + ": length " +
+                                                                 std::to_string( length ) + " exceeds the " +
+                                                                 std::to_string( bytesLeft ) + " bytes left" );
+            return static_cast< std::size_t >( length );
+        }
+
+        template < typename T >
+        std::vector< T > readVector( std::istream & in, const std::streamoff fileSize, const std::string & filename )
+        {
+            std::vector< T > values( readLength( in, sizeof( T ), fileSize, filename ) );
+            in.read( reinterpret_cast< char * >( values.data() ),
+                     static_cast< std::streamsize >( values.size() * sizeof( T ) ) );
+            return values;
+        }
+
+        std::string readString( std::istream & in, const std::streamoff fileSize, const std::string & filename )
+        {
+            std::string value( readLength( in, 1, fileSize, filename ), '\0' );
+            in.read( &value[0], static_cast< std::streamsize >( value.size() ) );
+            return value;
+        }
+
+        std::vector< uint64_t > toWords( const std::vector< std::size_t > & values )
+        {
+            return std::vector< uint64_t >( values.cbegin(), values.cend() );
+        }
+
+        std::vector< std::size_t > fromWords( const std::vector< uint64_t > & values )
+        {
+            return std::vector< std::size_t >( values.cbegin(), values.cend() );
+        }
+    }
+
+    constexpr uint8_t ClusterLikelihoodRecord::containsVariantFlag;
+    constexpr uint8_t ClusterLikelihoodRecord::isReferenceFlag;
+
+    std::vector< uint8_t > getHaplotypeFlags( const variant::HaplotypeMembership & membership )
+    {
+        std::vector< uint8_t > flags( membership.nVariants() * membership.nHaplotypes(), 0 );
+        for ( std::size_t variantIndex = 0; variantIndex < membership.nVariants(); ++variantIndex )
+        {
+            for ( std::size_t haplotypeIndex = 0; haplotypeIndex < membership.nHaplotypes(); ++haplotypeIndex )
+            {
+                auto & flag = flags[variantIndex * membership.nHaplotypes() + haplotypeIndex];
+                if ( membership.containsVariant( variantIndex, haplotypeIndex ) )
+                {
+                    flag |= ClusterLikelihoodRecord::containsVariantFlag;
+                }
+                if ( membership.isReference( variantIndex, haplotypeIndex ) )
+                {
+                    flag |= ClusterLikelihoodRecord::isReferenceFlag;
+                }
+            }
+        }
+        return flags;
+    }
+
+    std::string serialiseLikelihoodFileHeader( const LikelihoodFileHeader & header )
+    {
+        std::ostringstream out;
+        out.write( fileMagic.data(), static_cast< std::streamsize >( fileMagic.size() ) );
+
+        writeValue< uint64_t >( out, header.sampleNames.size() );
+        for ( const auto & sampleName : header.sampleNames )
+        {
+            writeString( out, sampleName );
+        }
+        writeValue< uint64_t >( out, header.ploidy );
+        writeValue< uint8_t >( out, header.genotypingMode ? 1 : 0 );
+        return out.str();
+    }
+
+    std::string serialiseLikelihoodRecord( const ClusterLikelihoodRecord & record )
+    {
+        std::ostringstream out;
+        writeString( out, record.sample );
+        writeString( out, record.region.contig() );
+        writeValue< int64_t >( out, record.region.start() );
+        writeValue< int64_t >( out, record.region.end() );
+
+        writeValue< uint64_t >( out, record.variants.size() );
+        for ( const auto & variant : record.variants )
+        {
+            writeValue< int64_t >( out, variant.start );
+            writeValue< int64_t >( out, variant.end );
+            writeString( out, variant.added );
+            writeValue< double >( out, variant.prior );
+            writeValue< uint8_t >( out, variant.isGenotypingVariant ? 1 : 0 );
+        }
+
+        writeValue< uint64_t >( out, record.nHaplotypes );
+        writeVector( out, record.haplotypeFlags );
+        writeVector( out, record.haplotypeFrequencies );
+
+        const auto & statistics = record.genotypeStatistics;
+        writeValue< uint8_t >( out, statistics.hasReads ? 1 : 0 );
+        writeValue< uint64_t >( out, statistics.ploidy );
+        writeVector( out, toWords( statistics.haplotypesUsed ) );
+        writeVector( out, statistics.weightedLikelihoods );
+
+        writeVector( out, toWords( record.calledHaplotypes ) );
+        writeValue< phred_t >( out, record.genotypeMetadata.phaseQuality );
+        writeValue< phred_t >( out, record.genotypeMetadata.genotypeQuality );
+
+        WECALL_ASSERT( record.readSupport.size() == record.variants.size() and
+                           record.genotypeLikelihoods.size() == record.variants.size(),
+                       "Likelihood record needs the read support and PL values of each variant" );
+        for ( std::size_t variantIndex = 0; variantIndex < record.variants.size(); ++variantIndex )
+        {
+            const auto & readSupport = record.readSupport[variantIndex];
+            writeValue< double >( out, readSupport.forwardSupportingVariant );
+            writeValue< double >( out, readSupport.reverseSupportingVariant );
+            writeValue< double >( out, readSupport.forwardNotSupportingVariant );
+            writeValue< double >( out, readSupport.reverseNotSupportingVariant );
+            writeValue< double >( out, readSupport.forwardSupportingReference );
+            writeValue< double >( out, readSupport.reverseSupportingReference );
+            writeVector( out, readSupport.minBaseQualitiesPerRead );
+            writeVector( out, readSupport.mappingQuals );
+            writeVector( out, record.genotypeLikelihoods[variantIndex] );
+        }
+
+        return out.str();
+    }
+
+    LikelihoodRecordReader::LikelihoodRecordReader( const std::string & filename )
+        : m_filename( filename ), m_in( filename, std::ios_base::in | std::ios_base::binary )
+    {
+        WECALL_ERROR( m_in.is_open(), "Could not open likelihood record file " + filename );
+
+        m_in.seekg( 0, std::ios_base::end );
+        m_fileSize = m_in.tellg();
+        m_in.seekg( 0, std::ios_base::beg );
+
+        std::string magic( fileMagic.size(), '\0' );
+        m_in.read( &magic[0], static_cast< std::streamsize >( magic.size() ) );
+        WECALL_ERROR( m_in.good() and magic == fileMagic, filename + " is not a likelihood record file" );
+
+        // A sample name takes at least its length.
+        m_header.sampleNames.resize( readLength( m_in, sizeof( uint64_t ), m_fileSize, m_filename ) );
+        for ( auto & sampleName : m_header.sampleNames )
+        {
+            sampleName = readString( m_in, m_fileSize, m_filename );
+        }
+        m_header.ploidy = readValue< uint64_t >( m_in );
+        m_header.genotypingMode = readValue< uint8_t >( m_in ) != 0;
+        WECALL_ERROR( m_in.good(), "Truncated likelihood file header in " + filename );
+    }
+
+    bool LikelihoodRecordReader::read( ClusterLikelihoodRecord & record )
+    {
+        if ( m_in.peek() == std::char_traits< char >::eof() )
+        {
+            return false;
+        }
+
+        record.sample = readString( m_in, m_fileSize, m_filename );
+        const auto contig = readString( m_in, m_fileSize, m_filename );
+        const auto start = readValue< int64_t >( m_in );
+        const auto end = readValue< int64_t >( m_in );
+        record.region = caller::Region( contig, start, end );
+
+        // A variant takes at least its positions, the length of its bases and its prior.
+        record.variants.resize( readLength( m_in, 4 * sizeof( uint64_t ), m_fileSize, m_filename ) );
+        for ( auto & variant : record.variants )
+        {
+            variant.start = readValue< int64_t >( m_in );
+            variant.end = readValue< int64_t >( m_in );
+            variant.added = readString( m_in, m_fileSize, m_filename );
+            variant.prior = readValue< double >( m_in );
+            variant.isGenotypingVariant = readValue< uint8_t >( m_in ) != 0;
+        }
+
+        record.nHaplotypes = readValue< uint64_t >( m_in );
+        record.haplotypeFlags = readVector< uint8_t >( m_in, m_fileSize, m_filename );
+        record.haplotypeFrequencies = readVector< double >( m_in, m_fileSize, m_filename );
+
+        auto & statistics = record.genotypeStatistics;
+        statistics.hasReads = readValue< uint8_t >( m_in ) != 0;
+        statistics.ploidy = readValue< uint64_t >( m_in );
+        statistics.haplotypesUsed = fromWords( readVector< uint64_t >( m_in, m_fileSize, m_filename ) );
+        statistics.weightedLikelihoods = readVector< double >( m_in, m_fileSize, m_filename );
+
+        record.calledHaplotypes = fromWords( readVector< uint64_t >( m_in, m_fileSize, m_filename ) );
+        record.genotypeMetadata.phaseQuality = readValue< phred_t >( m_in );
+        record.genotypeMetadata.genotypeQuality = readValue< phred_t >( m_in );
+
+        record.readSupport.resize( record.variants.size() );
+        record.genotypeLikelihoods.resize( record.variants.size() );
+        for ( std::size_t variantIndex = 0; variantIndex < record.variants.size(); ++variantIndex )
+        {
+            auto & readSupport = record.readSupport[variantIndex];
+            readSupport.forwardSupportingVariant = readValue< double >( m_in );
+            readSupport.reverseSupportingVariant = readValue< double >( m_in );
+            readSupport.forwardNotSupportingVariant = readValue< double >( m_in );
+            readSupport.reverseNotSupportingVariant = readValue< double >( m_in );
+            readSupport.forwardSupportingReference = readValue< double >( m_in );
+            readSupport.reverseSupportingReference = readValue< double >( m_in );
+            readSupport.minBaseQualitiesPerRead = readVector< phred_t >( m_in, m_fileSize, m_filename );
+            readSupport.mappingQuals = readVector< int64_t >( m_in, m_fileSize, m_filename );
+            record.genotypeLikelihoods[variantIndex] = readVector< phred_t >( m_in, m_fileSize, m_filename );
+        }
+
+        WECALL_ERROR( m_in.good(), "Truncated likelihood record in " + m_filename );
+
+        const auto isHaplotype = [&record]( const std::size_t haplotypeIndex )
+        {
+            return haplotypeIndex < record.nHaplotypes;
+        };
+        WECALL_ERROR( record.haplotypeFlags.size() == record.variants.size() * record.nHaplotypes and
+                          record.haplotypeFrequencies.size() == record.nHaplotypes and
+                          std::all_of( statistics.haplotypesUsed.cbegin(), statistics.haplotypesUsed.cend(),
+                                       isHaplotype ) and
+                          std::all_of( record.calledHaplotypes.cbegin(), record.calledHaplotypes.cend(),
+                                       isHaplotype ),
+                      "Inconsistent likelihood record in " + m_filename );
+        return true;
+    }
+}
+}
@@ -0,0 +1,115 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef LIKELIHOOD_RECORDS_HPP
+#define LIKELIHOOD_RECORDS_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "caller/metadata.hpp"
+#include "caller/region.hpp"
+#include "caller/diploid/readSupportAccountant.hpp"
+#include "caller/diploid/variantQualityCalculator.hpp"
+#include "variant/haplotypeMembership.hpp"
+
+namespace wecall
+{
+namespace caller
+{
+    /// A candidate variant of a cluster: the bases between start and end of the contig of the cluster are replaced
+    /// by added.
+    struct LikelihoodRecordVariant
+    {
+        int64_t start;
+        int64_t end;
+        std::string added;
+        double prior;
+        bool isGenotypingVariant;
+
+        bool operator==( const LikelihoodRecordVariant & other ) const
+        {
+            return start == other.start and end == other.end and added == other.added;
+        }
+        bool operator<( const LikelihoodRecordVariant & other ) const
+        {
+            return std::tie( start, end, added ) < std::tie( other.start, other.end, other.added );
+        }
+    };
+
+    /// Everything joint variant quality, genotype calls and annotation need from one sample at one cluster, so that
+    /// samples called separately can be combined later without their reads.
+    struct ClusterLikelihoodRecord
+    {
+        static constexpr uint8_t containsVariantFlag = 1;
+        static constexpr uint8_t isReferenceFlag = 2;
+
+        ClusterLikelihoodRecord() : region( "", 0, 0 ), nHaplotypes( 0 ) {}
+
+        std::string sample;
+        caller::Region region;
+        std::vector< LikelihoodRecordVariant > variants;
+
+        /// Whether each haplotype contains, or is reference at, each variant: nVariants x nHaplotypes flags.
+        std::size_t nHaplotypes;
+        std::vector< uint8_t > haplotypeFlags;
+
+        std::vector< double > haplotypeFrequencies;
+        model::SampleGenotypeStatistics genotypeStatistics;
+
+        /// Haplotype indices of the called genotype, empty if the sample has no call.
+        std::vector< std::size_t > calledHaplotypes;
+        GenotypeMetadata genotypeMetadata;
+
+        /// The reads supporting each variant and its PL values.
+        std::vector< model::VariantMetadata::ReadSupport > readSupport;
+        std::vector< std::vector< phred_t > > genotypeLikelihoods;
+
+        uint8_t flags( const std::size_t variantIndex, const std::size_t haplotypeIndex ) const
+        {
+            return haplotypeFlags[variantIndex * nHaplotypes + haplotypeIndex];
+        }
+    };
+
+    /// What a likelihood file says about the run that wrote it.
+    struct LikelihoodFileHeader
+    {
+        std::vector< std::string > sampleNames;
+        std::size_t ploidy = 0;
+        bool genotypingMode = false;
+    };
+
+    /// Record the haplotype flags of a cluster from its membership.
+    std::vector< uint8_t > getHaplotypeFlags( const variant::HaplotypeMembership & membership );
+
+    /// The start of a likelihood file. The records of a run follow it, in the order of the regions of the run.
+    std::string serialiseLikelihoodFileHeader( const LikelihoodFileHeader & header );
+
+    std::string serialiseLikelihoodRecord( const ClusterLikelihoodRecord & record );
+
+    /// Reads the records of a likelihood file one at a time.
+    class LikelihoodRecordReader
+    {
+    public:
+        explicit LikelihoodRecordReader( const std::string & filename );
+
+        LikelihoodRecordReader( const LikelihoodRecordReader & ) = delete;
+        LikelihoodRecordReader & operator=( const LikelihoodRecordReader & ) = delete;
+
+        const LikelihoodFileHeader & header() const { return m_header; }
+        const std::string & filename() const { return m_filename; }
+
+        /// Read the next record into record, or return false at the end of the file.
+        bool read( ClusterLikelihoodRecord & record );
+
+    private:
+        const std::string m_filename;
+        std::ifstream m_in;
+        std::streamoff m_fileSize;
+        LikelihoodFileHeader m_header;
+    };
+}
+}
+
+#endif
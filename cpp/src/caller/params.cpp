@@ -106,13 +106,17 @@ namespace caller
             WECALL_ERROR( boost::filesystem::is_directory( reduceParams.inputDir() ),
                            "Working dir: " + reduceParams.inputDir() + " is not a directory" );
         }
-        void validateReduceParamsPreMap( const Reduce & reduceParams )
+
+        options_description MergeLikelihoods::getOptionsDescription()
         {
-            if ( boost::filesystem::exists( reduceParams.inputDir() ) )
-            {
-                WECALL_ERROR( boost::filesystem::is_empty( reduceParams.inputDir() ),
-                               "Working dir: " + reduceParams.inputDir() + " is not empty" );
-            }
+            options_description options( "Merge Likelihoods Parameters", PARAM_HELP_DISPLAY_WIDTH );
+
+            options.add_options()( "inputs", value< std::string >()->required(),
+                                   "comma separated list of likelihood files written with --likelihoodsOutput" )(
+                "output", value< std::string >()->required(), "output VCF data file name" )(
+                "refFile", value< std::string >()->required(),
+                "reference the likelihood files were called against (FASTA format)" );
+            return options;
         }
 
         Data::Data( const variables_map & optValues, bool overwrite )
@@ -121,6 +125,7 @@ namespace caller
               m_outputFormat( getParam< std::string >( "outputFormat", optValues ) ),
               m_workDir( getParam< std::string >( "workDir", optValues ) ),
               m_refFile( getParam< std::string >( "refFile", optValues ) ),
+              m_shardInterval( unboundedShardInterval() ),
               m_outputRefCalls( getParam< bool >( "outputRefCalls", optValues ) ),
               m_maxRefCallSize( getParam< std::size_t >( "maxRefCallSize", optValues ) )
         {
@@ -176,7 +181,7 @@ namespace caller
                 ("regions", value<std::string>()->default_value(defaults::regions), "regions to process -- comma separated list of bed files or of chroms or chrom:start-end's.")
                 ("output", value<std::string>()->default_value(defaults::output), "output file name")
                 ("outputFormat", value<std::string>()->default_value(defaults::outputFormat), std::string("output file format (" + displayOptions(allowableOutputFormats) + ")").c_str())
-                ("workDir", value<std::string>()->default_value(defaults::workDirDefault), "intermediate files directory (for parallel runs only)")
+                ("workDir", value<std::string>()->default_value(defaults::workDirDefault), "intermediate files directory, for output of parallel jobs waiting for earlier jobs to finish")
                 ("outputRefCalls", value<bool>()->default_value(defaults::outputRefCalls)->implicit_value(true), "if specified, output reference as well as variant calls")
                 ("maxRefCallSize", value<std::size_t>()->default_value(defaults::maxRefCallSize), "maximum size of individual reference calls")
                 ;
@@ -187,42 +192,47 @@ namespace caller
 
         namespace
         {
-            void validateAndCreateWorkingDir( const std::string & dir )
+            void validateWorkingDir( const std::string & dir )
             {
                 if ( boost::filesystem::exists( dir ) )
                 {
                     WECALL_ERROR( boost::filesystem::is_directory( dir ),
                                    "Working dir: " + dir + " is not a directory" );
                 }
-                else
-                {
-                    bool success = boost::filesystem::create_directory( dir );
-                    WECALL_ERROR( success, "Could not create work directory: " + dir );
-                }
             }
         }
 
-        std::vector< Data > Data::splitWorkload() const
+        std::vector< Data > Data::splitWorkload( const std::size_t numberOfJobs, const std::size_t shardSize ) const
         {
             std::vector< Data > vecData;
 
-            validateAndCreateWorkingDir( m_workDir );
+            validateWorkingDir( m_workDir );
+
+            std::size_t actualShardSize = shardSize;
+            if ( actualShardSize == 0 )
+            {
+                const std::size_t numberOfShards = std::max( numberOfJobs, std::size_t( 1 ) ) * defaults::shardsPerJob;
+                const auto totalLength = static_cast< std::size_t >( this->totalRegionLength() );
+                actualShardSize =
+                    std::max( ( totalLength + numberOfShards - 1 ) / numberOfShards, defaults::minShardSize );
+            }
 
-            boost::format intermediateFileNameFormat( "%05d.vcf" );
-            WECALL_ERROR( ( m_dataRegions.size() < 99999 ),
+            const auto shards = shardPartitionedRegions( m_dataRegions, actualShardSize );
+            WECALL_LOG( INFO, "Split workload into " << shards.size() << " shards of at most " << actualShardSize
+                                                     << " bases" );
+
+            boost::format jobNameFormat( "%05d.vcf" );
+            WECALL_ERROR( ( shards.size() < 99999 ),
                            constants::weCallString + " called with too many regions. Max=99999" );
 
-            for ( std::size_t i = 0; i < m_dataRegions.size(); ++i )
+            for ( std::size_t i = 0; i < shards.size(); ++i )
             {
-                boost::filesystem::path outputDataSink = boost::filesystem::path( m_workDir );
-                outputDataSink /= ( intermediateFileNameFormat % i ).str();
-                WECALL_LOG( DEBUG, outputDataSink.string() );
-
-                WECALL_ERROR( ( not boost::filesystem::exists( outputDataSink ) ),
-                               "output data sink " + outputDataSink.string() + " already exist" );
+                const auto outputDataSink = ( jobNameFormat % i ).str();
+                WECALL_LOG( DEBUG, outputDataSink );
 
-                vecData.push_back( Data( m_inputDataSources, outputDataSink.string(), m_outputFormat, m_workDir,
-                                         m_refFile, {m_dataRegions[i]}, m_outputRefCalls, m_maxRefCallSize ) );
+                vecData.push_back( Data( m_inputDataSources, outputDataSink, m_outputFormat, m_workDir,
+                                         m_refFile, {shards[i].regions}, shards[i].ownedInterval, m_outputRefCalls,
+                                         m_maxRefCallSize ) );
             }
 
             std::sort( vecData.begin(), vecData.end(), []( const Data & first, const Data & second )
@@ -233,6 +243,55 @@ namespace caller
             return vecData;
         }
 
+        Data Data::splitAt( const int64_t position )
+        {
+            WECALL_ASSERT( m_shardInterval.contains( position ) and m_shardInterval.start() < position,
+                            "Can only split data inside its shard" );
+
+            partitionedRegions_t headRegions;
+            partitionedRegions_t tailRegions;
+            for ( const auto & regions : m_dataRegions )
+            {
+                regions_t head;
+                regions_t tail;
+                for ( const auto & region : regions )
+                {
+                    if ( region.start() < position )
+                    {
+                        head.emplace_back( region.contig(), region.start(), std::min( region.end(), position ) );
+                    }
+                    if ( region.end() > position )
+                    {
+                        tail.emplace_back( region.contig(), std::max( region.start(), position ), region.end() );
+                    }
+                }
+
+                if ( not head.empty() )
+                {
+                    headRegions.push_back( head );
+                }
+                if ( not tail.empty() )
+                {
+                    tailRegions.push_back( tail );
+                }
+            }
+
+            // Names of split-off output extend the parent's name with the split position, so sorting the names
+            // keeps genome order.
+            const boost::filesystem::path sinkPath( m_outputDataSink );
+            const auto tailDataSink =
+                ( boost::format( "%s_%012d.vcf" ) % sinkPath.stem().string() % position ).str();
+
+            const Data tail( m_inputDataSources, tailDataSink, m_outputFormat, m_workDir, m_refFile,
+                             tailRegions, utils::Interval( position, m_shardInterval.end() ), m_outputRefCalls,
+                             m_maxRefCallSize );
+
+            m_dataRegions = headRegions;
+            m_shardInterval = utils::Interval( m_shardInterval.start(), position );
+
+            return tail;
+        }
+
         int64_t Data::totalRegionLength() const
         {
             int64_t totalLength = 0;
@@ -287,6 +346,7 @@ namespace caller
                 ("overwrite", value<bool>()->default_value(defaults::overwrite), "allow overwrite of output vcf")
                 ("biteSize", value <std::size_t>()->default_value(defaults::biteSize), "size of read data buffer increment (in bases)")
                     ("memLimit", value <std::size_t>()->default_value(defaults::memLimitDefault))
+                ("prefetchReads", value<bool>()->default_value(defaults::prefetchReads), "read the next block of reads on a background thread while the current block is called")
                 ;
 
             return options;
@@ -303,9 +363,30 @@ namespace caller
                 std::to_string(defaults::numberOfJobsMin) + "-" + std::to_string(defaults::numberOfJobsMax) +
                 " inclusive.";
 
+            const std::string cluster_threads_message = "number of threads each job uses to call the variant clusters in a block. Cluster and sample threads of a job share one pool of the larger of the two sizes, capped at the cores available to each job. Must be within the range " +
+                std::to_string(defaults::clusterThreadsMin) + "-" + std::to_string(defaults::clusterThreadsMax) +
+                " inclusive.";
+
+            const std::string sample_threads_message = "number of threads each job uses to compute the likelihoods of the samples of a cluster, shared with the cluster threads. Must be within the range " +
+                std::to_string(defaults::sampleThreadsMin) + "-" + std::to_string(defaults::sampleThreadsMax) +
+                " inclusive.";
+
+            const std::string decompression_threads_message = "number of threads decompressing the BAM files ahead of the jobs reading them, shared by all files and jobs and capped at the number of cores. 0 decompresses reads on the thread reading them. Must be within the range " +
+                std::to_string(defaults::decompressionThreadsMin) + "-" + std::to_string(defaults::decompressionThreadsMax) +
+                " inclusive.";
+
+            const std::string memory_budget_message = "memory in MB that all jobs together may use for reads, e.g. the memory available to the container. Jobs wait or call smaller blocks when it is in use. 0 leaves each job to its own limit. Must be within the range " +
+                std::to_string(defaults::memoryBudgetMin) + "-" + std::to_string(defaults::memoryBudgetMax) +
+                " inclusive.";
+
             options.add_options()
                 ("maxBlockSize", value <std::size_t>()->default_value(defaults::maxBlockSize), block_message.c_str())
                 ("numberOfJobs", value <std::size_t>()->default_value(defaults::numberOfJobsDefault), jobs_message.c_str())
+                ("shardSize", value <std::size_t>()->default_value(defaults::shardSizeDefault), "maximum number of bases of region per parallel job -- contigs are cut into shards of this size. 0 balances the regions over the jobs.")
+                ("clusterThreads", value <std::size_t>()->default_value(defaults::clusterThreadsDefault), cluster_threads_message.c_str())
+                ("sampleThreads", value <std::size_t>()->default_value(defaults::sampleThreadsDefault), sample_threads_message.c_str())
+                ("decompressionThreads", value <std::size_t>()->default_value(defaults::decompressionThreadsDefault), decompression_threads_message.c_str())
+                ("memoryBudget", value <std::size_t>()->default_value(defaults::memoryBudgetDefault), memory_budget_message.c_str())
                 ;
 
             return options;
@@ -365,6 +446,7 @@ namespace caller
                 ("candidateVariantsFile", value<std::string>()->default_value(defaults::candidateVariantsFile.c_str()), "ad-hoc candidate variants file")
                 ("intermediateRecalibFileStem", value<std::string>()->default_value(defaults::intermediateRecalibFileStem.c_str()), "Intermediate Sam File stem of reads with recalibrated base qualities. Outputs stem_{sample_name}.sam")
                 ("genotypeAllelesFile", value<std::string>()->default_value(defaults::genotypeAllelesFile), "variants to be genotyped")
+                ("likelihoodsOutput", value<std::string>()->default_value(defaults::likelihoodsOutput), "write per-sample cluster likelihoods to this file, for joint calling with 'weCall mergeLikelihoods'")
                 ;
 
             return options;
@@ -48,6 +48,7 @@ namespace caller
 
             const std::string candidateVariantsFile;
             const std::string intermediateRecalibFileStem;
+            const std::string likelihoodsOutput;
 
             // -----------------------------------------------------------------------
             // Private Calling Params
@@ -99,10 +100,41 @@ namespace caller
             const std::size_t memLimitMin = 50;
             const std::size_t memLimitMax = 1024 * 1024;
 
+            const bool prefetchReads = true;
+
+            const std::size_t memoryBudgetDefault = 0;
+            const std::size_t memoryBudgetMin = 0;
+            const std::size_t memoryBudgetMax = 1024 * 1024;
+
             const std::size_t numberOfJobsDefault = 0;
             const std::size_t numberOfJobsMin = 0;
             const std::size_t numberOfJobsMax = 64;
 
+            const std::size_t clusterThreadsDefault = 1;
+            const std::size_t clusterThreadsMin = 1;
+            const std::size_t clusterThreadsMax = 64;
+
+            const std::size_t sampleThreadsDefault = 1;
+            const std::size_t sampleThreadsMin = 1;
+            const std::size_t sampleThreadsMax = 64;
+
+            const std::size_t decompressionThreadsDefault = 64;
+            const std::size_t decompressionThreadsMin = 0;
+            const std::size_t decompressionThreadsMax = 64;
+
+            const std::size_t shardSizeDefault = 0;
+            const std::size_t shardSizeMin = 0;
+            const std::size_t shardSizeMax = std::numeric_limits< int64_t >::max();
+
+            // Target shards per job when the shard size is chosen automatically, and the smallest shard worth
+            // the cost of padding and opening inputs.
+            const std::size_t shardsPerJob = 4;
+            const std::size_t minShardSize = 100000;
+
+            // Output of jobs waiting for an earlier job to finish that is held in memory, in bytes, before it is
+            // spilled to the working directory.
+            const std::size_t maxHeldOutputBytes = 64 * 1024 * 1024;
+
             // -----------------------------------------------------------------------
             // Data Params
 
@@ -258,7 +290,28 @@ namespace caller
         };
 
         void validateReduceParams( const Reduce & reduceParams );
-        void validateReduceParamsPreMap( const Reduce & reduceParams );
+
+        class MergeLikelihoods
+        {
+        public:
+            MergeLikelihoods( const variables_map & optValues )
+                : m_inputs( getParamList( "inputs", optValues ) ),
+                  m_outputDataSink( getParam< std::string >( "output", optValues ) ),
+                  m_refFile( getParam< std::string >( "refFile", optValues ) )
+            {
+            }
+
+            static options_description getOptionsDescription();
+
+            const std::vector< std::string > & inputs() const { return m_inputs; }
+            std::string outputDataSink() const { return m_outputDataSink; }
+            std::string refFile() const { return m_refFile; }
+
+        private:
+            std::vector< std::string > m_inputs;
+            std::string m_outputDataSink;
+            std::string m_refFile;
+        };
 
         class Data
         {
@@ -267,7 +320,13 @@ namespace caller
 
             static options_description getOptionsDescription();
 
-            std::vector< Data > splitWorkload() const;
+            /// Split the data regions into one Data per shard. The output data sinks of the shards are names that
+            /// sort in genome order. A shardSize of 0 balances the total region length over the number of jobs.
+            std::vector< Data > splitWorkload( const std::size_t numberOfJobs, const std::size_t shardSize ) const;
+
+            /// Hand the owned part of the data regions from position onwards to a new Data, whose output data sink
+            /// name sorts directly after this one's.
+            Data splitAt( const int64_t position );
 
             std::vector< std::string > const & inputDataSources() const { return m_inputDataSources; }
             std::string outputDataSink() const { return m_outputDataSink; }
@@ -275,6 +334,7 @@ namespace caller
             std::string workDir() const { return m_workDir; }
             std::string refFile() const { return m_refFile; }
             const partitionedRegions_t & dataRegions() const { return m_dataRegions; }
+            utils::Interval shardInterval() const { return m_shardInterval; }
             bool outputRefCalls() const { return m_outputRefCalls; }
             std::size_t maxRefCallSize() const { return m_maxRefCallSize; }
 
@@ -287,6 +347,7 @@ namespace caller
                   const std::string & workDir,
                   const std::string & refFile,
                   const partitionedRegions_t & dataRegions,
+                  const utils::Interval & shardInterval,
                   const bool & outputRefCalls,
                   const std::size_t & maxRefCallSize )
                 : m_inputDataSources( inputDataSources ),
@@ -295,6 +356,7 @@ namespace caller
                   m_workDir( workDir ),
                   m_refFile( refFile ),
                   m_dataRegions( dataRegions ),
+                  m_shardInterval( shardInterval ),
                   m_outputRefCalls( outputRefCalls ),
                   m_maxRefCallSize( maxRefCallSize )
             {
@@ -307,6 +369,7 @@ namespace caller
             std::string m_workDir;
             std::string m_refFile;
             partitionedRegions_t m_dataRegions;
+            utils::Interval m_shardInterval;
             bool m_outputRefCalls;
             std::size_t m_maxRefCallSize;
         };
@@ -316,7 +379,8 @@ namespace caller
             PrivateData( const variables_map & optValues )
                 : m_candidateVariantsFile( getParam< std::string >( "candidateVariantsFile", optValues ) ),
                   m_intermediateRecalibFileStem( getParam< std::string >( "intermediateRecalibFileStem", optValues ) ),
-                  m_genotypeAllelesFile( getParam< std::string >( "genotypeAllelesFile", optValues ) )
+                  m_genotypeAllelesFile( getParam< std::string >( "genotypeAllelesFile", optValues ) ),
+                  m_likelihoodsOutput( getParam< std::string >( "likelihoodsOutput", optValues ) )
             {
                 if ( this->genotypingMode() )
                 {
@@ -342,6 +406,7 @@ namespace caller
             std::string m_candidateVariantsFile;
             std::string m_intermediateRecalibFileStem;
             std::string m_genotypeAllelesFile;
+            std::string m_likelihoodsOutput;
         };
 
         struct Logging
@@ -379,7 +444,8 @@ namespace caller
                 : m_overwrite( getParam< bool >( "overwrite", optValues ) ),
                   m_biteSize( getParam< std::size_t >( "biteSize", optValues, 0ul ) ),
                   m_memLimit(
-                      getParam< std::size_t >( "memLimit", optValues, defaults::memLimitMin, defaults::memLimitMax ) )
+                      getParam< std::size_t >( "memLimit", optValues, defaults::memLimitMin, defaults::memLimitMax ) ),
+                  m_prefetchReads( getParam< bool >( "prefetchReads", optValues ) )
             {
             }
 
@@ -388,6 +454,7 @@ namespace caller
             bool m_overwrite;
             std::size_t m_biteSize;
             std::size_t m_memLimit;
+            bool m_prefetchReads;
         };
 
         struct System
@@ -400,8 +467,27 @@ namespace caller
                   m_numberOfJobs( getParam< std::size_t >( "numberOfJobs",
                                                            optValues,
                                                            defaults::numberOfJobsMin,
-                                                           defaults::numberOfJobsMax ) )
-
+                                                           defaults::numberOfJobsMax ) ),
+                  m_shardSize( getParam< std::size_t >( "shardSize",
+                                                        optValues,
+                                                        defaults::shardSizeMin,
+                                                        defaults::shardSizeMax ) ),
+                  m_clusterThreads( getParam< std::size_t >( "clusterThreads",
+                                                             optValues,
+                                                             defaults::clusterThreadsMin,
+                                                             defaults::clusterThreadsMax ) ),
+                  m_sampleThreads( getParam< std::size_t >( "sampleThreads",
+                                                            optValues,
+                                                            defaults::sampleThreadsMin,
+                                                            defaults::sampleThreadsMax ) ),
+                  m_decompressionThreads( getParam< std::size_t >( "decompressionThreads",
+                                                                   optValues,
+                                                                   defaults::decompressionThreadsMin,
+                                                                   defaults::decompressionThreadsMax ) ),
+                  m_memoryBudget( getParam< std::size_t >( "memoryBudget",
+                                                           optValues,
+                                                           defaults::memoryBudgetMin,
+                                                           defaults::memoryBudgetMax ) )
             {
             }
 
@@ -409,6 +495,11 @@ namespace caller
 
             std::size_t m_maxBlockSize;
             std::size_t m_numberOfJobs;
+            std::size_t m_shardSize;
+            std::size_t m_clusterThreads;
+            std::size_t m_sampleThreads;
+            std::size_t m_decompressionThreads;
+            std::size_t m_memoryBudget;
         };
 
         struct Filters
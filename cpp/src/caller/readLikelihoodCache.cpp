@@ -0,0 +1,103 @@
+// All content Copyright (C) 2018 Genomics plc
+#include "caller/readLikelihoodCache.hpp"
+#include "io/read.hpp"
+
+namespace wecall
+{
+namespace caller
+{
+    std::vector< double > ReadLikelihoodCache::getLikelihoods( const std::string & paddedHaplotypeSequence,
+                                                               const int64_t haplotypeStart,
+                                                               const std::vector< const io::Read * > & reads,
+                                                               const computeLikelihoods_t & computeLikelihoods )
+    {
+        std::vector< double > likelihoods( reads.size(), 0.0 );
+        std::vector< std::size_t > missedReadIndices;
+        std::vector< const io::Read * > missedReads;
+        readLikelihoods_t * cachedLikelihoodsPtr = nullptr;
+
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            // Entries are never removed, so the table stays where it is when other sequences are added.
+            cachedLikelihoodsPtr = &m_likelihoods[paddedHaplotypeSequence];
+            const auto & cachedLikelihoods = *cachedLikelihoodsPtr;
+            for ( std::size_t readIndex = 0; readIndex < reads.size(); ++readIndex )
+            {
+                const auto hintPosition = reads[readIndex]->getStartPos() - haplotypeStart;
+                const auto cached = cachedLikelihoods.find( {reads[readIndex], hintPosition} );
+                if ( cached == cachedLikelihoods.end() )
+                {
+                    missedReadIndices.push_back( readIndex );
+                    missedReads.push_back( reads[readIndex] );
+                }
+                else
+                {
+                    likelihoods[readIndex] = cached->second;
+                }
+            }
+            m_hits += reads.size() - missedReads.size();
+            m_misses += missedReads.size();
+        }
+
+        if ( missedReads.empty() )
+        {
+            return likelihoods;
+        }
+
+        // Computed without the lock so that other threads can use the cache meanwhile. Two threads missing the
+        // same read compute the same likelihood, so it does not matter which of them stores it.
+        const auto computedLikelihoods = computeLikelihoods( missedReads );
+
+        std::lock_guard< std::mutex > lock( m_mutex );
+        auto & cachedLikelihoods = *cachedLikelihoodsPtr;
+        cachedLikelihoods.reserve( cachedLikelihoods.size() + missedReads.size() );
+        for ( std::size_t i = 0; i < missedReads.size(); ++i )
+        {
+            const auto hintPosition = missedReads[i]->getStartPos() - haplotypeStart;
+            cachedLikelihoods.emplace( readKey_t( missedReads[i], hintPosition ), computedLikelihoods[i] );
+            likelihoods[missedReadIndices[i]] = computedLikelihoods[i];
+        }
+        return likelihoods;
+    }
+
+    std::size_t ReadLikelihoodCache::hits() const
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        return m_hits;
+    }
+
+    std::size_t ReadLikelihoodCache::misses() const
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        return m_misses;
+    }
+
+    double ReadLikelihoodCache::hitRate() const
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        const auto lookups = m_hits + m_misses;
+        return lookups == 0 ? 0.0 : static_cast< double >( m_hits ) / static_cast< double >( lookups );
+    }
+
+    std::size_t ReadLikelihoodCache::bytesUsed() const
+    {
+        // A hash table entry is a node holding the next pointer, the value and the cached hash, plus its bucket.
+        const auto tableBytes = []( std::size_t nBuckets, std::size_t nEntries, std::size_t valueBytes )
+        {
+            return nBuckets * sizeof( void * ) + nEntries * ( sizeof( void * ) + valueBytes + sizeof( std::size_t ) );
+        };
+
+        std::lock_guard< std::mutex > lock( m_mutex );
+        auto bytes = tableBytes( m_likelihoods.bucket_count(), m_likelihoods.size(),
+                                 sizeof( decltype( m_likelihoods )::value_type ) );
+        for ( const auto & sequenceLikelihoods : m_likelihoods )
+        {
+            const auto & likelihoods = sequenceLikelihoods.second;
+            bytes += sequenceLikelihoods.first.capacity();
+            bytes += tableBytes( likelihoods.bucket_count(), likelihoods.size(),
+                                 sizeof( readLikelihoods_t::value_type ) );
+        }
+        return bytes;
+    }
+}
+}
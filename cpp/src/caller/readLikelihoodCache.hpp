@@ -0,0 +1,72 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef READ_LIKELIHOOD_CACHE_HPP
+#define READ_LIKELIHOOD_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace wecall
+{
+namespace io
+{
+    class Read;
+}
+
+namespace caller
+{
+    /// Likelihoods of reads given padded haplotype sequences, kept for the lifetime of a block so that the
+    /// haplotype ranker, the genotyping model and phase alignment between clusters each align a read against a
+    /// haplotype sequence only once.
+    ///
+    /// A likelihood is keyed by the read, the padded haplotype sequence and the hint position of the read in it,
+    /// which is everything computeLikelihoodForReadAndHaplotype depends on. Reads are identified by address, so the
+    /// cache must not outlive the reads, and must not be used while their qualities are being changed. It may be
+    /// shared between threads.
+    class ReadLikelihoodCache
+    {
+    public:
+        using computeLikelihoods_t =
+            std::function< std::vector< double >( const std::vector< const io::Read * > & reads ) >;
+
+        /// Likelihoods of the reads given a padded haplotype sequence starting at haplotypeStart. Those not cached
+        /// are computed, all in one call of computeLikelihoods, and cached.
+        std::vector< double > getLikelihoods( const std::string & paddedHaplotypeSequence,
+                                              const int64_t haplotypeStart,
+                                              const std::vector< const io::Read * > & reads,
+                                              const computeLikelihoods_t & computeLikelihoods );
+
+        std::size_t hits() const;
+        std::size_t misses() const;
+        double hitRate() const;
+
+        /// Approximate bytes of memory held by the cached likelihoods.
+        std::size_t bytesUsed() const;
+
+    private:
+        using readKey_t = std::pair< const io::Read *, int64_t >;
+
+        struct ReadKeyHash
+        {
+            std::size_t operator()( const readKey_t & key ) const
+            {
+                return std::hash< const io::Read * >()( key.first ) ^ std::hash< int64_t >()( key.second ) * 31;
+            }
+        };
+
+        using readLikelihoods_t = std::unordered_map< readKey_t, double, ReadKeyHash >;
+
+        mutable std::mutex m_mutex;
+        std::unordered_map< std::string, readLikelihoods_t > m_likelihoods;
+        std::size_t m_hits = 0;
+        std::size_t m_misses = 0;
+    };
+}
+}
+
+#endif
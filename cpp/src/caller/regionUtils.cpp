@@ -1,6 +1,7 @@
 // All content Copyright (C) 2018 Genomics plc
 #include <vector>
 #include <set>
+#include <limits>
 
 #include <boost/algorithm/string/join.hpp>
 #include <boost/filesystem.hpp>
@@ -53,7 +54,7 @@ namespace caller
     regions_t DataRegionsBuilderBase::getValidRegions( const regions_t & regions ) const
     {
         // Check the regions
-        const auto allowedContigs = m_fastaIndexFile.contigs();
+        const auto & allowedContigs = m_fastaIndexFile.contigs();
 
         regions_t goodRegions;
         std::set< std::string > badContigs;
@@ -115,7 +116,7 @@ namespace caller
     regions_t DataRegionsBuilder::getDefaultRegions() const
     {
         regions_t regions;
-        const auto contigs = m_fastaIndexFile.contigs();
+        const auto & contigs = m_fastaIndexFile.contigs();
 
         for ( const auto & contigName : m_fastaIndexFile.standardContigs() )
         {
@@ -142,7 +143,7 @@ namespace caller
     regions_t DataRegionsBuilder::getRegionsFromStrings() const
     {
         regions_t regions;
-        const auto contigs = m_fastaIndexFile.contigs();
+        const auto & contigs = m_fastaIndexFile.contigs();
         for ( auto regionString : m_inputRegionStrings )
         {
             regions.push_back( parseRegionString( regionString, contigs ) );
@@ -294,6 +295,64 @@ namespace caller
         return paddedPartitionedRegions;
     }
 
+    utils::Interval unboundedShardInterval() { return utils::Interval( 0, std::numeric_limits< int64_t >::max() ); }
+
+    regionShards_t shardPartitionedRegions( const partitionedRegions_t & partitionedRegions, const int64_t shardSize )
+    {
+        regionShards_t shards;
+
+        for ( const auto & partition : partitionedRegions )
+        {
+            if ( shardSize <= 0 )
+            {
+                shards.push_back( {partition, unboundedShardInterval()} );
+                continue;
+            }
+
+            const auto firstShardInPartition = shards.size();
+
+            regions_t currentRegions;
+            int64_t currentSize = 0;
+            int64_t ownedStart = 0;
+
+            for ( const auto & region : partition )
+            {
+                auto pos = region.start();
+                while ( pos < region.end() )
+                {
+                    const auto take = std::min( region.end() - pos, shardSize - currentSize );
+                    currentRegions.emplace_back( region.contig(), pos, pos + take );
+                    currentSize += take;
+                    pos += take;
+
+                    if ( currentSize == shardSize )
+                    {
+                        // Cut at the end of the last region taken: calls starting in any gap after it overlap
+                        // a later region, so they belong to the next shard.
+                        shards.push_back( {currentRegions, utils::Interval( ownedStart, pos )} );
+                        ownedStart = pos;
+                        currentRegions.clear();
+                        currentSize = 0;
+                    }
+                }
+            }
+
+            if ( not currentRegions.empty() )
+            {
+                shards.push_back(
+                    {currentRegions, utils::Interval( ownedStart, std::numeric_limits< int64_t >::max() )} );
+            }
+            else if ( shards.size() > firstShardInPartition )
+            {
+                const auto lastOwnedStart = shards.back().ownedInterval.start();
+                shards.back().ownedInterval =
+                    utils::Interval( lastOwnedStart, std::numeric_limits< int64_t >::max() );
+            }
+        }
+
+        return shards;
+    }
+
     bool RegionComp::operator()( const Region & a, const Region & b )
     {
         if ( m_fastaIndexFile.contigStart( a.contig() ) == m_fastaIndexFile.contigStart( b.contig() ) )
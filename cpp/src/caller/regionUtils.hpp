@@ -60,6 +60,24 @@ namespace caller
     partitionedRegions_t padPartitionedRegions( const partitionedRegions_t & partitionedRegions,
                                                 const int64_t paddingAmount );
 
+    /// A unit of parallel work: a subset of the regions on one contig together with the interval of the contig
+    /// it owns. Owned intervals of the shards of a contig tile the contig, so a call is reported by exactly one
+    /// shard - the one owning its start position.
+    struct RegionShard
+    {
+        regions_t regions;
+        utils::Interval ownedInterval;
+    };
+
+    using regionShards_t = std::vector< RegionShard >;
+
+    /// Interval owned by a shard that was not cut out of a larger contig partition.
+    utils::Interval unboundedShardInterval();
+
+    /// Cut each contig partition into shards covering at most shardSize bases of region. A shardSize of 0 keeps
+    /// one shard per contig partition.
+    regionShards_t shardPartitionedRegions( const partitionedRegions_t & partitionedRegions, const int64_t shardSize );
+
     struct RegionIntervalComp
     {
         bool operator()( const Region & a, const Region & b ) { return a.interval() < b.interval(); }
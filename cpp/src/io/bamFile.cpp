@@ -18,6 +18,9 @@
 #include "boost/filesystem.hpp"
 #include "utils/timer.hpp"
 
+// defined in bam_aux.c
+extern "C" void bam_init_header_hash( bam_header_t * header );
+
 namespace wecall
 {
 namespace io
@@ -25,10 +28,11 @@ namespace io
 
     //-----------------------------------------------------------------------------------------
 
-    BamFile::BamFile( std::string fileName )
+    BamFile::BamFile( std::string fileName, std::size_t decoderThreads )
         : m_fileName( fileName ),
           m_samFile( nullptr ),
           m_index( nullptr ),
+          m_bgzfFile( nullptr ),
           m_timer( std::make_shared< utils::Timer >( "IO", utils::fileMetaData( fileName ) ) )
 
     {
@@ -44,6 +48,11 @@ namespace io
 
         m_samFile = samopen( fileName.c_str(), "rb", nullptr );
         m_samplesByID = this->getSamplesByID();
+
+        // Build the contig lookup that region parsing would otherwise build on first use, so that regions can be
+        // read from several threads at once.
+        bam_init_header_hash( m_samFile->header );
+        m_bgzfFile = std::make_shared< BgzfFile >( fileName, BgzfDecoderPool::processPool( decoderThreads ) );
     }
 
     //-----------------------------------------------------------------------------------------
@@ -199,16 +208,18 @@ namespace io
             throw utils::wecall_exception( "Invalid region - BAM file start coordinate > end" );
         }
 
-        bam_fetch_iterator_t * bam_fetch_iterator =
-            bam_init_fetch_iterator( m_samFile->x.bam, m_index, rtid, rstart, rend );
+        // Records are read through the shared decoder pool; the samtools handle only provides the header.
+        std::unique_ptr< BgzfReader > reader( new BgzfReader( m_bgzfFile ) );
+        bam_fetch_iterator_t * bam_fetch_iterator = bam_init_fetch_iterator( reader.get(), m_index, rtid, rstart, rend );
         if ( m_samplesByID.empty() )
         {
-            return std::make_shared< BamFileWithoutReadGroupIterator >( bam_fetch_iterator, this->default_sample_name(),
-                                                                        m_refSequence, m_timer );
+            return std::make_shared< BamFileWithoutReadGroupIterator >(
+                std::move( reader ), bam_fetch_iterator, this->default_sample_name(), m_refSequence, m_timer );
         }
         else
         {
-            return std::make_shared< BamFileIterator >( bam_fetch_iterator, m_samplesByID, m_refSequence, m_timer );
+            return std::make_shared< BamFileIterator >( std::move( reader ), bam_fetch_iterator, m_samplesByID,
+                                                        m_refSequence, m_timer );
         }
     }
 }
@@ -26,6 +26,7 @@ extern "C" {
 #include "io/readDataSet.hpp"
 #include "io/read.hpp"
 #include "bamFileIterator.hpp"
+#include "io/bgzfReader.hpp"
 #include "io/pysam.hpp"
 
 namespace wecall
@@ -38,7 +39,7 @@ namespace io
     /// Concrete data source class to represent a BAM file. BAM is a compressed (using bgzip)
     /// binary format for storing read data, typically (but not neccessarily) aligned to a
     /// reference genome. Here we use Samtools (http://samtools.sourceforge.net/) to provde
-    /// random access to the read data.
+    /// random access to the read data. Regions may be read from several threads at once.
     class BamFile
     {
     public:
@@ -46,7 +47,9 @@ namespace io
         /// reading.
         ///
         /// @param fileName The name of the BAM file in the filesystem. Must be readable
-        explicit BamFile( std::string fileName );
+        /// @param decoderThreads The most threads decompressing the file ahead of its readers. The threads are shared
+        /// with all other BAM files of the process. With none, reads are decompressed as they are read.
+        explicit BamFile( std::string fileName, std::size_t decoderThreads = 0 );
 
         /// Destructor. Free up memory and close file
         ~BamFile();
@@ -71,6 +74,7 @@ namespace io
         std::string m_fileName;  /// The name of the file
         samfile_t * m_samFile;   /// A pointer to the Samtools data-structure
         bam_index_t * m_index;   /// Pointer to the Samtools index structure
+        bgzfFilePtr_t m_bgzfFile;
         utils::timerPtr_t m_timer;
         std::map< std::string, std::string > m_samplesByID;
 
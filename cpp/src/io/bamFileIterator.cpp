@@ -6,10 +6,11 @@ namespace wecall
 {
 namespace io
 {
-    AbstractBamFileIterator::AbstractBamFileIterator( bam_fetch_iterator_t * bamIterator,
+    AbstractBamFileIterator::AbstractBamFileIterator( std::unique_ptr< BgzfReader > reader,
+                                                      bam_fetch_iterator_t * bamIterator,
                                                       utils::referenceSequencePtr_t refSequence,
                                                       utils::timerPtr_t timer )
-        : m_refSequence( refSequence ), m_bamIterator( bamIterator ), m_timer( timer )
+        : m_refSequence( refSequence ), m_reader( std::move( reader ) ), m_bamIterator( bamIterator ), m_timer( timer )
     {
         m_bamRecordPtr = bam_fetch_iterate( m_bamIterator );
     }
@@ -18,6 +19,7 @@ namespace io
     {
         bam_cleanup_fetch_iterator( m_bamIterator );
         free( m_bamIterator );
+        m_timer->addBytes( m_reader->bytesDecompressed() );
     }
 
     void AbstractBamFileIterator::next() { m_bamRecordPtr = bam_fetch_iterate( m_bamIterator ); }
@@ -26,17 +28,18 @@ namespace io
 
     //-----------------------------------------------------------------------------------------
 
-    BamFileIterator::BamFileIterator( bam_fetch_iterator_t * bamIterator,
+    BamFileIterator::BamFileIterator( std::unique_ptr< BgzfReader > reader,
+                                      bam_fetch_iterator_t * bamIterator,
                                       std::map< std::string, std::string > samplesByID,
                                       utils::referenceSequencePtr_t refSequence,
                                       utils::timerPtr_t timer )
-        : AbstractBamFileIterator( bamIterator, refSequence, timer ), m_samplesByID( samplesByID )
+        : AbstractBamFileIterator( std::move( reader ), bamIterator, refSequence, timer ), m_samplesByID( samplesByID )
     {
     }
 
     BamFileIterator::~BamFileIterator() {}
 
-    std::pair< std::string, readPtr_t > BamFileIterator::getReadData()
+    std::pair< std::string, Read > BamFileIterator::getReadData()
     {
         if ( not this->hasReadData() )
         {
@@ -57,35 +60,30 @@ namespace io
             throw utils::wecall_exception( "Found read without matching sample name in BAM header!" );
         }
 
-        std::string sampleName = it->second;
-
-        readPtr_t read = std::make_shared< Read >( m_bamRecordPtr, m_refSequence );
-
-        return std::make_pair( sampleName, read );
+        return std::make_pair( it->second, Read( m_bamRecordPtr, m_refSequence ) );
     }
 
     //-----------------------------------------------------------------------------------------
 
-    BamFileWithoutReadGroupIterator::BamFileWithoutReadGroupIterator( bam_fetch_iterator_t * bamIterator,
+    BamFileWithoutReadGroupIterator::BamFileWithoutReadGroupIterator( std::unique_ptr< BgzfReader > reader,
+                                                                      bam_fetch_iterator_t * bamIterator,
                                                                       std::string sampleName,
                                                                       utils::referenceSequencePtr_t refSequence,
                                                                       utils::timerPtr_t timer )
-        : AbstractBamFileIterator( bamIterator, refSequence, timer ), m_sampleName( sampleName )
+        : AbstractBamFileIterator( std::move( reader ), bamIterator, refSequence, timer ), m_sampleName( sampleName )
     {
     }
 
     BamFileWithoutReadGroupIterator::~BamFileWithoutReadGroupIterator() {}
 
-    std::pair< std::string, readPtr_t > BamFileWithoutReadGroupIterator::getReadData()
+    std::pair< std::string, Read > BamFileWithoutReadGroupIterator::getReadData()
     {
         if ( not this->hasReadData() )
         {
             throw utils::wecall_exception( "Tried to get read data without checking if there were more to get" );
         }
 
-        readPtr_t read = std::make_shared< Read >( m_bamRecordPtr, m_refSequence );
-
-        return std::make_pair( m_sampleName, read );
+        return std::make_pair( m_sampleName, Read( m_bamRecordPtr, m_refSequence ) );
     }
 }
 }
@@ -5,6 +5,7 @@
 #include "utils/timer.hpp"
 #include "common.hpp"
 #include "io/read.hpp"
+#include "io/bgzfReader.hpp"
 
 namespace wecall
 {
@@ -14,14 +15,20 @@ namespace io
     class AbstractBamFileIterator
     {
     public:
-        AbstractBamFileIterator( bam_fetch_iterator_t * bamIterator,
+        AbstractBamFileIterator( std::unique_ptr< BgzfReader > reader,
+                                 bam_fetch_iterator_t * bamIterator,
                                  utils::referenceSequencePtr_t refSequence,
                                  utils::timerPtr_t timer );
         virtual ~AbstractBamFileIterator();
 
         void next();
         bool hasReadData();
-        virtual std::pair< std::string, readPtr_t > getReadData() = 0;
+
+        /// The start of the alignment of the current BAM record, known without constructing its read.
+        int64_t startPos() const { return m_bamRecordPtr->core.pos; }
+
+        /// The sample name and read of the current BAM record.
+        virtual std::pair< std::string, Read > getReadData() = 0;
 
         utils::ScopedTimerTrigger timer() { return utils::ScopedTimerTrigger( m_timer ); }
 
@@ -30,6 +37,7 @@ namespace io
         utils::referenceSequencePtr_t m_refSequence;
 
     private:
+        std::unique_ptr< BgzfReader > m_reader;
         bam_fetch_iterator_t * m_bamIterator;
         utils::timerPtr_t m_timer;
     };
@@ -37,13 +45,14 @@ namespace io
     class BamFileIterator : public AbstractBamFileIterator
     {
     public:
-        BamFileIterator( bam_fetch_iterator_t * bamIterator,
+        BamFileIterator( std::unique_ptr< BgzfReader > reader,
+                         bam_fetch_iterator_t * bamIterator,
                          std::map< std::string, std::string > samplesByID,
                          utils::referenceSequencePtr_t refSequence,
                          utils::timerPtr_t timer );
         ~BamFileIterator();
 
-        std::pair< std::string, readPtr_t > getReadData() override;
+        std::pair< std::string, Read > getReadData() override;
 
     private:
         const std::map< std::string, std::string > m_samplesByID;
@@ -52,13 +61,14 @@ namespace io
     class BamFileWithoutReadGroupIterator : public AbstractBamFileIterator
     {
     public:
-        BamFileWithoutReadGroupIterator( bam_fetch_iterator_t * bamIterator,
+        BamFileWithoutReadGroupIterator( std::unique_ptr< BgzfReader > reader,
+                                         bam_fetch_iterator_t * bamIterator,
                                          std::string sampleName,
                                          utils::referenceSequencePtr_t refSequence,
                                          utils::timerPtr_t timer );
         ~BamFileWithoutReadGroupIterator();
 
-        std::pair< std::string, readPtr_t > getReadData() override;
+        std::pair< std::string, Read > getReadData() override;
 
     private:
         const std::string m_sampleName;
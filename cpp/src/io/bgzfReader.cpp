@@ -0,0 +1,299 @@
+// All content Copyright (C) 2018 Genomics plc
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include "io/bgzfReader.hpp"
+#include "utils/logging.hpp"
+
+namespace wecall
+{
+namespace io
+{
+    namespace
+    {
+        const std::size_t blockHeaderLength = 18;
+        const std::size_t blockFooterLength = 8;
+
+        uint32_t unpackLittleEndian( const uint8_t * bytes, const std::size_t nBytes )
+        {
+            uint32_t value = 0;
+            for ( std::size_t i = 0; i < nBytes; ++i )
+            {
+                value |= uint32_t( bytes[i] ) << ( 8 * i );
+            }
+            return value;
+        }
+
+        /// The gzip header of a BGZF block, with the extra field holding the compressed block size.
+        bool isBgzfHeader( const uint8_t * header )
+        {
+            return header[0] == 31 and header[1] == 139 and header[2] == 8 and ( header[3] & 4 ) != 0 and
+                   unpackLittleEndian( header + 10, 2 ) == 6 and header[12] == 'B' and header[13] == 'C' and
+                   unpackLittleEndian( header + 14, 2 ) == 2;
+        }
+
+        bgzfBlockPtr_t inflateBlock( const std::string & fileName,
+                                     const int64_t address,
+                                     const std::vector< uint8_t > & compressed )
+        {
+            auto block = std::make_shared< BgzfBlock >();
+            block->address = address;
+            block->data.resize( unpackLittleEndian( compressed.data() + compressed.size() - 4, 4 ) );
+            if ( block->data.empty() )
+            {
+                return block;
+            }
+
+            z_stream stream;
+            std::memset( &stream, 0, sizeof( stream ) );
+            stream.next_in = const_cast< uint8_t * >( compressed.data() + blockHeaderLength );
+            stream.avail_in = uInt( compressed.size() - blockHeaderLength - blockFooterLength );
+            stream.next_out = block->data.data();
+            stream.avail_out = uInt( block->data.size() );
+
+            WECALL_ERROR( inflateInit2( &stream, -15 ) == Z_OK, "Could not initialise zlib to read " + fileName );
+            const auto status = inflate( &stream, Z_FINISH );
+            const auto inflatedSize = stream.total_out;
+            inflateEnd( &stream );
+
+            WECALL_ERROR( status == Z_STREAM_END and inflatedSize == block->data.size(),
+                          "Corrupt BGZF block at offset " + std::to_string( address ) + " of " + fileName );
+            return block;
+        }
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    BgzfDecoderPool::BgzfDecoderPool( const std::size_t nThreads ) : m_stopping( false )
+    {
+        for ( std::size_t i = 0; i < nThreads; ++i )
+        {
+            m_threads.emplace_back( &BgzfDecoderPool::workerLoop, this );
+        }
+    }
+
+    BgzfDecoderPool::~BgzfDecoderPool()
+    {
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            m_stopping = true;
+        }
+        m_condition.notify_all();
+        for ( auto & thread : m_threads )
+        {
+            thread.join();
+        }
+    }
+
+    std::shared_ptr< BgzfDecoderPool > BgzfDecoderPool::processPool( const std::size_t maxThreads )
+    {
+        static std::mutex poolMutex;
+        static std::weak_ptr< BgzfDecoderPool > processPool;
+
+        std::lock_guard< std::mutex > lock( poolMutex );
+        auto pool = processPool.lock();
+        if ( pool == nullptr )
+        {
+            auto nThreads = maxThreads;
+            const std::size_t numberOfCores = std::thread::hardware_concurrency();
+            if ( numberOfCores > 0 )
+            {
+                nThreads = std::min( nThreads, numberOfCores );
+            }
+
+            WECALL_LOG( DEBUG, "Decompressing BAM files on " << nThreads << " threads" );
+            pool = std::make_shared< BgzfDecoderPool >( nThreads );
+            processPool = pool;
+        }
+        return pool;
+    }
+
+    std::shared_future< bgzfBlockPtr_t > BgzfDecoderPool::submit( std::function< bgzfBlockPtr_t() > decompress )
+    {
+        auto task = std::make_shared< std::packaged_task< bgzfBlockPtr_t() > >( std::move( decompress ) );
+        auto block = task->get_future().share();
+        if ( m_threads.empty() )
+        {
+            ( *task )();
+        }
+        else
+        {
+            {
+                std::lock_guard< std::mutex > lock( m_mutex );
+                m_tasks.emplace_back( [task]()
+                                      {
+                                          ( *task )();
+                                      } );
+            }
+            m_condition.notify_one();
+        }
+        return block;
+    }
+
+    void BgzfDecoderPool::workerLoop()
+    {
+        for ( ;; )
+        {
+            std::function< void() > task;
+            {
+                std::unique_lock< std::mutex > lock( m_mutex );
+                m_condition.wait( lock, [this]()
+                                  {
+                                      return m_stopping or not m_tasks.empty();
+                                  } );
+                if ( m_tasks.empty() )
+                {
+                    return;
+                }
+                task = std::move( m_tasks.front() );
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    BgzfFile::BgzfFile( const std::string & fileName, bgzfDecoderPoolPtr_t pool )
+        : m_fileName( fileName ), m_fileDescriptor( ::open( fileName.c_str(), O_RDONLY ) ), m_pool( pool )
+    {
+        WECALL_ERROR( m_fileDescriptor >= 0, "Could not open " + fileName + " for reading" );
+    }
+
+    BgzfFile::~BgzfFile() { ::close( m_fileDescriptor ); }
+
+    BgzfFile::PendingBlock BgzfFile::decode( const int64_t address )
+    {
+        uint8_t header[blockHeaderLength];
+        const auto headerBytes = ::pread( m_fileDescriptor, header, blockHeaderLength, address );
+        if ( headerBytes == 0 )
+        {
+            std::promise< bgzfBlockPtr_t > endOfFile;
+            endOfFile.set_value( std::make_shared< BgzfBlock >( BgzfBlock{address, {}} ) );
+            return {address, address, endOfFile.get_future().share()};
+        }
+
+        const std::string location = "offset " + std::to_string( address ) + " of " + m_fileName;
+        WECALL_ERROR( headerBytes == ssize_t( blockHeaderLength ) and isBgzfHeader( header ),
+                      "Invalid BGZF block header at " + location );
+
+        const std::size_t blockLength = unpackLittleEndian( header + 16, 2 ) + 1;
+        WECALL_ERROR( blockLength > blockHeaderLength + blockFooterLength, "Invalid BGZF block size at " + location );
+
+        std::vector< uint8_t > compressed( blockLength );
+        std::memcpy( compressed.data(), header, blockHeaderLength );
+        const auto bodyLength = blockLength - blockHeaderLength;
+        WECALL_ERROR( ::pread( m_fileDescriptor, compressed.data() + blockHeaderLength, bodyLength,
+                               address + int64_t( blockHeaderLength ) ) == ssize_t( bodyLength ),
+                      "Truncated BGZF block at " + location );
+
+        const auto block = m_pool->submit( std::bind( &inflateBlock, m_fileName, address, std::move( compressed ) ) );
+        return {address, address + int64_t( blockLength ), block};
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    BgzfReader::BgzfReader( bgzfFilePtr_t file )
+        : m_file( file ),
+          m_readAheadBlocks( 2 * file->pool().nThreads() ),
+          m_address( 0 ),
+          m_offset( 0 ),
+          m_block( nullptr ),
+          m_nextAddress( 0 ),
+          m_readAheadAddress( 0 ),
+          m_readAheadLimit( -1 ),
+          m_bytesDecompressed( 0 )
+    {
+    }
+
+    void BgzfReader::seek( const uint64_t virtualOffset )
+    {
+        m_address = int64_t( virtualOffset >> 16 );
+        m_offset = int( virtualOffset & 0xffff );
+        m_block.reset();
+    }
+
+    void BgzfReader::setReadAheadLimit( const uint64_t virtualOffset )
+    {
+        m_readAheadLimit = int64_t( virtualOffset >> 16 );
+    }
+
+    std::size_t BgzfReader::read( void * buffer, const std::size_t length )
+    {
+        auto output = static_cast< uint8_t * >( buffer );
+        std::size_t copied = 0;
+        while ( copied < length )
+        {
+            if ( m_block == nullptr )
+            {
+                this->loadBlock();
+            }
+            if ( m_block->data.empty() )
+            {
+                break;
+            }
+
+            const auto available = int64_t( m_block->data.size() ) - m_offset;
+            const auto nBytes = std::min( std::size_t( std::max( available, int64_t( 0 ) ) ), length - copied );
+            std::memcpy( output + copied, m_block->data.data() + m_offset, nBytes );
+            m_offset += int( nBytes );
+            copied += nBytes;
+
+            // As in samtools, the end of a block is addressed as the start of the next one.
+            if ( m_offset >= int( m_block->data.size() ) )
+            {
+                m_address = m_nextAddress;
+                m_offset = 0;
+                m_block.reset();
+            }
+        }
+        return copied;
+    }
+
+    void BgzfReader::loadBlock()
+    {
+        if ( not m_readAhead.empty() and m_readAhead.front().address != m_address )
+        {
+            m_readAhead.clear();
+        }
+
+        BgzfFile::PendingBlock pending;
+        if ( m_readAhead.empty() )
+        {
+            pending = m_file->decode( m_address );
+            m_readAheadAddress = pending.nextAddress;
+        }
+        else
+        {
+            pending = m_readAhead.front();
+            m_readAhead.pop_front();
+        }
+        m_nextAddress = pending.nextAddress;
+
+        // Queue the following blocks before waiting, so the decoder threads work on them in the meantime.
+        this->fillReadAhead();
+
+        m_block = pending.block.get();
+        m_bytesDecompressed += m_block->data.size();
+    }
+
+    void BgzfReader::fillReadAhead()
+    {
+        while ( m_readAhead.size() < m_readAheadBlocks and m_readAheadAddress <= m_readAheadLimit )
+        {
+            auto pending = m_file->decode( m_readAheadAddress );
+            if ( pending.nextAddress == pending.address )
+            {
+                break;
+            }
+            m_readAheadAddress = pending.nextAddress;
+            m_readAhead.push_back( std::move( pending ) );
+        }
+    }
+}
+}
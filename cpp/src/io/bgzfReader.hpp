@@ -0,0 +1,145 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef BGZF_READER_HPP
+#define BGZF_READER_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wecall
+{
+namespace io
+{
+    /// One decompressed BGZF block. An empty block marks the end of the file.
+    struct BgzfBlock
+    {
+        int64_t address;
+        std::vector< uint8_t > data;
+    };
+
+    using bgzfBlockPtr_t = std::shared_ptr< const BgzfBlock >;
+
+    /// Decompresses BGZF blocks on a pool of threads. One pool serves every BGZF file of the process, so that
+    /// parallel jobs reading several BAM files do not each start their own threads.
+    class BgzfDecoderPool
+    {
+    public:
+        /// @param nThreads The number of decoder threads. With none, blocks are decompressed by the caller.
+        explicit BgzfDecoderPool( std::size_t nThreads );
+        ~BgzfDecoderPool();
+
+        BgzfDecoderPool( const BgzfDecoderPool & rhs ) = delete;
+        BgzfDecoderPool & operator=( const BgzfDecoderPool & ) = delete;
+
+        /// The pool of the process, shared with all other readers that are still open. It is started by the first
+        /// caller with at most maxThreads threads, capped at the number of cores.
+        static std::shared_ptr< BgzfDecoderPool > processPool( std::size_t maxThreads );
+
+        /// Run a decompression on the pool, or at once if it has no threads.
+        std::shared_future< bgzfBlockPtr_t > submit( std::function< bgzfBlockPtr_t() > decompress );
+
+        std::size_t nThreads() const { return m_threads.size(); }
+
+    private:
+        void workerLoop();
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::deque< std::function< void() > > m_tasks;
+        bool m_stopping;
+        std::vector< std::thread > m_threads;
+    };
+
+    using bgzfDecoderPoolPtr_t = std::shared_ptr< BgzfDecoderPool >;
+
+    /// A BGZF file whose blocks are decompressed on a decoder pool. The compressed bytes are read by the caller,
+    /// which is cheap, and only inflating them is left to the pool.
+    class BgzfFile
+    {
+    public:
+        /// A block that has been read and queued for decompression.
+        struct PendingBlock
+        {
+            int64_t address;
+            int64_t nextAddress;
+            std::shared_future< bgzfBlockPtr_t > block;
+        };
+
+        BgzfFile( const std::string & fileName, bgzfDecoderPoolPtr_t pool );
+        ~BgzfFile();
+
+        BgzfFile( const BgzfFile & rhs ) = delete;
+        BgzfFile & operator=( const BgzfFile & ) = delete;
+
+        /// Read the compressed block at the given file offset and queue it for decompression. At the end of the
+        /// file the next address is the address itself.
+        PendingBlock decode( int64_t address );
+
+        const BgzfDecoderPool & pool() const { return *m_pool; }
+
+    private:
+        const std::string m_fileName;
+        int m_fileDescriptor;
+        bgzfDecoderPoolPtr_t m_pool;
+    };
+
+    using bgzfFilePtr_t = std::shared_ptr< BgzfFile >;
+
+    /// Sequential reader of a BGZF file through its decoder pool, addressed by the same virtual file
+    /// offsets as samtools: the file offset of a block shifted left by 16 bits, plus the offset into its
+    /// decompressed data. Blocks after the current one are decompressed ahead, up to a limit set by the caller.
+    class BgzfReader
+    {
+    public:
+        explicit BgzfReader( bgzfFilePtr_t file );
+
+        /// Move to a virtual file offset.
+        void seek( uint64_t virtualOffset );
+
+        /// The virtual file offset of the next byte to be read.
+        uint64_t tell() const { return ( uint64_t( m_address ) << 16 ) | uint64_t( m_offset ); }
+
+        /// Decompress blocks ahead of the current one, up to and including the block at the given virtual offset.
+        void setReadAheadLimit( uint64_t virtualOffset );
+
+        /// Copy the next bytes into buffer.
+        ///
+        /// @return The number of bytes copied, which is less than length only at the end of the file.
+        std::size_t read( void * buffer, std::size_t length );
+
+        /// Total decompressed size of the blocks read so far.
+        std::size_t bytesDecompressed() const { return m_bytesDecompressed; }
+
+    private:
+        /// Make the block at the current address the current block, taking it from the read-ahead queue if it is
+        /// there.
+        void loadBlock();
+        void fillReadAhead();
+
+    private:
+        bgzfFilePtr_t m_file;
+        const std::size_t m_readAheadBlocks;
+
+        int64_t m_address;
+        int m_offset;
+        bgzfBlockPtr_t m_block;
+        int64_t m_nextAddress;
+
+        std::deque< BgzfFile::PendingBlock > m_readAhead;
+        int64_t m_readAheadAddress;
+        int64_t m_readAheadLimit;
+
+        std::size_t m_bytesDecompressed;
+    };
+}
+}
+
+#endif
@@ -0,0 +1,67 @@
+// All content Copyright (C) 2018 Genomics plc
+#include "io/blockSizeController.hpp"
+
+#include <algorithm>
+
+namespace wecall
+{
+namespace io
+{
+    namespace
+    {
+        /// Weight of a new block in the estimate when it is sparser than the blocks before it.
+        const double decayWeight = 0.25;
+
+        /// Number of bites the target is split into.
+        const int64_t bitesPerTarget = 20;
+    }
+
+    BlockSizeController::BlockSizeController( const int64_t maxBlockSize,
+                                              const int64_t maxBiteSize,
+                                              const int64_t targetBytes )
+        : m_maxBlockSize( maxBlockSize ),
+          m_maxBiteSize( maxBiteSize ),
+          m_targetBytes( targetBytes ),
+          m_bytesPerBase( 0 )
+    {
+    }
+
+    void BlockSizeController::recordBlock( const int64_t blockLength, const int64_t bytesUsed )
+    {
+        if ( blockLength <= 0 )
+        {
+            return;
+        }
+
+        const auto observed = static_cast< double >( bytesUsed ) / static_cast< double >( blockLength );
+        if ( observed >= m_bytesPerBase )
+        {
+            m_bytesPerBase = observed;
+        }
+        else
+        {
+            m_bytesPerBase = ( 1.0 - decayWeight ) * m_bytesPerBase + decayWeight * observed;
+        }
+    }
+
+    int64_t BlockSizeController::blockSize() const
+    {
+        if ( m_bytesPerBase <= 0.0 )
+        {
+            return m_maxBlockSize;
+        }
+        const auto targetSize = static_cast< double >( m_targetBytes ) / m_bytesPerBase;
+        return std::min( m_maxBlockSize, std::max( static_cast< int64_t >( targetSize ), this->biteSize() ) );
+    }
+
+    int64_t BlockSizeController::biteSize() const
+    {
+        if ( m_bytesPerBase <= 0.0 )
+        {
+            return m_maxBiteSize;
+        }
+        const auto targetSize = static_cast< double >( m_targetBytes / bitesPerTarget ) / m_bytesPerBase;
+        return std::max( std::min( m_maxBiteSize, static_cast< int64_t >( targetSize ) ), int64_t( 1 ) );
+    }
+}
+}
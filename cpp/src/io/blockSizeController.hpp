@@ -0,0 +1,44 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef BLOCK_SIZE_CONTROLLER_HPP
+#define BLOCK_SIZE_CONTROLLER_HPP
+
+#include <cstdint>
+
+namespace wecall
+{
+namespace io
+{
+    /// Chooses the sizes of the blocks and bites that reads are loaded in, so that the memory used by a block -
+    /// its reads and what calling them allocates - stays near a target. The bytes used per base of the genome are
+    /// learnt from the blocks seen so far: the estimate rises at once with a denser block and falls back slowly.
+    class BlockSizeController
+    {
+    public:
+        /// @param maxBlockSize Largest block size in bases, used until the first block has been recorded.
+        /// @param maxBiteSize Largest bite size in bases.
+        /// @param targetBytes Memory a block should use.
+        BlockSizeController( int64_t maxBlockSize, int64_t maxBiteSize, int64_t targetBytes );
+
+        /// Learn from the memory used by a block of blockLength bases.
+        void recordBlock( int64_t blockLength, int64_t bytesUsed );
+
+        /// Size in bases of the next block.
+        int64_t blockSize() const;
+
+        /// Size in bases of the bites the next block is read in. Bites are kept to a small part of the target, so
+        /// that a block that turns out to be denser than expected stops close to its memory limit.
+        int64_t biteSize() const;
+
+        /// Estimated bytes used per base, or zero before any block has been recorded.
+        double bytesPerBase() const { return m_bytesPerBase; }
+
+    private:
+        const int64_t m_maxBlockSize;
+        const int64_t m_maxBiteSize;
+        const int64_t m_targetBytes;
+        double m_bytesPerBase;
+    };
+}
+}
+
+#endif
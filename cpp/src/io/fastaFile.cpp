@@ -1,5 +1,6 @@
 // All content Copyright (C) 2018 Genomics plc
 #include "io/fastaFile.hpp"
+#include "io/referenceStore.hpp"
 #include "utils/exceptions.hpp"
 #include "utils/referenceSequence.hpp"
 
@@ -70,6 +71,8 @@ namespace io
             {
                 m_standardContigs.push_back( refName );
             }
+            const utils::Interval contigInterval( 0L, seqLength );
+            m_contigs.emplace( refName, contigInterval ).first->second = contigInterval;
         }
     }
 
@@ -84,119 +87,54 @@ namespace io
         return it->second;
     }
 
-    std::map< std::string, utils::Interval > FastaIndex::contigs() const
-    {
-        std::map< std::string, utils::Interval > contigs;
-        for ( const auto & contigMapPair : m_contigMap )
-        {
-            const auto contigName = contigMapPair.first;
-            contigs.insert( std::make_pair( contigName, utils::Interval( 0L, this->getContigLength( contigName ) ) ) );
-        }
-        return contigs;
-    }
-
     //-----------------------------------------------------------------------------------------
     // Implementation of FastaFile functions.
     //-----------------------------------------------------------------------------------------
 
     FastaFile::FastaFile( const std::string & fileName )
-        : m_cacheSequence( nullptr ),
-          m_file( fileName.c_str() ),
-          m_indexFile( fastaIndexFileName( fileName ) ),
-          m_timer( std::make_shared< utils::Timer >( "IO", utils::fileMetaData( fileName ) ) )
+        : FastaFile( std::make_shared< const ReferenceStore >(
+              fileName, std::make_shared< const FastaIndex >( fastaIndexFileName( fileName ) ) ) )
     {
-        if ( not( m_file.is_open() ) )
-        {
-            throw utils::wecall_exception( "Could not open FASTA file" );
-        }
     }
 
-    //-----------------------------------------------------------------------------------------
-
-    std::pair< int64_t, int64_t > FastaFile::computeStartAndEndPosOfSequenceInFile(
-        const caller::Region & region ) const
+    FastaFile::FastaFile( std::shared_ptr< const ReferenceStore > store )
+        : m_store( store ),
+          m_timer( std::make_shared< utils::Timer >( "IO", utils::fileMetaData( store->fileName() ) ) )
     {
-
-        const auto theTuple = m_indexFile.getIndexTuple( region.contig() );
-
-        const auto contigInterval = utils::Interval( 0L, this->m_indexFile.getContigLength( region.contig() ) );
-
-        WECALL_ASSERT( contigInterval.contains( region.interval() ),
-                        "Region " + region.toString() + " is not valid as not contained contig" );
-
-        const auto nEndOfLineBytesBeforeStart =
-            ( ( theTuple->m_fullLineLength - theTuple->m_lineLength ) * region.start() ) / theTuple->m_lineLength;
-        const auto nEndOfLineBytesBeforeEnd =
-            ( ( theTuple->m_fullLineLength - theTuple->m_lineLength ) * region.end() ) / theTuple->m_lineLength;
-
-        const auto seqStartPosInFile =
-            theTuple->m_startPos + std::max( int64_t( 0 ), region.start() ) + nEndOfLineBytesBeforeStart;
-        const auto seqEndPosInFile =
-            theTuple->m_startPos + std::min( theTuple->m_seqLength, region.end() ) + nEndOfLineBytesBeforeEnd;
-
-        return std::make_pair( seqStartPosInFile, seqEndPosInFile );
     }
 
+    const FastaIndex & FastaFile::indexFile() const { return m_store->indexFile(); }
+
     //-----------------------------------------------------------------------------------------
 
     void FastaFile::getPaddedSequenceFromFile( std::string * seq, const caller::Region & region ) const
     {
-        auto const contigLength = m_indexFile.getContigLength( region.contig() );
+        auto const contigLength = this->indexFile().getContigLength( region.contig() );
         const auto numPaddedLeft = std::max( -region.start(), 0L );
         const auto numPaddedRight = std::max( region.end() - contigLength, 0L );
         const auto unpaddedStartPos = region.start() + numPaddedLeft;
         const auto unpaddedEndPos = region.end() - numPaddedRight;
 
+        seq->reserve( int64_to_sizet( region.size() ) );
         seq->append( int64_to_sizet( numPaddedLeft ), constants::gapChar );
         const caller::Region unpaddedRegion( region.contig(), unpaddedStartPos, unpaddedEndPos );
 
         {
             utils::ScopedTimerTrigger scopedTimerTrigger( m_timer );
-            // Retrieve the specified sequence from the FASTA file, and cache it to a
-            // string buffer.
-            const auto fileStartEnd = computeStartAndEndPosOfSequenceInFile( unpaddedRegion );
-
-            const int64_t bufferSize = fileStartEnd.second - fileStartEnd.first;
-            auto tempBuffer = std::unique_ptr< char[] >( new char[bufferSize] );
-
-            m_file.seekg( fileStartEnd.first );
-            m_file.read( tempBuffer.get(), bufferSize );
-
-            for ( int64_t i = 0; i < bufferSize; ++i )
-            {
-                const char theChar = tempBuffer[i];
-
-                if ( theChar != '\n' )
-                {
-                    seq->push_back( std::toupper( theChar ) );
-                }
-            }
+            m_store->appendSequence( unpaddedRegion, *seq );
         }
         seq->append( int64_to_sizet( numPaddedRight ), constants::gapChar );
     }
 
     //-----------------------------------------------------------------------------------------
 
-    void FastaFile::cacheSequence( const caller::Region & region )
-    {
-        std::string cache;
-        this->getPaddedSequenceFromFile( &cache, region );
-
-        m_cacheSequence = std::make_shared< utils::ReferenceSequence >( region, cache );
-    }
+    void FastaFile::cacheSequence( const caller::Region & region ) const { m_store->prefetch( region ); }
 
     utils::ReferenceSequence FastaFile::getSequence( const caller::Region & region ) const
     {
-        if ( m_cacheSequence != nullptr and m_cacheSequence->region().contains( region ) )
-        {
-            return m_cacheSequence->subseq( region );
-        }
-        else
-        {
-            std::string seq;
-            this->getPaddedSequenceFromFile( &seq, region );
-            return utils::ReferenceSequence( region, seq );
-        }
+        std::string seq;
+        this->getPaddedSequenceFromFile( &seq, region );
+        return utils::ReferenceSequence( region, seq );
     }
 
     //-----------------------------------------------------------------------------------------
@@ -96,7 +96,7 @@ namespace io
             return this->getIndexTuple( refName )->m_seqLength;
         }
 
-        std::map< std::string, utils::Interval > contigs() const;
+        const std::map< std::string, utils::Interval > & contigs() const { return m_contigs; }
 
     private:
         /// Read the index file and extract information about the size and location in the FASTA
@@ -106,14 +106,17 @@ namespace io
         void parseContigInfoFromFile( ifstream & theFile );
 
         contigMap_t m_contigMap;
+        std::map< std::string, utils::Interval > m_contigs;
 
         std::vector< std::string > m_standardContigs;  ///< _ordered_ set of standard contigs
 
         utils::timerPtr_t m_timer;
     };
 
-    /// A representation of a FASTA file. Maintains an in-memory cache of a large chunk
-    /// of sequence, which makes sequence retrieval much faster than reading from the file each time.
+    class ReferenceStore;
+
+    /// A representation of a FASTA file. Sequences are read from a ReferenceStore, which may be shared with other
+    /// readers of the file.
     class FastaFile
     {
     public:
@@ -122,32 +125,25 @@ namespace io
         /// @param fileName The name of the FASTA file to read
         explicit FastaFile( const std::string & fileName );
 
+        /// Construct a reader of a FASTA file that has already been loaded, e.g. one shared by all jobs.
+        explicit FastaFile( std::shared_ptr< const ReferenceStore > store );
+
         /// Return a string of the reference sequence. If ends positions are outside of the reference, pad with "N"
         /// characters
         utils::ReferenceSequence getSequence( const caller::Region & region ) const;
 
-        /// Set the internal cache to store the sequence of region.
+        /// Start loading the sequence of region, which is about to be read.
         ///
-        /// @param region The genomic (0-indexed) region to be cached.
-        void cacheSequence( const caller::Region & region );
+        /// @param region The genomic (0-indexed) region to be read.
+        void cacheSequence( const caller::Region & region ) const;
 
-        const FastaIndex & indexFile() const { return m_indexFile; }
+        const FastaIndex & indexFile() const;
 
     private:
         void getPaddedSequenceFromFile( std::string * seq, const caller::Region & region ) const;
 
-        /// Compute and return, by reference, the start and end positions, in the FASTA file,
-        /// of the specified sequence.
-        ///
-        /// @param region The genomic region of the sequence
-        /// @return The start and end positions in the file.
-        std::pair< int64_t, int64_t > computeStartAndEndPosOfSequenceInFile( const caller::Region & region ) const;
-
     private:
-        utils::referenceSequencePtr_t m_cacheSequence;
-        mutable ifstream m_file;
-
-        FastaIndex m_indexFile;
+        std::shared_ptr< const ReferenceStore > m_store;
 
         utils::timerPtr_t m_timer;
     };
@@ -10,6 +10,7 @@ extern "C" {
 }
 
 #include "io/pysam.hpp"
+#include "io/bgzfReader.hpp"
 
 // #######################################################
 // utility routines to avoid using callbacks in bam_fetch
@@ -105,6 +106,52 @@ static inline int is_overlap( uint32_t beg, uint32_t end, const bam1_t * b )
 
 //-------------------------------------------------------------------------------------------------
 
+// as bam_read1 in bam.c, reading through the decoder pool rather than samtools' BGZF handle
+static int bam_read1_from_reader( wecall::io::BgzfReader * reader, bam1_t * b )
+{
+    assert( not bam_is_be );
+
+    bam1_core_t * c = &b->core;
+    int32_t block_len;
+    uint32_t x[8];
+
+    const auto ret = reader->read( &block_len, 4 );
+    if ( ret != 4 )
+    {
+        return ret == 0 ? -1 : -2;  // normal end-of-file or truncated
+    }
+    if ( reader->read( x, BAM_CORE_SIZE ) != BAM_CORE_SIZE )
+    {
+        return -3;
+    }
+    c->tid = x[0];
+    c->pos = x[1];
+    c->bin = x[2] >> 16;
+    c->qual = x[2] >> 8 & 0xff;
+    c->l_qname = x[2] & 0xff;
+    c->flag = x[3] >> 16;
+    c->n_cigar = x[3] & 0xffff;
+    c->l_qseq = x[4];
+    c->mtid = x[5];
+    c->mpos = x[6];
+    c->isize = x[7];
+    b->data_len = block_len - BAM_CORE_SIZE;
+    if ( b->m_data < b->data_len )
+    {
+        b->m_data = b->data_len;
+        kroundup32( b->m_data );
+        b->data = (uint8_t *)realloc( b->data, b->m_data );
+    }
+    if ( reader->read( b->data, b->data_len ) != std::size_t( b->data_len ) )
+    {
+        return -4;
+    }
+    b->l_aux = b->data_len - c->n_cigar * 4 - c->l_qname - c->l_qseq - ( c->l_qseq + 1 ) / 2;
+    return 4 + block_len;
+}
+
+//-------------------------------------------------------------------------------------------------
+
 struct __bam_fetch_iterator_t
 {
     bam1_t * b;
@@ -112,7 +159,7 @@ struct __bam_fetch_iterator_t
     int n_off;
     uint64_t curr_off;
     int curr_chunk;
-    bamFile fp;
+    wecall::io::BgzfReader * reader;
     int tid;
     int beg;
     int end;
@@ -121,7 +168,11 @@ struct __bam_fetch_iterator_t
 
 //-------------------------------------------------------------------------------------------------
 
-bam_fetch_iterator_t * bam_init_fetch_iterator( bamFile fp, const bam_index_t * idx, int tid, int beg, int end )
+bam_fetch_iterator_t * bam_init_fetch_iterator( wecall::io::BgzfReader * reader,
+                                                const bam_index_t * idx,
+                                                int tid,
+                                                int beg,
+                                                int end )
 {
     // iterator contains current alignment position
     //      and will contain actual alignment during iterations
@@ -132,7 +183,7 @@ bam_fetch_iterator_t * bam_init_fetch_iterator( bamFile fp, const bam_index_t *
     iter->off = get_chunk_coordinates( idx, tid, beg, end, &iter->n_off );
 
     // initialise other state variables in iterator
-    iter->fp = fp;
+    iter->reader = reader;
     iter->curr_chunk = -1;
     iter->curr_off = 0;
     iter->n_seeks = 0;
@@ -170,15 +221,16 @@ bam1_t * bam_fetch_iterate( bam_fetch_iterator_t * iter )
             if ( iter->curr_chunk < 0 || iter->off[iter->curr_chunk].v != iter->off[iter->curr_chunk + 1].u )
             {
                 // not adjacent chunks; then seek
-                bam_seek( iter->fp, iter->off[iter->curr_chunk + 1].u, SEEK_SET );
-                iter->curr_off = bam_tell( iter->fp );
+                iter->reader->seek( iter->off[iter->curr_chunk + 1].u );
+                iter->curr_off = iter->reader->tell();
                 ++iter->n_seeks;
             }
             ++iter->curr_chunk;
+            iter->reader->setReadAheadLimit( iter->off[iter->curr_chunk].v );
         }
-        if ( bam_read1( iter->fp, iter->b ) > 0 )
+        if ( bam_read1_from_reader( iter->reader, iter->b ) > 0 )
         {
-            iter->curr_off = bam_tell( iter->fp );
+            iter->curr_off = iter->reader->tell();
             if ( iter->b->core.tid != iter->tid || iter->b->core.pos >= iter->end )
             {
                 // no need to proceed
@@ -25,6 +25,14 @@
   @field  curr_chunk  The item in a list of chunk
   @discussion See also bam_fetch_iterate
 */
+namespace wecall
+{
+namespace io
+{
+    class BgzfReader;
+}
+}
+
 struct __bam_fetch_iterator_t;
 typedef struct __bam_fetch_iterator_t bam_fetch_iterator_t;
 
@@ -34,13 +42,17 @@ typedef struct __bam_fetch_iterator_t bam_fetch_iterator_t;
 
   @discussion Returns iterator object to retrieve successive alignments ordered by
   start position.
-  @param  fp    BAM file handler
+  @param  reader  reader of the BAM file
   @param  idx   pointer to the alignment index
   @param  tid   chromosome ID as is defined in the header
   @param  beg   start coordinate, 0-based
   @param  end   end coordinate, 0-based
 */
-bam_fetch_iterator_t * bam_init_fetch_iterator( bamFile fp, const bam_index_t * idx, int tid, int beg, int end );
+bam_fetch_iterator_t * bam_init_fetch_iterator( wecall::io::BgzfReader * reader,
+                                                const bam_index_t * idx,
+                                                int tid,
+                                                int beg,
+                                                int end );
 void bam_cleanup_fetch_iterator( bam_fetch_iterator_t * iter );
 
 /*!
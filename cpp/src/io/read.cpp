@@ -8,6 +8,7 @@
 #include "read.hpp"
 
 #include <cstdlib>
+#include <cstring>
 #include <stdexcept>
 #include <iostream>
 #include <utility>
@@ -24,59 +25,68 @@ namespace io
     using alignment::cigarFlags;
 
     uint8_t * pysam_bam1_qname( const bam1_t * b ) { return (uint8_t *)( b->data ); }
-    // Look-up table for BAM sequence characters
-    static const char * bamTable = "=ACMGRSVTWYHKDBN";
 
-    //-----------------------------------------------------------------------------------------
-
-    Read::ReadParams::ReadParams( const bam1_t * bamRecord )
-        : m_qualities( int32_to_sizet( bamRecord->core.l_qseq ), 0 ),
-          m_cigar( bamRecord->core.n_cigar, pysam_bam1_cigar( bamRecord ) ),
-          m_tid( bamRecord->core.tid ),
-          m_startPos( bamRecord->core.pos ),
-          m_endPos( m_startPos + bamRecord->core.l_qseq ),
-          m_flag( bamRecord->core.flag ),
-          m_mappingQuality( bamRecord->core.qual ),
-          m_insertSize( bamRecord->core.isize ),
-          m_mateTid( bamRecord->core.mtid ),
-          m_mateStartPos( bamRecord->core.mpos )
+    namespace
     {
+        // Look-up table for BAM sequence characters
+        const char * bamTable = "=ACMGRSVTWYHKDBN";
 
-        const unsigned char * qname_start = pysam_bam1_qname( bamRecord );
-        m_qname.assign( qname_start, qname_start + bamRecord->core.l_qname - 1 );
-
-        const uint8_t * readGroupTag = bam_aux_get( bamRecord, "RG" );
-
-        if ( readGroupTag )
+        /// The two bases encoded by each byte of a BAM sequence.
+        struct BasePairTable
         {
-            m_readGroupID = bam_aux2Z( readGroupTag );
-        }
+            BasePairTable()
+            {
+                for ( std::size_t byte = 0; byte < 256; ++byte )
+                {
+                    pairs[byte][0] = bamTable[byte >> 4];
+                    pairs[byte][1] = bamTable[byte & 0xf];
+                }
+            }
 
-        const unsigned char * p = pysam_bam1_seq( bamRecord );
-        const unsigned char * q = pysam_bam1_qual( bamRecord );
+            char pairs[256][2];
+        };
 
-        std::string sequenceStr( int32_to_sizet( bamRecord->core.l_qseq ), ' ' );
+        const BasePairTable basePairTable;
 
-        auto end = sequenceStr.end();
-        auto evenEnd = sequenceStr.size() % 2 ? end - 1 : end;
-        auto seqIt = sequenceStr.begin();
-        std::copy( q, q + sequenceStr.size(), m_qualities.begin() );
+        /// Strings of up to this many characters are kept inside the string object.
+        const std::size_t shortStringCapacity = 15;
 
-        for ( ; seqIt != evenEnd; p++ )
+        std::size_t allocatedStringBytes( const std::size_t capacity )
         {
-            *( seqIt++ ) = bamTable[( *p >> 4 ) & 0xf];
-            *( seqIt++ ) = bamTable[*p & 0xf];
+            return capacity > shortStringCapacity ? capacity + 1 : 0;
         }
-        if ( seqIt != end )
-            *seqIt = bamTable[( *p >> 4 ) & 0xf];
 
-        m_sequenceStr = sequenceStr;
-        if ( sequenceStr.size() == 0 || q[0] == 0xff )
+        /// Whether the 4-bit bases equal the sequence starting at reference, without decoding them first.
+        bool packedBasesEqual( const uint8_t * packedBases,
+                               const std::size_t nBases,
+                               utils::BasePairSequence::const_iterator reference )
         {
-            throw utils::wecall_exception( "Invalid bamRecord in Read constructor" );
+            for ( std::size_t byteIndex = 0; byteIndex < nBases / 2; ++byteIndex, reference += 2 )
+            {
+                const auto & pair = basePairTable.pairs[packedBases[byteIndex]];
+                if ( pair[0] != reference[0] or pair[1] != reference[1] )
+                {
+                    return false;
+                }
+            }
+            return nBases % 2 == 0 or basePairTable.pairs[packedBases[nBases / 2]][0] == *reference;
         }
     }
 
+    void decodeBamBases( const uint8_t * packedBases, const std::size_t nBases, char * bases )
+    {
+        for ( std::size_t byteIndex = 0; byteIndex < nBases / 2; ++byteIndex, bases += 2 )
+        {
+            std::memcpy( bases, basePairTable.pairs[packedBases[byteIndex]], 2 );
+        }
+        if ( nBases % 2 != 0 )
+        {
+            *bases = basePairTable.pairs[packedBases[nBases / 2]][0];
+        }
+    }
+
+    //-----------------------------------------------------------------------------------------
+
     Read::ReadParams::ReadParams( std::string seq,
                                   utils::QualitySequence qual,
                                   std::string readGroupID,
@@ -152,8 +162,47 @@ namespace io
     }
 
     Read::Read( const bam1_t * bamRecord, utils::referenceSequencePtr_t refSequence )
-        : Read( Read::ReadParams( bamRecord ), refSequence )
+        : m_sequence(),
+          m_qualities( pysam_bam1_qual( bamRecord ), pysam_bam1_qual( bamRecord ) + bamRecord->core.l_qseq ),
+          m_qname( reinterpret_cast< const char * >( pysam_bam1_qname( bamRecord ) ),
+                   int32_to_sizet( bamRecord->core.l_qname - 1 ) ),
+          m_readGroupID(),
+          m_cigar( bamRecord->core.n_cigar, pysam_bam1_cigar( bamRecord ) ),
+          m_tid( bamRecord->core.tid ),
+          m_startPos( bamRecord->core.pos ),
+          m_endPos( m_startPos + bamRecord->core.l_qseq ),
+          m_alignedEndPos( m_startPos + m_cigar.lengthInRef() ),
+          m_insertSize( bamRecord->core.isize ),
+          m_mateTid( bamRecord->core.mtid ),
+          m_mateStartPos( bamRecord->core.mpos ),
+          m_refSequence( refSequence ),
+          m_flag( bamRecord->core.flag ),
+          m_mappingQuality( bamRecord->core.qual )
     {
+        const auto nBases = int32_to_sizet( bamRecord->core.l_qseq );
+        if ( nBases == 0 || pysam_bam1_qual( bamRecord )[0] == 0xff )
+        {
+            throw utils::wecall_exception( "Invalid bamRecord in Read constructor" );
+        }
+
+        const uint8_t * readGroupTag = bam_aux_get( bamRecord, "RG" );
+        if ( readGroupTag )
+        {
+            m_readGroupID = bam_aux2Z( readGroupTag );
+        }
+
+        const uint8_t * packedBases = pysam_bam1_seq( bamRecord );
+        if ( m_endPos == m_alignedEndPos )
+        {
+            m_isReference = packedBasesEqual( packedBases, nBases, getRefSequenceRange().first );
+        }
+
+        if ( not m_isReference )
+        {
+            std::string bases( nBases, ' ' );
+            decodeBamBases( packedBases, nBases, &bases[0] );
+            const_cast< utils::BasePairSequence & >( m_sequence ) = utils::BasePairSequence( std::move( bases ) );
+        }
     }
 
     utils::BasePairSequence Read::makeRefSequence() const
@@ -223,6 +272,13 @@ namespace io
         return repr.str();
     }
 
+    std::size_t Read::allocatedBytes() const
+    {
+        return allocatedStringBytes( m_sequence.capacity() ) + allocatedStringBytes( m_qualities.capacity() ) +
+               allocatedStringBytes( m_qname.capacity() ) + allocatedStringBytes( m_readGroupID.capacity() ) +
+               m_cigar.size() * sizeof( alignment::cigarItem_t );
+    }
+
     utils::Interval Read::getMaximalReadInterval() const
     {
         const auto readRefStartPos = this->getStartPos();
@@ -21,6 +21,13 @@ namespace io
     class Read;
     using readPtr_t = std::shared_ptr< Read >;
 
+    /// Decode the 4-bit bases of a BAM record into characters, two bases per byte.
+    ///
+    /// @param packedBases The sequence of a BAM record, first base in the high nibble.
+    /// @param nBases Number of bases to decode.
+    /// @param bases Output, at least nBases long.
+    void decodeBamBases( const uint8_t * packedBases, std::size_t nBases, char * bases );
+
     /// The Read class represents a sequence read that has been mapped and aligned to a
     /// reference genome.
     class Read
@@ -30,7 +37,6 @@ namespace io
         {
         public:
             ReadParams();
-            ReadParams( const bam1_t * bamRecord );
 
             ReadParams( std::string seq,
                         utils::QualitySequence qual,
@@ -64,7 +70,8 @@ namespace io
 
         Read( const ReadParams & params, utils::referenceSequencePtr_t refSequence );
 
-        /// Construct a Read from a Samtools BAM record
+        /// Construct a Read from a Samtools BAM record. The bases are decoded straight from the 4-bit BAM encoding,
+        /// and only if the read differs from the reference.
         ///
         /// @param a Samtools BAM record
         Read( const bam1_t * bamRecord, utils::referenceSequencePtr_t refSequence );
@@ -101,14 +108,24 @@ namespace io
         /// Return a string representation of this read
         std::string toString() const;
 
-        /// Return the sequence of As, Cs, Ts and Gs
+        /// Bytes of memory allocated for the members of this read, not counting the Read object itself.
+        std::size_t allocatedBytes() const;
+
+        /// Return the sequence of As, Cs, Ts and Gs. The sequence of a read that matches the reference is built on
+        /// first use, so reads shared between threads must have had buildSequence() called on them first.
         const utils::BasePairSequence & sequence() const
+        {
+            this->buildSequence();
+            return m_sequence;
+        }
+
+        /// Build the sequence of a read that matches the reference, if it has not been built yet.
+        void buildSequence() const
         {
             if ( m_sequence.size() == 0 and m_isReference )
             {
                 const_cast< utils::BasePairSequence & >( m_sequence ) = makeRefSequence();
             }
-            return m_sequence;
         }
 
         /// Return the unique name (usually refered to as qname) of the read.
@@ -245,7 +262,7 @@ namespace io
         getRefSequenceRange() const;
 
     private:
-        const utils::BasePairSequence m_sequence;
+        utils::BasePairSequence m_sequence;
         utils::QualitySequence m_qualities;
         std::string m_qname;
         std::string m_readGroupID;
@@ -0,0 +1,37 @@
+// All content Copyright (C) 2018 Genomics plc
+#include "io/readArena.hpp"
+
+namespace wecall
+{
+namespace io
+{
+    constexpr std::size_t ReadArena::readsPerChunk;
+
+    ReadArena::ReadArena() : m_nReads( 0 ), m_readBytes( 0 ) {}
+
+    ReadArena::~ReadArena()
+    {
+        for ( std::size_t readIndex = 0; readIndex < m_nReads; ++readIndex )
+        {
+            auto & storage = m_chunks[readIndex / readsPerChunk][readIndex % readsPerChunk];
+            reinterpret_cast< Read * >( &storage )->~Read();
+        }
+    }
+
+    readPtr_t ReadArena::makeRead( Read && read )
+    {
+        if ( m_nReads == m_chunks.size() * readsPerChunk )
+        {
+            m_chunks.emplace_back( new readStorage_t[readsPerChunk] );
+        }
+
+        auto & storage = m_chunks.back()[m_nReads % readsPerChunk];
+        const auto storedRead = new ( &storage ) Read( std::move( read ) );
+        ++m_nReads;
+        m_readBytes += storedRead->allocatedBytes();
+
+        // Aliasing constructor: the handle points at the read and keeps the arena alive.
+        return readPtr_t( this->shared_from_this(), storedRead );
+    }
+}
+}
@@ -0,0 +1,55 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef READ_ARENA_HPP
+#define READ_ARENA_HPP
+
+#include "io/read.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace wecall
+{
+namespace io
+{
+    /// Storage for the reads of one block. Reads are constructed in chunks of many reads rather than with an
+    /// allocation each, and are all destroyed together with the arena. The handles it gives out share ownership
+    /// of the whole arena instead of having a reference count of their own, so a read stays valid for as long as
+    /// anything still holds on to it.
+    class ReadArena : public std::enable_shared_from_this< ReadArena >
+    {
+    public:
+        ReadArena();
+        ~ReadArena();
+
+        ReadArena( const ReadArena & rhs ) = delete;
+        ReadArena & operator=( const ReadArena & ) = delete;
+
+        /// Move a read into the arena. Reads are filtered before they are stored, as the arena only frees
+        /// them all at once.
+        readPtr_t makeRead( Read && read );
+
+        /// Number of reads constructed in the arena.
+        std::size_t size() const { return m_nReads; }
+
+        /// Bytes of memory held by the arena and the reads in it.
+        std::size_t bytesUsed() const
+        {
+            return m_chunks.size() * readsPerChunk * sizeof( readStorage_t ) + m_readBytes;
+        }
+
+    private:
+        using readStorage_t = std::aligned_storage< sizeof( Read ), alignof( Read ) >::type;
+        static constexpr std::size_t readsPerChunk = 1024;
+
+        std::vector< std::unique_ptr< readStorage_t[] > > m_chunks;
+        std::size_t m_nReads;
+        std::size_t m_readBytes;
+    };
+
+    using readArenaPtr_t = std::shared_ptr< ReadArena >;
+}
+}
+
+#endif
@@ -15,7 +15,7 @@ namespace io
         for ( const std::string & sourceName : dataSources )
         {
             WECALL_LOG( DEBUG, "Adding data source " << sourceName << " to read dataset" );
-            addDataSource( std::make_shared< BamFile >( sourceName ) );
+            addDataSource( std::make_shared< BamFile >( sourceName, m_decompressionThreads ) );
         }
     }
 
@@ -42,6 +42,17 @@ namespace io
 
     //-----------------------------------------------------------------------------------------
 
+    void ReadDataReader::setMemoryBudget( utils::memoryBudgetPtr_t budget )
+    {
+        m_memoryBudget = budget;
+        if ( budget != nullptr )
+        {
+            m_memLimit = std::min( m_memLimit, budget->limit() );
+        }
+    }
+
+    //-----------------------------------------------------------------------------------------
+
     ReadDataReader::BlockIterator ReadDataReader::readRegion( const caller::Region & region,
                                                               utils::referenceSequencePtr_t refSequence )
     {
@@ -50,76 +61,164 @@ namespace io
 
     //-----------------------------------------------------------------------------------------
 
+    ReadDataReader::BlockIterator::BlockIterator( const ReadDataReader * reader,
+                                                  const caller::Region & region,
+                                                  utils::referenceSequencePtr_t refSequence )
+        : m_reader( reader ),
+          m_refSequence( refSequence ),
+          m_region( region ),
+          m_curPos( region.start() ),
+          // Aim below the point at which a block is cut short. A prefetched block shares the limit with the block
+          // being called.
+          m_blockSizeController(
+              reader->m_maxBlockSize,
+              reader->m_biteSize,
+              static_cast< int64_t >( ( reader->m_prefetchReads ? 0.4 : 0.8 ) * reader->m_memLimit ) ),
+          m_blockLength( 0 ),
+          m_blockBytes( 0 )
+    {
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    ReadDataReader::BlockIterator::~BlockIterator() { this->cancelPrefetch(); }
+
+    //-----------------------------------------------------------------------------------------
+
     readDataset_t ReadDataReader::BlockIterator::getReadDatasetForNextBlock()
     {
+        this->recordBlockMemory();
+
         if ( m_curPos >= m_region.end() )
         {
+            this->cancelPrefetch();
             return nullptr;
         }
 
-        m_memUsed = 0;
+        int64_t memUsed = 0;
+        auto dataset = this->takePrefetchedBlock( memUsed );
+        if ( dataset == nullptr )
+        {
+            const caller::Region remainingRegion( m_region.contig(), m_curPos, m_region.end() );
+            dataset = readBlock( m_reader, m_refSequence, remainingRegion, m_blockSizeController.blockSize(),
+                                 m_blockSizeController.biteSize(), m_blockSizeController.bytesPerBase(), memUsed,
+                                 nullptr );
+        }
+
+        m_curPos = dataset->region().end();
+        m_blockLength = dataset->region().size();
+        m_blockBytes = dataset->bytesUsed();
+
+        if ( m_reader->m_prefetchReads and m_curPos < m_region.end() )
+        {
+            this->startPrefetch( memUsed );
+        }
+
+        return dataset;
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    readDataset_t ReadDataReader::BlockIterator::readBlock( const ReadDataReader * reader,
+                                                            const utils::referenceSequencePtr_t & refSequence,
+                                                            const caller::Region & remainingRegion,
+                                                            const int64_t maxBlockSize,
+                                                            const int64_t biteSize,
+                                                            const double bytesPerBase,
+                                                            int64_t & memUsed,
+                                                            Prefetch * prefetch )
+    {
+        memUsed = 0;
+        int64_t lastBiteBytes = 0;
 
-        int64_t blockStart = m_curPos;
-        int64_t nBlocksRemaining = ( ( m_region.end() - m_curPos - 1 ) / m_reader->m_maxBlockSize ) + 1;
-        int64_t blockEnd = m_curPos + ( m_region.end() - m_curPos ) / nBlocksRemaining;
+        int64_t curPos = remainingRegion.start();
+        int64_t blockStart = curPos;
+        int64_t nBlocksRemaining = ( ( remainingRegion.end() - curPos - 1 ) / maxBlockSize ) + 1;
+        int64_t blockEnd = curPos + ( remainingRegion.end() - curPos ) / nBlocksRemaining;
 
-        const caller::Region blockRegion( m_region.contig(), blockStart, blockEnd );
-        auto dataset = std::make_shared< ReadDataset >( m_reader->getSampleNames(), blockRegion );
+        const caller::Region blockRegion( remainingRegion.contig(), blockStart, blockEnd );
+        auto dataset = std::make_shared< ReadDataset >( reader->getSampleNames(), blockRegion );
+        dataset->memoryReservation() = utils::MemoryReservation( reader->m_memoryBudget );
 
         std::vector< bamFileIteratorPtr_t > iterators;
         const auto paddedBlockRegion = blockRegion.getPadded( constants::bamFetchRegionPadding );
-        for ( auto dataSource : m_reader->m_dataSources )
+        for ( auto dataSource : reader->m_dataSources )
         {
-            auto bamFileIterator = dataSource->readRegion( paddedBlockRegion, m_refSequence );
+            auto bamFileIterator = dataSource->readRegion( paddedBlockRegion, refSequence );
             if ( bamFileIterator != nullptr )
             {
                 iterators.push_back( bamFileIterator );
             }
         }
 
-        while ( m_curPos < blockEnd )
+        while ( curPos < blockEnd )
         {
-            auto biteToPos = std::min( blockEnd, m_curPos + m_reader->m_biteSize );
-            readMap_t readData = this->takeBite( iterators, biteToPos );
+            if ( prefetch != nullptr and not waitForMemory( reader, prefetch, memUsed ) )
+            {
+                return nullptr;
+            }
+
+            auto biteToPos = std::min( blockEnd, curPos + biteSize );
+
+            // The learnt bytes per base include calling, so reserve for that too, but no less than the last bite.
+            const auto biteBytes = std::max( static_cast< int64_t >( bytesPerBase * ( biteToPos - curPos ) ),
+                                             lastBiteBytes );
+            if ( not reserveBite( *dataset, biteBytes, curPos > blockStart, prefetch ) )
+            {
+                if ( curPos == blockStart )
+                {
+                    return nullptr;
+                }
+                WECALL_LOG( DEBUG, "Ending block early as the memory budget shared by all jobs is in use" );
+                break;
+            }
+
+            const auto memUsedBeforeBite = memUsed;
+            auto readData = takeBite( reader, iterators, biteToPos, memUsed );
 
             // If we reached full taking this bite, discard it and consider the block complete after last bite.
-            if ( this->isFull() )
+            if ( isFull( reader, memUsed ) )
             {
                 break;
             }
 
-            for ( const auto & sampleReads : readData )
+            // Only the reads that pass the filters are moved into the arena, which cannot free the others.
+            for ( auto & sampleReads : readData )
             {
-                //                    filtered_reads = m_readFilterAndTrimmer.filter(sampleReads.second);
-                for ( const auto read : sampleReads.second )
+                for ( auto & read : sampleReads.second )
                 {
-                    if ( m_reader->m_readFilterAndTrimmer.trimAndFilter( read ) )
+                    if ( reader->m_readFilterAndTrimmer.trimAndFilter( read ) )
                     {
-                        dataset->insertRead( sampleReads.first, read );
+                        dataset->insertRead( sampleReads.first, dataset->arena().makeRead( std::move( read ) ) );
                     }
                 }
             }
-            m_curPos = biteToPos;
+
+            // The bite was measured with the reads the filters rejected, but only those kept still use memory.
+            memUsed = dataset->bytesUsed();
+            curPos = biteToPos;
+            lastBiteBytes = memUsed - memUsedBeforeBite;
+            dataset->memoryReservation().growTo( memUsed );
 
             // Special case - continue if some capacity and only a wafer thin mint left to digest!
-            if ( this->isAlmostFull() and ( m_region.end() - m_curPos ) > m_reader->m_biteSize )
+            if ( isAlmostFull( reader, memUsed ) and ( remainingRegion.end() - curPos ) > biteSize )
             {
                 break;
             }
         }
 
-        if ( m_curPos == blockStart )
+        if ( curPos == blockStart )
         {
             // Couldn't manage a single bite - skip block and log a WARNING.
-            m_curPos = std::min( blockEnd, m_curPos + m_reader->m_biteSize );
-            blockEnd = m_curPos;
-            WECALL_LOG( WARNING, "Skipping region " << caller::Region( m_region.contig(), blockStart, m_curPos )
+            curPos = std::min( blockEnd, curPos + biteSize );
+            blockEnd = curPos;
+            WECALL_LOG( WARNING, "Skipping region " << caller::Region( remainingRegion.contig(), blockStart, curPos )
                                                      << " due to exceptionally high coverage" );
         }
-        else if ( m_curPos < blockEnd )
+        else if ( curPos < blockEnd )
         {
             // Couldn't finish the whole meal - redefine block and log this INFO.
-            blockEnd = m_curPos;
+            blockEnd = curPos;
             WECALL_LOG( DEBUG, "Reducing block size due to high coverage in this region" );
         }
 
@@ -129,37 +228,158 @@ namespace io
 
     //-----------------------------------------------------------------------------------------
 
-    readMap_t ReadDataReader::BlockIterator::takeBite( std::vector< bamFileIteratorPtr_t > iterators,
-                                                       int64_t biteToPos )
+    biteReads_t ReadDataReader::BlockIterator::takeBite( const ReadDataReader * reader,
+                                                         std::vector< bamFileIteratorPtr_t > iterators,
+                                                         int64_t biteToPos,
+                                                         int64_t & memUsed )
     {
-        readMap_t readMap;
+        biteReads_t biteReads;
         for ( auto iterator : iterators )
         {
             auto scopedTimerTrigger = iterator->timer();
             for ( ; iterator->hasReadData(); iterator->next() )
             {
-                auto sampleRead = iterator->getReadData();
-
-                std::string sampleName = sampleRead.first;
-                readPtr_t read = sampleRead.second;
-                if ( read->getStartPos() > biteToPos )
+                if ( iterator->startPos() > biteToPos )
                 {
                     // Gone past the end of the current bite for this sample move on to the next
                     break;
                 }
 
-                // Rough approximation
-                m_memUsed += ( ( read->getLength() * 2 ) + 100 );
-                if ( this->isFull() )
+                auto sampleRead = iterator->getReadData();
+                memUsed += static_cast< int64_t >( sizeof( Read ) + sampleRead.second.allocatedBytes() ) +
+                           ReadDataset::indexBytesPerRead;
+                if ( isFull( reader, memUsed ) )
                 {
-                    return readMap;
+                    return biteReads;
                 }
 
-                readMap[sampleName].push_back( read );
+                biteReads[sampleRead.first].push_back( std::move( sampleRead.second ) );
             }
         }
 
-        return readMap;
+        return biteReads;
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    bool ReadDataReader::BlockIterator::waitForMemory( const ReadDataReader * reader,
+                                                       Prefetch * prefetch,
+                                                       int64_t memUsed )
+    {
+        std::unique_lock< std::mutex > lock( prefetch->m_mutex );
+        prefetch->m_memReleased.wait( lock, [reader, prefetch, memUsed]()
+                                      {
+                                          return prefetch->m_cancelled or
+                                                 not isFull( reader, prefetch->m_memHeld + memUsed );
+                                      } );
+        return not prefetch->m_cancelled;
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    bool ReadDataReader::BlockIterator::reserveBite( ReadDataset & dataset,
+                                                     const int64_t bytes,
+                                                     const bool blockHasReads,
+                                                     Prefetch * prefetch )
+    {
+        auto & reservation = dataset.memoryReservation();
+        if ( blockHasReads )
+        {
+            return reservation.tryGrow( bytes );
+        }
+
+        return reservation.grow( bytes, [prefetch]()
+                                 {
+                                     if ( prefetch == nullptr )
+                                     {
+                                         return false;
+                                     }
+                                     std::lock_guard< std::mutex > lock( prefetch->m_mutex );
+                                     return prefetch->m_cancelled;
+                                 } );
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    void ReadDataReader::BlockIterator::startPrefetch( int64_t memHeld )
+    {
+        const caller::Region remainingRegion( m_region.contig(), m_curPos, m_region.end() );
+        m_prefetch.reset( new Prefetch( remainingRegion, memHeld ) );
+        m_prefetch->m_previousRead = m_reader->m_readFilterAndTrimmer.previousRead();
+
+        // The iterator may be moved while the block is read, so the thread only sees state that stays put.
+        const auto reader = m_reader;
+        const auto refSequence = m_refSequence;
+        const auto prefetch = m_prefetch.get();
+        const auto maxBlockSize = m_blockSizeController.blockSize();
+        const auto biteSize = m_blockSizeController.biteSize();
+        const auto bytesPerBase = m_blockSizeController.bytesPerBase();
+        m_prefetch->m_dataset =
+            std::async( std::launch::async, [reader, refSequence, prefetch, maxBlockSize, biteSize, bytesPerBase]()
+                        {
+                            return readBlock( reader, refSequence, prefetch->m_region, maxBlockSize, biteSize,
+                                              bytesPerBase, prefetch->m_memUsed, prefetch );
+                        } );
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    void ReadDataReader::BlockIterator::recordBlockMemory()
+    {
+        if ( m_blockLength == 0 )
+        {
+            return;
+        }
+
+        m_blockSizeController.recordBlock( m_blockLength, m_blockBytes );
+        WECALL_LOG( DEBUG, "Block of " << m_blockLength << " bases used " << m_blockBytes << " bytes, next block size "
+                                       << m_blockSizeController.blockSize() << " bases in bites of "
+                                       << m_blockSizeController.biteSize() );
+        m_blockLength = 0;
+        m_blockBytes = 0;
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    readDataset_t ReadDataReader::BlockIterator::takePrefetchedBlock( int64_t & memUsed )
+    {
+        if ( m_prefetch == nullptr )
+        {
+            return nullptr;
+        }
+
+        // The caller has finished with the previous block, so its reads no longer hold back the prefetch.
+        {
+            std::lock_guard< std::mutex > lock( m_prefetch->m_mutex );
+            m_prefetch->m_memHeld = 0;
+        }
+        m_prefetch->m_memReleased.notify_all();
+
+        const auto prefetch = std::move( m_prefetch );
+        const auto dataset = prefetch->m_dataset.get();
+        memUsed = prefetch->m_memUsed;
+        return dataset;
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    void ReadDataReader::BlockIterator::cancelPrefetch()
+    {
+        if ( m_prefetch == nullptr )
+        {
+            return;
+        }
+
+        {
+            std::lock_guard< std::mutex > lock( m_prefetch->m_mutex );
+            m_prefetch->m_cancelled = true;
+        }
+        m_prefetch->m_memReleased.notify_all();
+
+        // Errors reading a block that is no longer wanted are of no interest.
+        m_prefetch->m_dataset.wait();
+        m_reader->m_readFilterAndTrimmer.restorePreviousRead( m_prefetch->m_previousRead );
+        m_prefetch.reset();
     }
 
     //-----------------------------------------------------------------------------------------
@@ -173,6 +393,22 @@ namespace io
         WECALL_LOG( DEBUG, "Chopping current block at position: " << prematureBlockEnd
                                                                    << " to avoid breaking up a cluster of variants" );
         m_curPos = prematureBlockEnd;
+        if ( m_prefetch != nullptr and m_prefetch->m_region.start() != m_curPos )
+        {
+            this->cancelPrefetch();
+        }
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    void ReadDataReader::BlockIterator::truncateRegion( int64_t regionEnd )
+    {
+        WECALL_ASSERT( regionEnd >= m_curPos, "Can not truncate region before the next block" );
+        m_region = caller::Region( m_region.contig(), m_region.start(), std::min( m_region.end(), regionEnd ) );
+        if ( m_prefetch != nullptr and m_prefetch->m_region.end() != m_region.end() )
+        {
+            this->cancelPrefetch();
+        }
     }
 }
 }
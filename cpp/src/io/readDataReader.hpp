@@ -5,16 +5,27 @@
 #include "common.hpp"
 
 #include "io/bamFile.hpp"
+#include "io/blockSizeController.hpp"
 #include "io/readDataSet.hpp"
 #include "caller/params.hpp"
 #include "utils/logging.hpp"
 #include "caller/region.hpp"
+#include "utils/memoryBudget.hpp"
+
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
 
 namespace wecall
 {
 namespace io
 {
     using readMap_t = std::map< std::string, std::vector< readPtr_t > >;
+
+    /// Reads of one bite by sample, held until the bite is known to fit and its reads have been filtered.
+    using biteReads_t = std::map< std::string, std::vector< Read > >;
+
     /// Loads reads from multiple sources.
     class ReadDataReader
     {
@@ -24,33 +35,96 @@ namespace io
         public:
             BlockIterator( const ReadDataReader * reader,
                            const caller::Region & region,
-                           utils::referenceSequencePtr_t refSequence )
-                : m_reader( reader ),
-                  m_refSequence( refSequence ),
-                  m_region( region ),
-                  m_curPos( region.start() ),
-                  m_memUsed( 0 )
-            {
-            }
+                           utils::referenceSequencePtr_t refSequence );
 
-            /// Read in the next block of reads
+            BlockIterator( BlockIterator && rhs ) = default;
+
+            ~BlockIterator();
+
+            /// Read in the next block of reads. If prefetching is enabled the block after it is then read on a
+            /// background thread while the caller works on this one.
             ///
             /// @return read data set or NULL if no more reads.
             readDataset_t getReadDatasetForNextBlock();
             bool isLastBlock();
             void chopCurrentBlock( int64_t prematureBlockEnd );
 
+            /// Position at which the next block will start.
+            int64_t nextBlockStart() const { return m_curPos; }
+
+            /// Count memory allocated while calling the current block against it, so that the sizes of the blocks
+            /// after it allow for what calling them will take.
+            void addCallingBytes( int64_t bytes ) { m_blockBytes += bytes; }
+
+            /// Stop reading at regionEnd instead of the end of the region the iterator was created for.
+            void truncateRegion( int64_t regionEnd );
+
         private:
-            readMap_t takeBite( std::vector< bamFileIteratorPtr_t > iterators, int64_t biteToPos );
-            bool isFull() { return m_memUsed > m_reader->m_memLimit; }
-            bool isAlmostFull() { return m_memUsed > ( m_reader->m_memLimit * 0.8 ) and not this->isFull(); }
+            /// State shared with the background thread reading the next block. The reads of the block being
+            /// called count against the memory limit, so the background thread waits between bites until they
+            /// have been released.
+            struct Prefetch
+            {
+                Prefetch( const caller::Region & region, int64_t memHeld ) : m_region( region ), m_memHeld( memHeld )
+                {
+                }
+
+                std::future< readDataset_t > m_dataset;
+                caller::Region m_region;
+                int64_t m_memUsed = 0;
+                ReadFilterAndTrimmer::PreviousRead m_previousRead;
+
+                std::mutex m_mutex;
+                std::condition_variable m_memReleased;
+                int64_t m_memHeld = 0;
+                bool m_cancelled = false;
+            };
+
+            static readDataset_t readBlock( const ReadDataReader * reader,
+                                            const utils::referenceSequencePtr_t & refSequence,
+                                            const caller::Region & remainingRegion,
+                                            int64_t maxBlockSize,
+                                            int64_t biteSize,
+                                            double bytesPerBase,
+                                            int64_t & memUsed,
+                                            Prefetch * prefetch );
+            static biteReads_t takeBite( const ReadDataReader * reader,
+                                         std::vector< bamFileIteratorPtr_t > iterators,
+                                         int64_t biteToPos,
+                                         int64_t & memUsed );
+            static bool waitForMemory( const ReadDataReader * reader, Prefetch * prefetch, int64_t memUsed );
+
+            /// Reserve memory for the next bite from the budget shared by all jobs. A block that already has reads
+            /// gives up rather than waits, so that it can be called and its memory released.
+            ///
+            /// @return True if the memory was reserved.
+            static bool reserveBite( ReadDataset & dataset, int64_t bytes, bool blockHasReads, Prefetch * prefetch );
+            static bool isFull( const ReadDataReader * reader, int64_t memUsed )
+            {
+                return memUsed > reader->m_memLimit;
+            }
+            static bool isAlmostFull( const ReadDataReader * reader, int64_t memUsed )
+            {
+                return memUsed > ( reader->m_memLimit * 0.8 ) and not isFull( reader, memUsed );
+            }
+
+            /// Learn from the memory used by the block last returned, if any.
+            void recordBlockMemory();
+
+            void startPrefetch( int64_t memHeld );
+            readDataset_t takePrefetchedBlock( int64_t & memUsed );
+            void cancelPrefetch();
 
         private:
             const ReadDataReader * m_reader;
             utils::referenceSequencePtr_t m_refSequence;
-            const caller::Region m_region;
+            caller::Region m_region;
             int64_t m_curPos;
-            int64_t m_memUsed;
+            std::unique_ptr< Prefetch > m_prefetch;
+
+            BlockSizeController m_blockSizeController;
+            int64_t m_blockLength;
+            int64_t m_blockBytes;
         };
 
         ReadDataReader( const caller::params::System & systemParams,
@@ -61,19 +135,44 @@ namespace io
             : m_maxBlockSize( systemParams.m_maxBlockSize ),
               m_biteSize( biteSize ),
               m_memLimit( privateSystemParams.m_memLimit * 1024 * 1024 ),
+              m_prefetchReads( privateSystemParams.m_prefetchReads ),
+              m_decompressionThreads( systemParams.m_decompressionThreads ),
               m_readFilterAndTrimmer( filterParams )
         {
             initDataSources( bamFiles );
         }
 
+        /// Read from BAM files that are already open, e.g. ones shared with other jobs.
+        ReadDataReader( const caller::params::System & systemParams,
+                        const caller::params::PrivateSystem & privateSystemParams,
+                        const caller::params::Filters & filterParams,
+                        const int64_t biteSize,
+                        const std::vector< bamFilePtr_t > & dataSources )
+            : m_maxBlockSize( systemParams.m_maxBlockSize ),
+              m_biteSize( biteSize ),
+              m_memLimit( privateSystemParams.m_memLimit * 1024 * 1024 ),
+              m_prefetchReads( privateSystemParams.m_prefetchReads ),
+              m_decompressionThreads( systemParams.m_decompressionThreads ),
+              m_readFilterAndTrimmer( filterParams )
+        {
+            for ( const auto & dataSource : dataSources )
+            {
+                addDataSource( dataSource );
+            }
+        }
+
         ReadDataReader( int64_t maxBlockSize,
                         int64_t memLimitBytes,
                         const caller::params::Filters & filterParams,
                         const int64_t biteSize,
-                        const std::vector< std::string > & dataSources )
+                        const std::vector< std::string > & dataSources,
+                        const bool prefetchReads = false,
+                        const std::size_t decompressionThreads = 0 )
             : m_maxBlockSize( maxBlockSize ),
               m_biteSize( biteSize ),
               m_memLimit( memLimitBytes ),
+              m_prefetchReads( prefetchReads ),
+              m_decompressionThreads( decompressionThreads ),
               m_readFilterAndTrimmer( filterParams )
         {
             initDataSources( dataSources );
@@ -94,6 +193,10 @@ namespace io
         /// Returns the set of all samples observed in the loaded data
         std::vector< std::string > getSampleNames() const { return m_samples; }
 
+        /// Reserve the memory of the blocks read from budget, which is shared with other readers. The memory of a
+        /// block is also kept within the budget if that is smaller than the memory limit of this reader.
+        void setMemoryBudget( utils::memoryBudgetPtr_t budget );
+
         void initDataSources( const std::vector< std::string > & dataSources );
 
     private:
@@ -106,6 +209,9 @@ namespace io
         int64_t m_maxBlockSize;
         int64_t m_biteSize;
         int64_t m_memLimit;
+        bool m_prefetchReads;
+        std::size_t m_decompressionThreads;
+        utils::memoryBudgetPtr_t m_memoryBudget;
 
         ReadFilterAndTrimmer m_readFilterAndTrimmer;
     };
@@ -5,8 +5,15 @@ namespace wecall
 {
 namespace io
 {
+    constexpr int64_t ReadDataset::indexBytesPerRead;
+
     ReadDataset::ReadDataset( std::vector< std::string > sampleNames, caller::Region region )
-        : m_region( region ), m_samples( sampleNames ), m_intervalTreeData(), m_empty( true )
+        : m_region( region ),
+          m_samples( sampleNames ),
+          m_arena( std::make_shared< ReadArena >() ),
+          m_intervalTreeData(),
+          m_nIndexedReads( 0 ),
+          m_empty( true )
     {
         for ( auto sampleName : m_samples )
         {
@@ -50,10 +57,32 @@ namespace io
 
     //-----------------------------------------------------------------------------------------
 
+    void ReadDataset::buildReadSequences() const
+    {
+        for ( const auto & sampleTreePair : m_intervalTreeData )
+        {
+            const auto reads = sampleTreePair.second.getFullRange();
+            for ( auto read = reads.first; read != reads.second; ++read )
+            {
+                read->buildSequence();
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------------------------------
+
     void ReadDataset::insertRead( const std::string & sampleName, readPtr_t readPtr )
     {
         m_empty = false;
         m_intervalTreeData.at( sampleName ).insert( readPtr );
+        ++m_nIndexedReads;
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    int64_t ReadDataset::bytesUsed() const
+    {
+        return static_cast< int64_t >( m_arena->bytesUsed() ) + m_nIndexedReads * indexBytesPerRead;
     }
 
     //-----------------------------------------------------------------------------------------
@@ -3,6 +3,7 @@
 #define READ_DATASET_HPP
 
 #include "common.hpp"
+#include "io/readArena.hpp"
 #include "io/readRange.hpp"
 
 #include "io/readfilters/readFilterAndTrimmer.hpp"
@@ -10,16 +11,21 @@
 #include "caller/region.hpp"
 #include "utils/logging.hpp"
 #include "utils/interval.hpp"
+#include "utils/memoryBudget.hpp"
 
 namespace wecall
 {
 namespace io
 {
     using readData_t = std::map< std::string, readIntervalTree_t >;
-    /// Stores reads from >= 1 samples.
+    /// Stores reads from >= 1 samples. Reads read from BAM files are kept in the arena of the dataset, which is freed
+    /// in one go once the dataset and all handles to its reads are gone.
     class ReadDataset
     {
     public:
+        /// Bytes the interval trees use per read: a node holding a handle in each of the three sets of a tree node.
+        static constexpr int64_t indexBytesPerRead = 3 * ( 4 * sizeof( void * ) + sizeof( readPtr_t ) );
+
         ReadDataset( std::vector< std::string > sampleNames, caller::Region region );
 
         /// Disabled copy constructor. No copying of datasets
@@ -47,15 +53,30 @@ namespace io
 
         bool isEmpty() const { return m_empty; }
 
+        /// Build the sequences of all reads, so that the reads can be shared between threads.
+        void buildReadSequences() const;
+
         /// Inserts per sample the new Read into the data set. Except if the read is
         // flagged unmapped and/or getStartPos == getAlignedPos.
         void insertRead( const std::string & sampleName, readPtr_t readPtr );
 
+        /// Storage for the reads of this dataset.
+        ReadArena & arena() { return *m_arena; }
+
+        /// Bytes of memory used by the reads of this dataset and the index over them.
+        int64_t bytesUsed() const;
+
+        /// Memory reserved from the budget shared by all jobs for this dataset, released along with it.
+        utils::MemoryReservation & memoryReservation() { return m_memoryReservation; }
+
     private:
         caller::Region m_region;
         std::vector< std::string > m_samples;
+        readArenaPtr_t m_arena;
         readData_t m_intervalTreeData;
+        int64_t m_nIndexedReads;
         bool m_empty;
+        utils::MemoryReservation m_memoryReservation;
     };
 
     using readDataset_t = std::shared_ptr< const ReadDataset >;
@@ -22,7 +22,7 @@ namespace io
     class ReadAlignedEndPosComp
     {
     public:
-        bool operator()( readPtr_t left, readPtr_t right ) const
+        bool operator()( const readPtr_t & left, const readPtr_t & right ) const
         {
             return this->operator()( left ) > this->operator()( right );
         }
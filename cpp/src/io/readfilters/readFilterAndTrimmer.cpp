@@ -53,23 +53,22 @@ namespace io
         }
     }
 
-    bool ReadFilterAndTrimmer::isSimilarToPrevious( readPtr_t read ) const
+    bool ReadFilterAndTrimmer::isSimilarToPrevious( const Read & read ) const
     {
         bool isSimilarToPrevious = false;
-        if ( m_previousRead != nullptr )
+        if ( m_previousRead.isSet )
         {
             // AR: Two read-pairs are duplicates if their fragments span the same locus.
-            if ( m_previousRead->getStartPos() == read->getStartPos() and
-                 m_previousRead->getInsertSize() == read->getInsertSize() )
+            if ( m_previousRead.startPos == read.getStartPos() and m_previousRead.insertSize == read.getInsertSize() )
             {
                 isSimilarToPrevious = true;
             }
         }
-        m_previousRead = read;
+        m_previousRead = {true, read.getStartPos(), read.getInsertSize()};
         return isSimilarToPrevious;
     }
 
-    bool ReadFilterAndTrimmer::trimAndFilter( readPtr_t read ) const
+    bool ReadFilterAndTrimmer::trimAndFilter( Read & read ) const
     {
         trim( read );
         if ( passesFilters( read ) and hasLength( read ) )
@@ -89,25 +88,25 @@ namespace io
         }
     }
 
-    bool ReadFilterAndTrimmer::hasLength( readPtr_t read ) const
+    bool ReadFilterAndTrimmer::hasLength( const Read & read ) const
     {
-        return ( read->getStartPos() < read->getAlignedEndPos() );
+        return ( read.getStartPos() < read.getAlignedEndPos() );
     }
 
-    void ReadFilterAndTrimmer::trim( readPtr_t read ) const
+    void ReadFilterAndTrimmer::trim( Read & read ) const
     {
         if ( m_overlapTrim )
         {
-            read->trimOverlap();
+            read.trimOverlap();
         }
 
         if ( m_shortReadTrim )
         {
-            read->trimReadOfShortFragment();
+            read.trimReadOfShortFragment();
         }
     }
 
-    bool ReadFilterAndTrimmer::passesFilters( readPtr_t read ) const
+    bool ReadFilterAndTrimmer::passesFilters( const Read & read ) const
     {
         bool passesAll = true;
         for ( auto & filter : m_filters )
@@ -116,7 +115,7 @@ namespace io
             //            complete and not affected by filter test order.
 
             // TOD0 - change passes filter to take either a pointer or a ref to a pointer
-            if ( not filter->passesFilter( *read ) )
+            if ( not filter->passesFilter( read ) )
             {
                 passesAll = false;
             }
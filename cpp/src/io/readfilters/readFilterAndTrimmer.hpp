@@ -19,14 +19,28 @@ namespace io
     public:
         ReadFilterAndTrimmer( const caller::params::Filters & filterParams );
 
+        /// What the similar reads filter compares the next read with. It is kept by value rather than as a read,
+        /// which would keep the whole block of the read in memory.
+        struct PreviousRead
+        {
+            bool isSet;
+            int64_t startPos;
+            int64_t insertSize;
+        };
+
         /// Trim the read and return true if passed all filters and the trimmed read has length > 0
-        bool trimAndFilter( readPtr_t read ) const;
+        bool trimAndFilter( Read & read ) const;
+
+        /// The read the next read is compared with by the similar reads filter. Saving and restoring it lets a
+        /// reader abandon reads it has filtered and read them again.
+        PreviousRead previousRead() const { return m_previousRead; }
+        void restorePreviousRead( const PreviousRead & read ) const { m_previousRead = read; }
 
     private:
-        void trim( readPtr_t read ) const;
-        bool passesFilters( readPtr_t read ) const;
-        bool hasLength( readPtr_t read ) const;
-        bool isSimilarToPrevious( readPtr_t read ) const;
+        void trim( Read & read ) const;
+        bool passesFilters( const Read & read ) const;
+        bool hasLength( const Read & read ) const;
+        bool isSimilarToPrevious( const Read & read ) const;
 
         std::vector< ReadFilterPtr_t > m_filters;
 
@@ -34,7 +48,7 @@ namespace io
         bool m_shortReadTrim;
         bool m_noSimilarReads;
 
-        mutable readPtr_t m_previousRead = nullptr;
+        mutable PreviousRead m_previousRead = {false, 0, 0};
     };
 }
 }
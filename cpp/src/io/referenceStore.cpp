@@ -0,0 +1,140 @@
+// All content Copyright (C) 2018 Genomics plc
+#include "io/referenceStore.hpp"
+#include "utils/logging.hpp"
+
+#include <emmintrin.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+namespace wecall
+{
+namespace io
+{
+    void copyUpperCase( const char * bases, const std::size_t nBases, char * out )
+    {
+        // Bytes are compared as signed, so only 'a' to 'z' fall between the bounds.
+        const __m128i beforeLowerCase = _mm_set1_epi8( 'a' - 1 );
+        const __m128i afterLowerCase = _mm_set1_epi8( 'z' + 1 );
+        const __m128i caseBit = _mm_set1_epi8( 0x20 );
+
+        std::size_t i = 0;
+        for ( ; i + 16 <= nBases; i += 16 )
+        {
+            const __m128i chunk = _mm_loadu_si128( reinterpret_cast< const __m128i * >( bases + i ) );
+            const __m128i isLowerCase = _mm_and_si128( _mm_cmpgt_epi8( chunk, beforeLowerCase ),
+                                                       _mm_cmplt_epi8( chunk, afterLowerCase ) );
+            _mm_storeu_si128( reinterpret_cast< __m128i * >( out + i ),
+                              _mm_xor_si128( chunk, _mm_and_si128( isLowerCase, caseBit ) ) );
+        }
+        for ( ; i < nBases; ++i )
+        {
+            const char base = bases[i];
+            out[i] = ( base >= 'a' and base <= 'z' ) ? char( base - 0x20 ) : base;
+        }
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    ReferenceStore::ReferenceStore( const std::string & fileName, std::shared_ptr< const FastaIndex > indexFile )
+        : m_fileName( fileName ), m_indexFile( indexFile ), m_data( nullptr ), m_size( 0 )
+    {
+        const int fileDescriptor = ::open( fileName.c_str(), O_RDONLY );
+        if ( fileDescriptor < 0 )
+        {
+            throw utils::wecall_exception( "Could not open FASTA file" );
+        }
+
+        struct stat fileStatus;
+        if ( ::fstat( fileDescriptor, &fileStatus ) != 0 )
+        {
+            ::close( fileDescriptor );
+            throw utils::wecall_exception( "Could not read size of FASTA file " + fileName );
+        }
+
+        m_size = static_cast< int64_t >( fileStatus.st_size );
+        if ( m_size > 0 )
+        {
+            void * data = ::mmap( nullptr, std::size_t( m_size ), PROT_READ, MAP_PRIVATE, fileDescriptor, 0 );
+            ::close( fileDescriptor );
+            if ( data == MAP_FAILED )
+            {
+                throw utils::wecall_exception( "Could not map FASTA file " + fileName + " into memory" );
+            }
+            m_data = static_cast< const char * >( data );
+        }
+        else
+        {
+            ::close( fileDescriptor );
+        }
+    }
+
+    ReferenceStore::~ReferenceStore()
+    {
+        if ( m_data != nullptr )
+        {
+            ::munmap( const_cast< char * >( m_data ), std::size_t( m_size ) );
+        }
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    int64_t ReferenceStore::fileOffset( const IndexTuple & indexTuple, const int64_t position ) const
+    {
+        return indexTuple.m_startPos + ( position / indexTuple.m_lineLength ) * indexTuple.m_fullLineLength +
+               position % indexTuple.m_lineLength;
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    void ReferenceStore::appendSequence( const caller::Region & region, std::string & seq ) const
+    {
+        const auto indexTuple = m_indexFile->getIndexTuple( region.contig() );
+        WECALL_ASSERT( utils::Interval( 0L, indexTuple->m_seqLength ).contains( region.interval() ),
+                       "Region " + region.toString() + " is not valid as not contained contig" );
+
+        if ( region.size() == 0 )
+        {
+            return;
+        }
+        WECALL_ERROR( this->fileOffset( *indexTuple, region.end() - 1 ) < m_size,
+                      "FASTA file " + m_fileName + " is shorter than its index for region " + region.toString() );
+
+        // Lines are copied whole, so the line breaks are skipped rather than searched for.
+        const auto outStart = seq.size();
+        seq.resize( outStart + int64_to_sizet( region.size() ) );
+        char * out = &seq[outStart];
+        for ( int64_t position = region.start(); position < region.end(); )
+        {
+            const auto column = position % indexTuple->m_lineLength;
+            const auto nBases = std::min( indexTuple->m_lineLength - column, region.end() - position );
+            copyUpperCase( m_data + this->fileOffset( *indexTuple, position ), int64_to_sizet( nBases ), out );
+            out += nBases;
+            position += nBases;
+        }
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    void ReferenceStore::prefetch( const caller::Region & region ) const
+    {
+        if ( m_data == nullptr or region.size() == 0 )
+        {
+            return;
+        }
+
+        const auto indexTuple = m_indexFile->getIndexTuple( region.contig() );
+        const auto pageSize = static_cast< int64_t >( ::sysconf( _SC_PAGESIZE ) );
+        const auto start = this->fileOffset( *indexTuple, std::max( region.start(), 0L ) ) / pageSize * pageSize;
+        const auto end =
+            std::min( this->fileOffset( *indexTuple, std::min( region.end(), indexTuple->m_seqLength ) ), m_size );
+        if ( end > start )
+        {
+            ::madvise( const_cast< char * >( m_data ) + start, std::size_t( end - start ), MADV_WILLNEED );
+        }
+    }
+}
+}
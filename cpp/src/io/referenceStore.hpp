@@ -0,0 +1,57 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef REFERENCE_STORE_HPP
+#define REFERENCE_STORE_HPP
+
+#include "io/fastaFile.hpp"
+#include "caller/region.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace wecall
+{
+namespace io
+{
+    /// Read-only view of an indexed FASTA file, mapped into memory once and shared by all jobs. The pages of the
+    /// file are loaded by the operating system as they are touched and are shared between threads, so fetching a
+    /// sequence takes no locks and no system calls.
+    class ReferenceStore
+    {
+    public:
+        ReferenceStore( const std::string & fileName, std::shared_ptr< const FastaIndex > indexFile );
+        ~ReferenceStore();
+
+        ReferenceStore( const ReferenceStore & rhs ) = delete;
+        ReferenceStore & operator=( const ReferenceStore & ) = delete;
+
+        /// Append the bases of region, which must lie within its contig, to seq in upper case and without line
+        /// breaks.
+        void appendSequence( const caller::Region & region, std::string & seq ) const;
+
+        /// Ask the operating system to start loading the pages holding the bases of region. Parts of region outside
+        /// its contig are ignored.
+        void prefetch( const caller::Region & region ) const;
+
+        const FastaIndex & indexFile() const { return *m_indexFile; }
+        const std::string & fileName() const { return m_fileName; }
+
+    private:
+        /// Offset in the file of the base at position of the contig described by indexTuple.
+        int64_t fileOffset( const IndexTuple & indexTuple, int64_t position ) const;
+
+    private:
+        const std::string m_fileName;
+        std::shared_ptr< const FastaIndex > m_indexFile;
+        const char * m_data;
+        int64_t m_size;
+    };
+
+    using referenceStorePtr_t = std::shared_ptr< const ReferenceStore >;
+
+    /// Copy nBases bases to out, converting lower case letters to upper case.
+    void copyUpperCase( const char * bases, std::size_t nBases, char * out );
+}
+}
+
+#endif
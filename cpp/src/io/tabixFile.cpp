@@ -1,6 +1,7 @@
 // All content Copyright (C) 2018 Genomics plc
 #include <string>
 #include "io/tabixFile.hpp"
+#include "utils/exceptions.hpp"
 #include <boost/algorithm/string.hpp>
 
 #include <tabix/tabix.h>
@@ -10,12 +11,41 @@ namespace wecall
 namespace io
 {
     TabixFile::TabixFile( std::string filename, std::string indexFilename )
-        : m_tabixFile( ti_open( filename.c_str(), indexFilename.c_str() ) )
+        : m_filename( filename ), m_tabixFile( ti_open( filename.c_str(), indexFilename.c_str() ) )
     {
         this->readHeader();
+        // Load the index now rather than on the first query, which may be made from several threads at once.
+        ti_lazy_index_load( m_tabixFile );
     }
 
-    TabixFile::~TabixFile() { ti_close( m_tabixFile ); }
+    TabixFile::~TabixFile()
+    {
+        for ( auto cursor : m_cursors )
+        {
+            bgzf_close( cursor );
+        }
+        ti_close( m_tabixFile );
+    }
+
+    BGZF * TabixFile::takeCursor() const
+    {
+        std::lock_guard< std::mutex > lock( m_cursorMutex );
+        if ( m_cursors.empty() )
+        {
+            const auto cursor = bgzf_open( m_filename.c_str(), "r" );
+            WECALL_ERROR( cursor != nullptr, "Could not open " + m_filename );
+            return cursor;
+        }
+        auto cursor = m_cursors.back();
+        m_cursors.pop_back();
+        return cursor;
+    }
+
+    void TabixFile::returnCursor( BGZF * cursor ) const
+    {
+        std::lock_guard< std::mutex > lock( m_cursorMutex );
+        m_cursors.push_back( cursor );
+    }
 
     void TabixFile::readHeader()
     {
@@ -58,15 +88,17 @@ namespace io
     {
         std::vector< std::string > lines = {};
 
+        BGZF * cursor = this->takeCursor();
         if ( ti_iter_t iter = ti_querys( m_tabixFile, region.toString().c_str() ) )
         {
             int len;
-            while ( const char * s = ti_read( m_tabixFile, iter, &len ) )
+            while ( const char * s = ti_iter_read( cursor, iter, &len ) )
             {
                 lines.emplace_back( s );
             }
             ti_iter_destroy( iter );
         }
+        this->returnCursor( cursor );
 
         return lines;
     }
@@ -1,4 +1,8 @@
 // All content Copyright (C) 2018 Genomics plc
+#ifndef TABIX_FILE_HPP
+#define TABIX_FILE_HPP
+
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -12,6 +16,8 @@ namespace io
 {
     const std::string headerPrefix = "#";
 
+    /// A tabix-indexed file. The index is loaded once and only read afterwards, so that one instance can be
+    /// shared by several jobs: each fetch reads the file through a BGZF handle that no other fetch is using.
     class TabixFile
     {
     public:
@@ -25,8 +31,17 @@ namespace io
     private:
         void readHeader();
 
+        BGZF * takeCursor() const;
+        void returnCursor( BGZF * cursor ) const;
+
+        const std::string m_filename;
         tabix_t * m_tabixFile;
         std::vector< std::string > m_headerLines;
+
+        mutable std::mutex m_cursorMutex;
+        mutable std::vector< BGZF * > m_cursors;
     };
 }
 }
+
+#endif
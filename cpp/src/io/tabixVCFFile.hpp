@@ -1,4 +1,7 @@
 // All content Copyright (C) 2018 Genomics plc
+#ifndef TABIX_VCF_FILE_HPP
+#define TABIX_VCF_FILE_HPP
+
 #include <string>
 #include <vector>
 #include "io/tabixFile.hpp"
@@ -34,3 +37,5 @@ namespace io
     };
 }
 }
+
+#endif
@@ -22,6 +22,7 @@ namespace io
           m_outputRefCalls( outputRefCalls ),
           m_outputPhasedGenotypes( outputPhasedGenotypes ),
           m_file( outputFilename.c_str() ),
+          m_out( m_file ),
           m_contig( "" ),
           m_timer( std::make_shared< utils::Timer >( "IO", utils::fileMetaData( outputFilename ) ) )
     {
@@ -33,6 +34,21 @@ namespace io
 
     //-----------------------------------------------------------------------------------------
 
+    VCFWriter::VCFWriter( std::ostream & out,
+                          const std::string & outputName,
+                          bool outputRefCalls,
+                          bool outputPhasedGenotypes )
+        : m_headerWritten( false ),
+          m_outputRefCalls( outputRefCalls ),
+          m_outputPhasedGenotypes( outputPhasedGenotypes ),
+          m_out( out ),
+          m_contig( "" ),
+          m_timer( std::make_shared< utils::Timer >( "IO", utils::fileMetaData( outputName ) ) )
+    {
+    }
+
+    //-----------------------------------------------------------------------------------------
+
     VCFWriter::~VCFWriter() { m_file.close(); }
 
     //-----------------------------------------------------------------------------------------
@@ -59,7 +75,7 @@ namespace io
                                   vcf::format::getVCFKeys( m_outputPhasedGenotypes, m_outputRefCalls ), filterDescs,
                                   contigs );
 
-        m_file << header;
+        m_out << header;
         m_headerWritten = true;
     }
 
@@ -125,7 +141,7 @@ namespace io
             {
                 vcf::Record record( m_contig, pos + 1, it->varIds, ref, {alt}, it->qual, it->filters, compileInfo( it ),
                                     compileSampleInfo( it, m_outputPhasedGenotypes ) );
-                m_file << record;
+                m_out << record;
             }
             else
             {
@@ -31,6 +31,11 @@ namespace io
         /// Performs file open and sets flags and filters that are consistent through the lifetime of the instance.
         VCFWriter( const std::string & outputFilename, bool outputRefCalls, bool outputPhasedGenotypes );
 
+        /// Writes to a stream owned by the caller instead of a file.
+        ///
+        /// @param outputName Name of the output, used for timing logs.
+        VCFWriter( std::ostream & out, const std::string & outputName, bool outputRefCalls, bool outputPhasedGenotypes );
+
         /// Destructor to close the open file
         ~VCFWriter();
 
@@ -46,6 +51,9 @@ namespace io
                           std::vector< vcf::FilterDesc > filterDescs,
                           std::vector< caller::Region > contigs );
 
+        /// Allows records to be written when the header has been written to the final output by someone else.
+        void headerWrittenElsewhere() { m_headerWritten = true; }
+
         /// Sets state holding the current region being processed - that state being used
         /// by subsequent calls to writeCallSet().
         ///
@@ -95,6 +103,7 @@ namespace io
         const bool m_outputRefCalls;
         const bool m_outputPhasedGenotypes;
         std::ofstream m_file;
+        std::ostream & m_out;
 
         std::string m_contig;
 
@@ -16,17 +16,53 @@ namespace wecall
 namespace mapping
 {
 
+    namespace
+    {
+        void validateSequenceForHashing( const utils::BasePairSequence & sequence, unsigned int kmerSize )
+        {
+            WECALL_ASSERT( kmerSize > 1, "Cannot operate with kmers of size 1" );
+            WECALL_ASSERT( sequence.size() >= kmerSize, "Sequence is too short for hashing. Seq = " + sequence.str() );
+
+            const auto maxSeqLen = 0x1u << 2 * kmerSize;
+            assert( maxSeqLen == std::pow( 4, kmerSize ) );
+            WECALL_ASSERT( sequence.size() < maxSeqLen, "Sequence is too long for hashing. Length = " +
+                                                             std::to_string( sequence.size() ) + " and max allowed = " +
+                                                             std::to_string( maxSeqLen ) );
+        }
+    }
+
+    std::vector< uint32_t > kmerHashes( const utils::BasePairSequence & sequence, unsigned int kmerSize )
+    {
+        validateSequenceForHashing( sequence, kmerSize );
+
+        // Two bits per base, as HashFunction takes them (a,A->0 c,C->1 t,T->2 g,G->3), with the first base of a
+        // k-mer in the lowest bits.
+        const auto twoBitBase = []( const char base )
+        {
+            return ( static_cast< uint32_t >( base ) >> 1 ) & 0x3u;
+        };
+        const auto newBaseShift = 2 * ( kmerSize - 1 );
+
+        auto sequenceIt = sequence.cbegin();
+        uint32_t hash = 0;
+        for ( unsigned int j = 0; j + 1 < kmerSize; ++j, ++sequenceIt )
+        {
+            hash |= twoBitBase( *sequenceIt ) << ( 2 * j + 2 );
+        }
+
+        std::vector< uint32_t > hashes( sequence.size() - kmerSize + 1 );
+        for ( auto & kmerHash : hashes )
+        {
+            hash = ( hash >> 2 ) | ( twoBitBase( *sequenceIt++ ) << newBaseShift );
+            kmerHash = hash;
+        }
+        return hashes;
+    }
+
     HashFunction::HashFunction( const utils::BasePairSequence & sequence, unsigned int kmerSize )
         : m_bitShift( kmerSize * 2 - 3 )
     {
-        WECALL_ASSERT( kmerSize > 1, "Cannot operate with kmers of size 1" );
-        WECALL_ASSERT( sequence.size() >= kmerSize, "Sequence is too short for hashing. Seq = " + sequence.str() );
-
-        const auto maxSeqLen = 0x1u << 2 * kmerSize;
-        assert( maxSeqLen == std::pow( 4, kmerSize ) );
-        WECALL_ASSERT( sequence.size() < maxSeqLen, "Sequence is too long for hashing. Length = " +
-                                                         std::to_string( sequence.size() ) + " and max allowed = " +
-                                                         std::to_string( maxSeqLen ) );
+        validateSequenceForHashing( sequence, kmerSize );
 
         m_currentHash = 0;
         auto begin = sequence.cbegin();
@@ -52,48 +88,47 @@ namespace mapping
                               const int haplotypePadding )
         : m_paddedHaplotypeSequenceLength( static_cast< int >( paddedHaplotypeSequence.size() ) ),
           m_kmerSize( kmerSize ),
-          m_haplotypePadding( haplotypePadding ),
-          m_hashSize( std::pow( 4, m_kmerSize ) ),
-          m_hashTable( m_hashSize, constants::endOfChain ),
-          m_hashCollisions( paddedHaplotypeSequence.size(), constants::endOfChain )
+          m_haplotypePadding( haplotypePadding )
     {
         this->indexSequence( paddedHaplotypeSequence );
     }
 
+    std::size_t KmerMatches::findSlot( const uint32_t kmer ) const
+    {
+        // Fibonacci hashing spreads the k-mers over the table; collisions are resolved by linear probing.
+        const std::size_t mask = m_kmerTable.size() - 1;
+        std::size_t slot = ( kmer * 2654435769u ) >> m_kmerTableShift;
+        while ( m_kmerTable[slot].m_kmer != kmer and m_kmerTable[slot].m_kmer != m_emptySlot )
+        {
+            slot = ( slot + 1 ) & mask;
+        }
+        return slot;
+    }
+
     std::vector< std::size_t > KmerMatches::countKmerMatches(
         const wecall::utils::BasePairSequence & readSequence ) const
     {
         WECALL_ASSERT( readSequence.size() <= m_paddedHaplotypeSequenceLength,
                         "Require padded Haplotype sequence to be longer than any chosen read-sequence" );
 
-        const int readSeqLen = static_cast< int >( readSequence.size() );
-
-        HashFunction hashFunction( readSequence, m_kmerSize );
+        const auto readKmers = kmerHashes( readSequence, m_kmerSize );
 
-        const auto allowablePositions = this->allowableStartPositionsInHaplotype( readSeqLen );
+        const auto allowablePositions = this->allowableStartPositionsInHaplotype( readSequence.size() );
 
         std::vector< std::size_t > counts( int64_to_sizet( allowablePositions.end() ), 0 );
 
-        auto readSequenceIt = readSequence.cbegin() + m_kmerSize - 1;
-        for ( std::size_t index = 0, index_end = readSeqLen - ( m_kmerSize - 1 ); index < index_end;
-              ++index, ++readSequenceIt )
+        for ( std::size_t index = 0; index < readKmers.size(); ++index )
         {
-            const auto base = *readSequenceIt;
-
-            const int hashVal = hashFunction.next( base );
-
-            auto hapIdx = m_hashTable[hashVal];
-
-            while ( this->isHashHit( hapIdx ) )
+            const auto & slot = m_kmerTable[this->findSlot( readKmers[index] )];
+            const auto positionsBegin = m_kmerPositions.cbegin() + slot.m_firstPosition;
+            for ( auto positionIt = positionsBegin; positionIt != positionsBegin + slot.m_count; ++positionIt )
             {
-                const auto pos = hapIdx - index;
+                const auto pos = static_cast< int64_t >( *positionIt ) - static_cast< int64_t >( index );
 
                 if ( allowablePositions.contains( pos ) )
                 {
                     ++counts[pos];
                 }
-
-                hapIdx = m_hashCollisions[hapIdx];
             }
         }
 
@@ -102,43 +137,48 @@ namespace mapping
 
     void KmerMatches::indexSequence( const utils::BasePairSequence & haplotypeSequence )
     {
-        HashFunction hashFunction( haplotypeSequence, m_kmerSize );
+        const auto kmers = kmerHashes( haplotypeSequence, m_kmerSize );
 
-        for ( std::size_t index = 0; index < haplotypeSequence.size() - ( m_kmerSize - 1 ); ++index )
+        // At most three quarters full, so that probes stay short.
+        unsigned int tableBits = 4;
+        while ( 3 * ( 1u << tableBits ) < 4 * kmers.size() )
         {
-            const auto base = haplotypeSequence[index + m_kmerSize - 1];
-            int hashVal = hashFunction.next( base );
+            ++tableBits;
+        }
+        m_kmerTable.assign( 1u << tableBits, {m_emptySlot, 0, 0} );
+        m_kmerTableShift = 32 - tableBits;
 
-            if ( m_hashTable[hashVal] == constants::endOfChain )
-            {
-                // No entry in the hash table yet with this hashVal
-                m_hashTable[hashVal] = index;
-            }
-            else
-            {
-                // Collision
-                int j = m_hashTable[hashVal];
-                int count = 2;  // the existing entry, plus the new one
+        std::vector< uint32_t > kmerSlots( kmers.size() );
+        for ( std::size_t index = 0; index < kmers.size(); ++index )
+        {
+            const auto slot = this->findSlot( kmers[index] );
+            m_kmerTable[slot].m_kmer = kmers[index];
+            ++m_kmerTable[slot].m_count;
+            kmerSlots[index] = static_cast< uint32_t >( slot );
+        }
 
-                while ( j != constants::repeatChain && m_hashCollisions[j] != constants::endOfChain )
-                {
-                    j = m_hashCollisions[j];
-                    ++count;
-                }
+        uint32_t firstPosition = 0;
+        for ( auto & slot : m_kmerTable )
+        {
+            slot.m_firstPosition = firstPosition;
+            firstPosition += slot.m_count;
+            slot.m_count = 0;
+        }
 
-                if ( count > constants::maxRepeatCount )
-                {
-                    // remove the entire chain
-                    m_hashTable[hashVal] = constants::repeatChain;
-                }
-                else
-                {
-                    // add new entry, unless this is a repeat chain
-                    if ( j != constants::repeatChain )
-                    {
-                        m_hashCollisions[j] = index;
-                    }
-                }
+        m_kmerPositions.resize( kmers.size() );
+        for ( std::size_t index = 0; index < kmers.size(); ++index )
+        {
+            auto & slot = m_kmerTable[kmerSlots[index]];
+            m_kmerPositions[slot.m_firstPosition + slot.m_count] = static_cast< uint32_t >( index );
+            ++slot.m_count;
+        }
+
+        // Repeated k-mers say little about where a read came from, so are left out of the index.
+        for ( auto & slot : m_kmerTable )
+        {
+            if ( slot.m_count > static_cast< uint32_t >( constants::maxRepeatCount ) )
+            {
+                slot.m_count = 0;
             }
         }
     }
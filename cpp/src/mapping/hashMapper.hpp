@@ -2,6 +2,7 @@
 #ifndef BASIC_HASH_HPP
 #define BASIC_HASH_HPP
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <set>
@@ -23,6 +24,9 @@ namespace mapping
         constexpr static double fractionOfKmersToConsider = 1.0 - 1.0 / maxRepeatCount;
     }
 
+    /// Hashes of all k-mers of sequence, equal to the values HashFunction would produce for them.
+    std::vector< uint32_t > kmerHashes( const utils::BasePairSequence & sequence, unsigned int kmerSize );
+
     class HashFunction
     {
     public:
@@ -37,6 +41,11 @@ namespace mapping
         int m_currentHash;
     };
 
+    /// Index of the k-mers of a padded haplotype sequence, for counting the k-mers a read shares with each start
+    /// position in the haplotype. K-mers occurring more than constants::maxRepeatCount times are not indexed.
+    ///
+    /// The index is an open-addressing table sized to the haplotype, mapping each k-mer to the positions it occurs
+    /// at, so it stays small enough to live in cache however large 4^kmerSize is.
     class KmerMatches
     {
     public:
@@ -51,17 +60,29 @@ namespace mapping
     private:
         void indexSequence( const utils::BasePairSequence & haplotypeSequence );
 
-        bool isHashHit( const int hashTableValue ) const { return hashTableValue >= 0; }
+        /// The slot holding kmer, or the empty slot it would go in.
+        std::size_t findSlot( const uint32_t kmer ) const;
 
     private:
+        struct KmerSlot
+        {
+            uint32_t m_kmer;
+            uint32_t m_firstPosition;
+            uint32_t m_count;
+        };
+
+        static constexpr uint32_t m_emptySlot = 0xffffffff;
+
         const unsigned int m_paddedHaplotypeSequenceLength;
 
         const unsigned int m_kmerSize;
         const int m_haplotypePadding;
-        const int m_hashSize;
 
-        std::vector< int > m_hashTable;
-        std::vector< int > m_hashCollisions;
+        std::vector< KmerSlot > m_kmerTable;
+        unsigned int m_kmerTableShift;
+
+        // Positions of each indexed k-mer in the haplotype, in order, from m_firstPosition of its slot.
+        std::vector< uint32_t > m_kmerPositions;
     };
 
     class HashMapper
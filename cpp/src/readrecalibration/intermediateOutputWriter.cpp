@@ -13,16 +13,15 @@ namespace wecall
 namespace corrector
 {
 
-    IntermediateOutputWriter::IntermediateOutputWriter( const std::vector< std::string > & inputBams,
+    IntermediateOutputWriter::IntermediateOutputWriter( const std::vector< io::bamFilePtr_t > & inputBams,
                                                         std::string outputFileStem )
         : m_outputFileStem( outputFileStem ), m_writeOutputFile( not m_outputFileStem.empty() )
     {
         if ( m_writeOutputFile )
         {
-            for ( const auto & inputBamFilename : inputBams )
+            for ( const auto & inputBam : inputBams )
             {
-                auto inputBam = io::BamFile( inputBamFilename );
-                auto sampleNames = inputBam.getSampleNames();
+                auto sampleNames = inputBam->getSampleNames();
                 if ( sampleNames.size() != 1 )
                 {
                     throw utils::wecall_exception( "Only one sample per bam file is currently supported." );
@@ -31,7 +30,7 @@ namespace corrector
 
                 m_sampleNameToFileMap[sampleNames.front()] = outputFilename;
 
-                this->writeSamHeader( outputFilename, inputBam.bamHeader().text );
+                this->writeSamHeader( outputFilename, inputBam->bamHeader().text );
             }
         }
     }
@@ -67,6 +66,7 @@ namespace corrector
     {
         if ( m_writeOutputFile )
         {
+            std::lock_guard< std::mutex > lock( m_mutex );
             for ( const auto & sampleNameReadRange : readRangesPerSample )
             {
                 auto sampleName = sampleNameReadRange.first;
@@ -2,9 +2,11 @@
 #ifndef INTERMEDIATE_OUTPUT_WRITER_HPP
 #define INTERMEDIATE_OUTPUT_WRITER_HPP
 
+#include <mutex>
 #include <vector>
 #include <string>
 
+#include "io/bamFile.hpp"
 #include "io/readRange.hpp"
 
 namespace wecall
@@ -15,8 +17,9 @@ namespace corrector
     {
 
     public:
-        IntermediateOutputWriter( const std::vector< std::string > & inputBams, std::string outputFileStem );
+        IntermediateOutputWriter( const std::vector< io::bamFilePtr_t > & inputBams, std::string outputFileStem );
 
+        /// Append reads to the files of their samples. May be called from several jobs at once.
         void writeReads( const io::perSampleRegionsReads_t & readRangesPerSample, std::string contig ) const;
 
     private:
@@ -27,6 +30,7 @@ namespace corrector
         const std::string m_outputFileStem;
         std::map< std::string, std::string > m_sampleNameToFileMap;
         const bool m_writeOutputFile;
+        mutable std::mutex m_mutex;
     };
 
 }  // namespace corrector
@@ -2,36 +2,51 @@
 #include "utils/matrix.hpp"
 #include "utils/median.hpp"
 
+#include <algorithm>
+
 namespace wecall
 {
 namespace utils
 {
-    void smoothLowOutliers( utils::matrix_t & matrix_t, const double maxDifference )
+    template < typename T >
+    void smoothLowOutliers( AlignedMatrix< T > & matrix, const double maxDifference )
     {
-        if ( matrix_t.size1() == 0 or matrix_t.size2() == 0 )
+        if ( matrix.nRows() == 0 or matrix.nColumns() == 0 )
         {
             return;
         }
 
-        const auto nReads = matrix_t.size1();
+        const auto nReads = matrix.nRows();
 
         std::vector< double > maxValuesPerRead;
+        maxValuesPerRead.reserve( nReads );
 
         for ( std::size_t readIndex = 0; readIndex < nReads; ++readIndex )
         {
-            const utils::matrixRow_t row_t( matrix_t, readIndex );
-            const auto max = *std::max_element( row_t.begin(), row_t.end() );
+            const T * row = matrix.row( readIndex );
+            T max = row[0];
+            for ( std::size_t columnIndex = 1; columnIndex < matrix.nColumns(); ++columnIndex )
+            {
+                max = std::max( max, row[columnIndex] );
+            }
             maxValuesPerRead.push_back( max );
         }
 
         const auto median = utils::functional::median( maxValuesPerRead );
 
-        const double minValue = median * maxDifference;
+        const auto minValue = static_cast< T >( median * maxDifference );
 
-        for ( auto & val : matrix_t.data() )
+        for ( std::size_t readIndex = 0; readIndex < nReads; ++readIndex )
         {
-            val = std::max( val, minValue );
+            T * row = matrix.row( readIndex );
+            for ( std::size_t columnIndex = 0; columnIndex < matrix.nColumns(); ++columnIndex )
+            {
+                row[columnIndex] = std::max( row[columnIndex], minValue );
+            }
         }
     }
+
+    template void smoothLowOutliers( AlignedMatrix< double > & matrix, const double maxDifference );
+    template void smoothLowOutliers( AlignedMatrix< float > & matrix, const double maxDifference );
+}
 }
-}
\ No newline at end of file
@@ -2,39 +2,149 @@
 #ifndef MATRIX_HPP
 #define MATRIX_HPP
 
-#include <numeric>
-
-#include <boost/numeric/ublas/matrix.hpp>
-#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <cstdlib>
+#include <new>
+#include <vector>
 
 namespace wecall
 {
 namespace utils
 {
+    /// Allocates storage aligned to 64 bytes, the size of a cache line and of an AVX-512 register.
+    template < typename T >
+    struct CacheAlignedAllocator
+    {
+        using value_type = T;
+        static constexpr std::size_t alignment = 64;
+
+        CacheAlignedAllocator() = default;
+
+        template < typename U >
+        CacheAlignedAllocator( const CacheAlignedAllocator< U > & )
+        {
+        }
 
-    using matrix_t = boost::numeric::ublas::matrix< double >;
-    using matrixRow_t = boost::numeric::ublas::matrix_row< const utils::matrix_t >;
-    using matrixColumn_t = boost::numeric::ublas::matrix_column< const utils::matrix_t >;
+        T * allocate( const std::size_t n )
+        {
+            void * memory = nullptr;
+            if ( posix_memalign( &memory, alignment, n * sizeof( T ) ) != 0 )
+            {
+                throw std::bad_alloc();
+            }
+            return static_cast< T * >( memory );
+        }
 
-    template < typename MatrixRow >
-    double sumMatrixRowOverAllIndices( const MatrixRow & matrixRow )
+        void deallocate( T * memory, const std::size_t ) { std::free( memory ); }
+
+        template < typename U >
+        bool operator==( const CacheAlignedAllocator< U > & ) const
+        {
+            return true;
+        }
+
+        template < typename U >
+        bool operator!=( const CacheAlignedAllocator< U > & ) const
+        {
+            return false;
+        }
+    };
+
+    /// A dense row-major matrix. Every row starts on a 64-byte boundary and is padded with zeros to a whole number
+    /// of cache lines, so a row can be processed with aligned vector loads.
+    template < typename T >
+    class AlignedMatrix
     {
-        return std::accumulate( matrixRow.begin(), matrixRow.end(), 0.0 );
-    }
+    public:
+        using value_type = T;
+
+        AlignedMatrix() : AlignedMatrix( 0, 0 ) {}
+
+        AlignedMatrix( const std::size_t nRows, const std::size_t nColumns )
+            : m_nRows( nRows ),
+              m_nColumns( nColumns ),
+              m_stride( paddedRowLength( nColumns ) ),
+              m_data( nRows * m_stride, T( 0 ) )
+        {
+        }
+
+        std::size_t nRows() const { return m_nRows; }
+        std::size_t nColumns() const { return m_nColumns; }
+
+        /// Number of elements from the start of one row to the start of the next.
+        std::size_t stride() const { return m_stride; }
+
+        T & operator()( const std::size_t row, const std::size_t column ) { return m_data[row * m_stride + column]; }
+        const T & operator()( const std::size_t row, const std::size_t column ) const
+        {
+            return m_data[row * m_stride + column];
+        }
+
+        T * row( const std::size_t row ) { return m_data.data() + row * m_stride; }
+        const T * row( const std::size_t row ) const { return m_data.data() + row * m_stride; }
+
+    private:
+        static std::size_t paddedRowLength( const std::size_t nColumns )
+        {
+            constexpr std::size_t elementsPerLine = CacheAlignedAllocator< T >::alignment / sizeof( T );
+            return ( nColumns + elementsPerLine - 1 ) / elementsPerLine * elementsPerLine;
+        }
 
-    template < typename MatrixRow, typename IndexSet >
-    double sumMatrixRowOverIndexSubset( const MatrixRow & matrixRow, const IndexSet & indices )
+        std::size_t m_nRows;
+        std::size_t m_nColumns;
+        std::size_t m_stride;
+        std::vector< T, CacheAlignedAllocator< T > > m_data;
+    };
+
+#ifdef WECALL_FLOAT_LIKELIHOODS
+    using likelihood_t = float;
+#else
+    using likelihood_t = double;
+#endif
+
+    using matrix_t = AlignedMatrix< double >;
+
+    /// Read x haplotype likelihoods, stored as 32-bit floats when built with WECALL_FLOAT_LIKELIHOODS.
+    using likelihoodMatrix_t = AlignedMatrix< likelihood_t >;
+
+    /// Sum of each row and each column. Sums are accumulated in double precision, adding elements in index order.
+    template < typename T >
+    std::vector< double > rowSums( const AlignedMatrix< T > & matrix )
     {
-        auto theSum = 0.0;
+        std::vector< double > sums( matrix.nRows(), 0.0 );
+        for ( std::size_t rowIndex = 0; rowIndex < matrix.nRows(); ++rowIndex )
+        {
+            const T * row = matrix.row( rowIndex );
+            double sum = 0.0;
+            for ( std::size_t columnIndex = 0; columnIndex < matrix.nColumns(); ++columnIndex )
+            {
+                sum += row[columnIndex];
+            }
+            sums[rowIndex] = sum;
+        }
+        return sums;
+    }
 
-        for ( const auto index : indices )
+    template < typename T >
+    std::vector< double > columnSums( const AlignedMatrix< T > & matrix )
+    {
+        // Rows are added to the sums one at a time, which keeps each column's sum in row order while the inner
+        // loop runs over contiguous memory.
+        std::vector< double > sums( matrix.nColumns(), 0.0 );
+        double * const sumsData = sums.data();
+        for ( std::size_t rowIndex = 0; rowIndex < matrix.nRows(); ++rowIndex )
         {
-            theSum += matrixRow( index );
+            const T * row = matrix.row( rowIndex );
+            for ( std::size_t columnIndex = 0; columnIndex < matrix.nColumns(); ++columnIndex )
+            {
+                sumsData[columnIndex] += row[columnIndex];
+            }
         }
-        return theSum;
+        return sums;
     }
 
-    void smoothLowOutliers( utils::matrix_t & matrix_t, const double maxDifference );
+    /// Raise every element to at least maxDifference times the median over rows of the row maximum.
+    template < typename T >
+    void smoothLowOutliers( AlignedMatrix< T > & matrix, const double maxDifference );
 
 }  // namespace utils
 }  // namespace wecall
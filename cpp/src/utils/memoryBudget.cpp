@@ -0,0 +1,156 @@
+// All content Copyright (C) 2018 Genomics plc
+#include "utils/memoryBudget.hpp"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace wecall
+{
+namespace utils
+{
+    namespace
+    {
+        /// How often a waiting reservation checks whether it has been abandoned.
+        const std::chrono::milliseconds stopPollInterval( 50 );
+    }
+
+    MemoryBudget::MemoryBudget( const int64_t limitBytes ) : m_limit( limitBytes ), m_reserved( 0 ), m_peak( 0 ) {}
+
+    bool MemoryBudget::tryReserve( const int64_t bytes )
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        if ( not this->fits( bytes ) )
+        {
+            return false;
+        }
+        this->add( bytes );
+        return true;
+    }
+
+    bool MemoryBudget::reserve( const int64_t bytes, const std::function< bool() > & stop )
+    {
+        std::unique_lock< std::mutex > lock( m_mutex );
+        while ( not this->fits( bytes ) )
+        {
+            if ( stop and stop() )
+            {
+                return false;
+            }
+            m_released.wait_for( lock, stopPollInterval );
+        }
+        this->add( bytes );
+        return true;
+    }
+
+    void MemoryBudget::forceReserve( const int64_t bytes )
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        this->add( bytes );
+    }
+
+    void MemoryBudget::release( const int64_t bytes )
+    {
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            m_reserved -= bytes;
+        }
+        m_released.notify_all();
+    }
+
+    int64_t MemoryBudget::reserved() const
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        return m_reserved;
+    }
+
+    int64_t MemoryBudget::peak() const
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        return m_peak;
+    }
+
+    void MemoryBudget::add( const int64_t bytes )
+    {
+        m_reserved += bytes;
+        m_peak = std::max( m_peak, m_reserved );
+    }
+
+    int64_t peakResidentBytes()
+    {
+        struct rusage usage;
+        if ( getrusage( RUSAGE_SELF, &usage ) != 0 )
+        {
+            return 0;
+        }
+        // Linux reports kilobytes.
+        return static_cast< int64_t >( usage.ru_maxrss ) * 1024;
+    }
+
+    //-----------------------------------------------------------------------------------------
+
+    MemoryReservation::MemoryReservation( memoryBudgetPtr_t budget ) : m_budget( budget ), m_bytes( 0 ) {}
+
+    MemoryReservation::~MemoryReservation() { this->releaseAll(); }
+
+    MemoryReservation::MemoryReservation( MemoryReservation && rhs ) : m_budget( rhs.m_budget ), m_bytes( rhs.m_bytes )
+    {
+        rhs.m_bytes = 0;
+    }
+
+    MemoryReservation & MemoryReservation::operator=( MemoryReservation && rhs )
+    {
+        if ( this != &rhs )
+        {
+            this->releaseAll();
+            m_budget = rhs.m_budget;
+            m_bytes = rhs.m_bytes;
+            rhs.m_bytes = 0;
+        }
+        return *this;
+    }
+
+    bool MemoryReservation::tryGrow( const int64_t bytes )
+    {
+        if ( m_budget != nullptr and not m_budget->tryReserve( bytes ) )
+        {
+            return false;
+        }
+        m_bytes += bytes;
+        return true;
+    }
+
+    bool MemoryReservation::grow( const int64_t bytes, const std::function< bool() > & stop )
+    {
+        if ( m_budget != nullptr and not m_budget->reserve( bytes, stop ) )
+        {
+            return false;
+        }
+        m_bytes += bytes;
+        return true;
+    }
+
+    void MemoryReservation::growTo( const int64_t bytes )
+    {
+        if ( bytes <= m_bytes )
+        {
+            return;
+        }
+        if ( m_budget != nullptr )
+        {
+            m_budget->forceReserve( bytes - m_bytes );
+        }
+        m_bytes = bytes;
+    }
+
+    void MemoryReservation::releaseAll()
+    {
+        if ( m_budget != nullptr and m_bytes > 0 )
+        {
+            m_budget->release( m_bytes );
+        }
+        m_bytes = 0;
+    }
+}
+}
@@ -0,0 +1,101 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef MEMORY_BUDGET_HPP
+#define MEMORY_BUDGET_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace wecall
+{
+namespace utils
+{
+    /// Memory shared by all jobs of a process. Jobs reserve memory before they allocate it and release it when
+    /// they are done with it, so that together they stay within the limit. A reservation is always granted when
+    /// nothing else is reserved, so that one job can make progress however large its needs.
+    class MemoryBudget
+    {
+    public:
+        explicit MemoryBudget( int64_t limitBytes );
+
+        MemoryBudget( const MemoryBudget & rhs ) = delete;
+        MemoryBudget & operator=( const MemoryBudget & ) = delete;
+
+        /// Reserve bytes if they fit within the limit.
+        ///
+        /// @return True if the bytes were reserved.
+        bool tryReserve( int64_t bytes );
+
+        /// Wait until bytes fit within the limit and reserve them.
+        ///
+        /// @param stop Asked periodically while waiting; the wait is abandoned once it returns true.
+        /// @return True if the bytes were reserved, false if the wait was abandoned.
+        bool reserve( int64_t bytes, const std::function< bool() > & stop );
+
+        /// Reserve bytes that are already in use, whether or not they fit.
+        void forceReserve( int64_t bytes );
+
+        void release( int64_t bytes );
+
+        int64_t limit() const { return m_limit; }
+        int64_t reserved() const;
+
+        /// Most bytes reserved at any one time.
+        int64_t peak() const;
+
+    private:
+        bool fits( int64_t bytes ) const { return m_reserved == 0 or m_reserved + bytes <= m_limit; }
+        void add( int64_t bytes );
+
+    private:
+        const int64_t m_limit;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_released;
+        int64_t m_reserved;
+        int64_t m_peak;
+    };
+
+    using memoryBudgetPtr_t = std::shared_ptr< MemoryBudget >;
+
+    /// Most memory the process has had resident at any one time.
+    int64_t peakResidentBytes();
+
+    /// Memory reserved from a budget by one owner, released when the reservation is destroyed. A reservation
+    /// without a budget reserves nothing and always succeeds.
+    class MemoryReservation
+    {
+    public:
+        explicit MemoryReservation( memoryBudgetPtr_t budget = nullptr );
+        ~MemoryReservation();
+
+        MemoryReservation( MemoryReservation && rhs );
+        MemoryReservation & operator=( MemoryReservation && rhs );
+
+        MemoryReservation( const MemoryReservation & rhs ) = delete;
+        MemoryReservation & operator=( const MemoryReservation & ) = delete;
+
+        /// Reserve bytes more if they fit within the budget.
+        bool tryGrow( int64_t bytes );
+
+        /// Wait for bytes more to fit within the budget. See MemoryBudget::reserve.
+        bool grow( int64_t bytes, const std::function< bool() > & stop );
+
+        /// Raise the reservation to bytes in total, whether or not they fit, to cover memory already in use.
+        void growTo( int64_t bytes );
+
+        int64_t bytes() const { return m_bytes; }
+
+    private:
+        void releaseAll();
+
+    private:
+        memoryBudgetPtr_t m_budget;
+        int64_t m_bytes;
+    };
+}
+}
+
+#endif
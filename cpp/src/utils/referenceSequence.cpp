@@ -3,16 +3,42 @@
 #include "caller/region.hpp"
 #include "utils/sequence.hpp"
 
+#include <algorithm>
+#include <utility>
+
 namespace wecall
 {
 namespace utils
 {
     ReferenceSequence::ReferenceSequence( caller::Region region, wecall::utils::BasePairSequence sequence )
-        : m_region( region ), m_sequence( sequence )
+        : m_region( region ),
+          m_buffer( std::make_shared< const utils::BasePairSequence >( std::move( sequence ) ) ),
+          m_offset( 0 )
     {
-        WECALL_ASSERT( ( static_cast< std::size_t >( m_region.size() ) == m_sequence.size() ),
+        WECALL_ASSERT( ( static_cast< std::size_t >( m_region.size() ) == m_buffer->size() ),
                         "ReferenceSequence requires region size to match sequence size: " +
-                            std::to_string( m_region.size() ) + " != " + std::to_string( m_sequence.size() ) );
+                            std::to_string( m_region.size() ) + " != " + std::to_string( m_buffer->size() ) );
+    }
+
+    ReferenceSequence::ReferenceSequence( caller::Region region,
+                                          std::shared_ptr< const utils::BasePairSequence > buffer,
+                                          const std::size_t offset )
+        : m_region( region ), m_buffer( buffer ), m_offset( offset )
+    {
+    }
+
+    bool ReferenceSequence::operator==( const ReferenceSequence & other ) const
+    {
+        return m_region == other.m_region and std::equal( this->cbegin(), this->cend(), other.cbegin() );
+    }
+
+    utils::BasePairSequence ReferenceSequence::sequence() const
+    {
+        if ( m_offset == 0 and this->size() == m_buffer->size() )
+        {
+            return *m_buffer;
+        }
+        return std::string( this->cbegin(), this->cend() );
     }
 
     ReferenceSequence ReferenceSequence::subseq( const caller::Region & region ) const
@@ -20,7 +46,7 @@ namespace utils
         WECALL_ASSERT( m_region.contains( region ),
                         "Cannot get subsequence for region not contained in reference sequence: " + region.toString() +
                             " must be contained " + m_region.toString() );
-        return ReferenceSequence( region, m_sequence.substr( distanceFromStart( region.start() ), region.size() ) );
+        return ReferenceSequence( region, m_buffer, m_offset + int64_to_sizet( distanceFromStart( region.start() ) ) );
     }
 
     std::pair< std::string::const_iterator, std::string::const_iterator > ReferenceSequence::subseqRange(
@@ -30,7 +56,7 @@ namespace utils
                         "Cannot get subsequence for region not contained in reference sequence: " + region.toString() +
                             " must be contained " + m_region.toString() );
 
-        auto it = m_sequence.cbegin() + distanceFromStart( region.start() );
+        auto it = this->cbegin() + distanceFromStart( region.start() );
         return std::make_pair( it, it + region.size() );
     }
 
@@ -39,7 +65,7 @@ namespace utils
     {
         WECALL_ASSERT( m_region.interval().contains( interval ),
                         "Interval " + interval.toString() + " not contained in " + m_region.toString() );
-        const auto start = m_sequence.cbegin() + int64_to_sizet( distanceFromStart( interval.start() ) );
+        const auto start = this->cbegin() + int64_to_sizet( distanceFromStart( interval.start() ) );
         const auto end = start + int64_to_sizet( interval.size() );
         return std::make_pair( start, end );
     }
@@ -49,7 +75,7 @@ namespace utils
     {
         WECALL_ASSERT( m_region.interval().contains( interval ),
                         "Interval " + interval.toString() + " not contained in " + m_region.toString() );
-        const auto start = m_sequence.crbegin() + int64_to_sizet( distanceFromEnd( interval.end() ) );
+        const auto start = this->crbegin() + int64_to_sizet( distanceFromEnd( interval.end() ) );
         const auto end = start + int64_to_sizet( interval.size() );
         return std::make_pair( start, end );
     }
@@ -60,12 +86,20 @@ namespace utils
                         "Cannot get padded sequence for region not containing original region: " +
                             widerRegion.toString() + " must contain " + m_region.toString() );
 
+        if ( widerRegion == m_region )
+        {
+            return *this;
+        }
+
         const auto newLengthAtStart = m_region.start() - widerRegion.start();
         const auto newLengthAtEnd = widerRegion.end() - m_region.end();
-        const BasePairSequence leftPadding( int64_to_sizet( newLengthAtStart ), constants::gapChar );
-        const BasePairSequence rightPadding( int64_to_sizet( newLengthAtEnd ), constants::gapChar );
 
-        return ReferenceSequence( widerRegion, leftPadding + m_sequence + rightPadding );
+        std::string padded;
+        padded.reserve( int64_to_sizet( widerRegion.size() ) );
+        padded.append( int64_to_sizet( newLengthAtStart ), constants::gapChar );
+        padded.append( this->cbegin(), this->cend() );
+        padded.append( int64_to_sizet( newLengthAtEnd ), constants::gapChar );
+        return ReferenceSequence( widerRegion, std::move( padded ) );
     }
 
     ReferenceSequence ReferenceSequence::getPaddedSequence( const caller::Region & clusterRegion,
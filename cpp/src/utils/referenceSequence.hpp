@@ -2,6 +2,7 @@
 #ifndef ALIGNED_SEQUENCE_HPP
 #define ALIGNED_SEQUENCE_HPP
 
+#include <memory>
 #include <string>
 
 #include "common.hpp"
@@ -13,22 +14,28 @@ namespace wecall
 {
 namespace utils
 {
+    /// The reference bases of a region. A ReferenceSequence is a view onto a buffer shared with the sequences it was
+    /// taken from, so copies and subsequences do not copy bases. Only padding beyond the buffer makes a new one.
     class ReferenceSequence
     {
     public:
         ReferenceSequence( caller::Region region, utils::BasePairSequence sequence );
 
-        bool operator==( const ReferenceSequence & other ) const
-        {
-            return m_region == other.m_region and m_sequence == other.m_sequence;
-        }
+        bool operator==( const ReferenceSequence & other ) const;
 
         const caller::Region & region() const { return m_region; }
-        const utils::BasePairSequence & sequence() const { return m_sequence; }
 
-        char at( int64_t refPos ) const { return m_sequence.at( int64_to_sizet( distanceFromStart( refPos ) ) ); }
+        /// A copy of the bases. Use the iterators or at() to read them in place.
+        utils::BasePairSequence sequence() const;
 
-        std::size_t size() const { return m_sequence.size(); }
+        char at( int64_t refPos ) const
+        {
+            WECALL_ASSERT( m_region.interval().contains( refPos ),
+                           "Position " + std::to_string( refPos ) + " not contained in " + m_region.toString() );
+            return m_buffer->at( m_offset + int64_to_sizet( distanceFromStart( refPos ) ) );
+        }
+
+        std::size_t size() const { return int64_to_sizet( m_region.size() ); }
         std::string contig() const { return m_region.contig(); }
         int64_t start() const { return m_region.start(); }
         int64_t end() const { return m_region.end(); }
@@ -50,27 +57,38 @@ namespace utils
             return out << referenceSequence.region() << " " << referenceSequence.sequence().str();
         }
 
-        std::string toString() const { return m_region.toString() + "\t" + m_sequence.str(); }
+        std::string toString() const { return m_region.toString() + "\t" + this->sequence().str(); }
 
         using const_iterator = wecall::utils::BasePairSequence::const_iterator;
         using const_reverse_iterator = wecall::utils::BasePairSequence::const_reverse_iterator;
 
-        const_iterator cbegin() const { return m_sequence.cbegin(); }
-        const_iterator cend() const { return m_sequence.cend(); }
+        const_iterator cbegin() const { return m_buffer->cbegin() + m_offset; }
+        const_iterator cend() const { return this->cbegin() + m_region.size(); }
+
+        const_reverse_iterator crbegin() const { return m_buffer->crbegin() + this->offsetFromBufferEnd(); }
+        const_reverse_iterator crend() const { return this->crbegin() + m_region.size(); }
 
-        const_reverse_iterator crbegin() const { return m_sequence.crbegin(); }
-        const_reverse_iterator crend() const { return m_sequence.crend(); }
+        /// The buffer the bases are held in, which lives as long as any sequence viewing it, and the index of the
+        /// first base in it. For code that keeps pointers into the bases rather than a copy of them.
+        const utils::BasePairSequence & buffer() const { return *m_buffer; }
+        std::size_t bufferOffset() const { return m_offset; }
 
         std::pair< const_iterator, const_iterator > getRangeForwardIterators( utils::Interval interval ) const;
         std::pair< const_reverse_iterator, const_reverse_iterator > getRangeReverseIterators(
             utils::Interval interval ) const;
 
     private:
+        ReferenceSequence( caller::Region region,
+                           std::shared_ptr< const utils::BasePairSequence > buffer,
+                           std::size_t offset );
+
         int64_t distanceFromStart( int64_t refPos ) const { return refPos - m_region.start(); }
         int64_t distanceFromEnd( int64_t refPos ) const { return m_region.end() - refPos; }
+        std::size_t offsetFromBufferEnd() const { return m_buffer->size() - m_offset - this->size(); }
 
         caller::Region m_region;
-        utils::BasePairSequence m_sequence;
+        std::shared_ptr< const utils::BasePairSequence > m_buffer;
+        std::size_t m_offset;
     };
 
     typedef std::shared_ptr< ReferenceSequence > referenceSequencePtr_t;
@@ -2,8 +2,10 @@
 #ifndef WECALL_SEQUENCE_HPP_H
 #define WECALL_SEQUENCE_HPP_H
 
+#include <functional>
 #include <string>
 #include <memory>
+#include <utility>
 
 #include "boost/operators.hpp"
 
@@ -20,22 +22,29 @@ namespace utils
         BasePairSequence() : m_sequence() {}
         BasePairSequence( const char * sequence ) : m_sequence( sequence ) {}
         BasePairSequence( const std::string & sequence ) : m_sequence( sequence ) {}
+        BasePairSequence( std::string && sequence ) : m_sequence( std::move( sequence ) ) {}
         BasePairSequence( std::size_t n, char c ) : m_sequence( std::string( n, c ) ) {}
         BasePairSequence( const BasePairSequence & other, std::size_t pos, std::size_t length );
         BasePairSequence( const BasePairSequence & other ) : m_sequence( other.m_sequence ) {}
         bool operator==( const BasePairSequence & other ) const;
         bool operator<( const BasePairSequence & other ) const;
+        BasePairSequence( BasePairSequence && other ) = default;
         BasePairSequence & operator=( const BasePairSequence & other )
         {
             m_sequence = other.m_sequence;
             return *this;
         }
+        BasePairSequence & operator=( BasePairSequence && other ) = default;
 
         char operator[]( std::size_t pos ) const { return at( pos ); }
         const char at( std::size_t pos ) const { return m_sequence.at( pos ); }
 
         std::string str() const { return m_sequence; };
         std::size_t size() const { return m_sequence.size(); }
+        std::size_t capacity() const { return m_sequence.capacity(); }
+
+        /// Hash of the bases, computed without copying them.
+        std::size_t hash() const { return std::hash< std::string >()( m_sequence ); }
 
         BasePairSequence substr( int64_t pos, int64_t length ) const;
         BasePairSequence substr( int64_t pos ) const;
@@ -77,7 +86,7 @@ struct hash< wecall::utils::BasePairSequence >
 {
     std::size_t operator()( const wecall::utils::BasePairSequence & x ) const
     {
-        return hash< std::string >()( x.str() );
+        return x.hash();
     }
 };
 }
@@ -0,0 +1,137 @@
+// All content Copyright (C) 2018 Genomics plc
+#include <algorithm>
+
+#include "utils/taskPool.hpp"
+#include "utils/logging.hpp"
+
+namespace wecall
+{
+namespace utils
+{
+    TaskPool::TaskPool( std::size_t numberOfThreads ) : m_stopping( false )
+    {
+        WECALL_ASSERT( numberOfThreads > 0, "Task pool requires at least one thread" );
+        for ( std::size_t i = 1; i < numberOfThreads; ++i )
+        {
+            m_threads.emplace_back( &TaskPool::workerLoop, this );
+        }
+    }
+
+    TaskPool::~TaskPool()
+    {
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            m_stopping = true;
+        }
+        m_taskQueued.notify_all();
+
+        for ( auto & thread : m_threads )
+        {
+            thread.join();
+        }
+    }
+
+    void TaskPool::run( std::vector< task_t > tasks )
+    {
+        if ( tasks.empty() )
+        {
+            return;
+        }
+
+        const auto batch = std::make_shared< Batch >();
+        batch->m_unfinishedTasks = tasks.size();
+
+        std::vector< Entry > entries;
+        for ( auto & task : tasks )
+        {
+            entries.push_back( {std::move( task ), batch} );
+        }
+
+        std::unique_lock< std::mutex > lock( m_mutex );
+
+        // A nested batch goes ahead of the batch it was started from, so that the task waiting for it is not kept
+        // waiting behind its siblings.
+        m_queue.insert( m_queue.begin(), std::make_move_iterator( entries.begin() ),
+                        std::make_move_iterator( entries.end() ) );
+        m_taskQueued.notify_all();
+
+        // The caller only takes tasks of its own batch, so that it returns as soon as the batch is done. Tasks of
+        // the batch taken by other threads are waited for.
+        while ( batch->m_unfinishedTasks > 0 )
+        {
+            const auto entry = std::find_if( m_queue.begin(), m_queue.end(), [&batch]( const Entry & queued )
+                                             {
+                                                 return queued.m_batch == batch;
+                                             } );
+            if ( entry == m_queue.end() )
+            {
+                m_taskFinished.wait( lock );
+                continue;
+            }
+
+            auto taken = std::move( *entry );
+            m_queue.erase( entry );
+            this->runEntry( taken, lock );
+        }
+
+        if ( batch->m_exception )
+        {
+            std::rethrow_exception( batch->m_exception );
+        }
+    }
+
+    void TaskPool::workerLoop()
+    {
+        std::unique_lock< std::mutex > lock( m_mutex );
+        while ( true )
+        {
+            m_taskQueued.wait( lock, [this]()
+                               {
+                                   return m_stopping or not m_queue.empty();
+                               } );
+            if ( m_queue.empty() )
+            {
+                return;
+            }
+
+            auto entry = std::move( m_queue.front() );
+            m_queue.pop_front();
+            this->runEntry( entry, lock );
+        }
+    }
+
+    void TaskPool::runEntry( Entry & entry, std::unique_lock< std::mutex > & lock )
+    {
+        const auto batch = entry.m_batch;
+        const bool failed = static_cast< bool >( batch->m_exception );
+
+        lock.unlock();
+        std::exception_ptr exception;
+        if ( not failed )
+        {
+            try
+            {
+                entry.m_task();
+            }
+            catch ( ... )
+            {
+                exception = std::current_exception();
+            }
+        }
+        // Release whatever the task holds before the batch is reported done.
+        entry.m_task = nullptr;
+        lock.lock();
+
+        if ( exception and not batch->m_exception )
+        {
+            batch->m_exception = exception;
+        }
+
+        --batch->m_unfinishedTasks;
+        if ( batch->m_unfinishedTasks == 0 )
+        {
+            m_taskFinished.notify_all();
+        }
+    }
+}
+}
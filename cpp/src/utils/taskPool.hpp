@@ -0,0 +1,70 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef TASK_POOL_HPP
+#define TASK_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wecall
+{
+namespace utils
+{
+    /// A fixed set of threads that runs batches of tasks for as long as the pool lives, so that work fanned out
+    /// many times over, e.g. once per block, does not start threads each time. The thread calling run() works on
+    /// its own batch too. A task may itself call run(), in which case it works on the nested batch until that is
+    /// done: nesting neither blocks a thread nor adds one.
+    class TaskPool
+    {
+    public:
+        using task_t = std::function< void() >;
+
+        /// @param numberOfThreads Number of threads working on a batch, counting the thread that calls run().
+        explicit TaskPool( std::size_t numberOfThreads );
+        ~TaskPool();
+
+        TaskPool( const TaskPool & rhs ) = delete;
+        TaskPool & operator=( const TaskPool & ) = delete;
+
+        std::size_t numberOfThreads() const { return m_threads.size() + 1; }
+
+        /// Run tasks to completion, starting them in the order given and ahead of any batch already queued.
+        /// Rethrows the first exception thrown by a task, once the tasks already started have finished; tasks
+        /// not yet started are then skipped.
+        void run( std::vector< task_t > tasks );
+
+    private:
+        struct Batch
+        {
+            std::size_t m_unfinishedTasks = 0;
+            std::exception_ptr m_exception;
+        };
+
+        struct Entry
+        {
+            task_t m_task;
+            std::shared_ptr< Batch > m_batch;
+        };
+
+        void workerLoop();
+
+        /// Run the task of entry, which has been taken off the queue, with lock released while it runs.
+        void runEntry( Entry & entry, std::unique_lock< std::mutex > & lock );
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_taskQueued;
+        std::condition_variable m_taskFinished;
+        std::deque< Entry > m_queue;
+        bool m_stopping;
+        std::vector< std::thread > m_threads;
+    };
+}
+}
+
+#endif
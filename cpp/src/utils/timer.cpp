@@ -1,5 +1,7 @@
 // All content Copyright (C) 2018 Genomics plc
+#include <algorithm>
 #include <chrono>
+#include <iomanip>
 #include <sstream>
 
 #include "common.hpp"
@@ -41,7 +43,7 @@ namespace utils
     }
 
     Timer::Timer( std::string type, std::map< std::string, std::string > metadata )
-        : m_type( type ), m_metadata( metadata ), m_duration( 0 )
+        : m_type( type ), m_metadata( metadata ), m_duration( 0 ), m_bytes( 0 )
     {
     }
 
@@ -53,6 +55,10 @@ namespace utils
         m_duration += std::chrono::duration_cast< std::chrono::microseconds >( end - m_start ).count();
     }
 
+    void Timer::addDuration( std::chrono::microseconds duration ) { m_duration += duration.count(); }
+
+    void Timer::addBytes( std::size_t bytes ) { m_bytes += bytes; }
+
     std::string Timer::format_metadata() const
     {
         std::stringstream metadata;
@@ -71,7 +77,16 @@ namespace utils
 
     Timer::~Timer()
     {
-        WECALL_LOG( TIMING, m_type << " " << std::to_string( m_duration ) << "us: " << this->format_metadata() );
+        if ( m_bytes.load() > 0 )
+        {
+            // Bytes per microsecond are megabytes per second.
+            const auto duration = std::max( m_duration.load(), 1L );
+            std::stringstream throughput;
+            throughput << std::fixed << std::setprecision( 1 ) << double( m_bytes.load() ) / duration << "MB/s";
+            m_metadata["bytes"] = std::to_string( m_bytes.load() );
+            m_metadata["throughput"] = throughput.str();
+        }
+        WECALL_LOG( TIMING, m_type << " " << std::to_string( m_duration.load() ) << "us: " << this->format_metadata() );
     }
 
     std::map< std::string, std::string > fileMetaData( std::string filename ) { return {{"file", filename}}; }
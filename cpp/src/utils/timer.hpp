@@ -1,6 +1,7 @@
 // All content Copyright (C) 2018 Genomics plc
 #ifndef TIMER_HPP
 #define TIMER_HPP
+#include <atomic>
 #include <chrono>
 #include <string>
 #include <map>
@@ -21,28 +22,41 @@ namespace utils
         void start();
         void pause();
 
+        /// Add time measured elsewhere. Unlike start and pause, this may be called from several threads at once.
+        void addDuration( std::chrono::microseconds duration );
+
+        /// Count bytes processed in the timed code, reported with their throughput. Thread safe.
+        void addBytes( std::size_t bytes );
+
     private:
         std::string format_metadata() const;
         std::string m_type;
         std::map< std::string, std::string > m_metadata;
 
         std::chrono::steady_clock::time_point m_start;
-        long m_duration;
+        std::atomic< long > m_duration;
+        std::atomic< std::size_t > m_bytes;
     };
 
     using timerPtr_t = std::shared_ptr< Timer >;
 
     std::map< std::string, std::string > fileMetaData( std::string filename );
 
+    /// Adds its own lifetime to a timer. Triggers on several threads may share a timer.
     class ScopedTimerTrigger
     {
     public:
-        ScopedTimerTrigger( timerPtr_t timer ) : m_timer( timer ) { m_timer->start(); }
+        ScopedTimerTrigger( timerPtr_t timer ) : m_timer( timer ), m_start( std::chrono::steady_clock::now() ) {}
 
-        ~ScopedTimerTrigger() { m_timer->pause(); }
+        ~ScopedTimerTrigger()
+        {
+            m_timer->addDuration( std::chrono::duration_cast< std::chrono::microseconds >(
+                std::chrono::steady_clock::now() - m_start ) );
+        }
 
     private:
         timerPtr_t m_timer;
+        std::chrono::steady_clock::time_point m_start;
     };
 }
 }
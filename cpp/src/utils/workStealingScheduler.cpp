@@ -0,0 +1,207 @@
+// All content Copyright (C) 2018 Genomics plc
+#include <iomanip>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "utils/workStealingScheduler.hpp"
+#include "utils/logging.hpp"
+
+namespace wecall
+{
+namespace utils
+{
+    namespace
+    {
+        // Identifies the scheduler and worker owning the current thread, if any.
+        thread_local const WorkStealingScheduler * t_scheduler = nullptr;
+        thread_local std::size_t t_workerIndex = 0;
+
+        double toSeconds( std::chrono::steady_clock::duration duration )
+        {
+            return std::chrono::duration_cast< std::chrono::duration< double > >( duration ).count();
+        }
+    }
+
+    WorkStealingScheduler::WorkStealingScheduler( std::size_t numberOfWorkers )
+        : m_pendingTasks( 0 ), m_queuedTasks( 0 ), m_idleWorkers( 0 ), m_nextWorker( 0 )
+    {
+        WECALL_ASSERT( numberOfWorkers > 0, "Scheduler requires at least one worker" );
+        for ( std::size_t i = 0; i < numberOfWorkers; ++i )
+        {
+            m_workers.emplace_back( new Worker() );
+        }
+    }
+
+    void WorkStealingScheduler::schedule( task_t task )
+    {
+        std::size_t workerIndex;
+        if ( t_scheduler == this )
+        {
+            workerIndex = t_workerIndex;
+        }
+        else
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            workerIndex = m_nextWorker;
+            m_nextWorker = ( m_nextWorker + 1 ) % m_workers.size();
+        }
+
+        {
+            std::lock_guard< std::mutex > lock( m_workers[workerIndex]->m_mutex );
+            m_workers[workerIndex]->m_tasks.push_back( std::move( task ) );
+        }
+
+        std::lock_guard< std::mutex > lock( m_mutex );
+        ++m_pendingTasks;
+        ++m_queuedTasks;
+        m_condition.notify_one();
+    }
+
+    bool WorkStealingScheduler::hasIdleWorkers() const
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        return m_idleWorkers > 0 and m_queuedTasks == 0;
+    }
+
+    void WorkStealingScheduler::run()
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        boost::thread_group threadPool;
+        for ( std::size_t i = 0; i < m_workers.size(); ++i )
+        {
+            threadPool.create_thread( boost::bind( &WorkStealingScheduler::workerLoop, this, i ) );
+        }
+        threadPool.join_all();
+
+        this->reportUtilisation( std::chrono::steady_clock::now() - start );
+
+        if ( m_exception )
+        {
+            std::rethrow_exception( m_exception );
+        }
+    }
+
+    void WorkStealingScheduler::workerLoop( std::size_t workerIndex )
+    {
+        t_scheduler = this;
+        t_workerIndex = workerIndex;
+        Worker & worker = *m_workers[workerIndex];
+
+        while ( true )
+        {
+            task_t task;
+            if ( this->takeTask( workerIndex, task ) )
+            {
+                bool failed;
+                {
+                    std::lock_guard< std::mutex > lock( m_mutex );
+                    failed = static_cast< bool >( m_exception );
+                }
+
+                // Once a task has failed the remaining tasks are drained without being run.
+                if ( not failed )
+                {
+                    const auto taskStart = std::chrono::steady_clock::now();
+                    try
+                    {
+                        task();
+                    }
+                    catch ( ... )
+                    {
+                        std::lock_guard< std::mutex > lock( m_mutex );
+                        if ( not m_exception )
+                        {
+                            m_exception = std::current_exception();
+                        }
+                    }
+                    worker.m_busyTime += std::chrono::steady_clock::now() - taskStart;
+                    ++worker.m_tasksRun;
+                }
+
+                std::lock_guard< std::mutex > lock( m_mutex );
+                --m_pendingTasks;
+                if ( m_pendingTasks == 0 )
+                {
+                    m_condition.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock< std::mutex > lock( m_mutex );
+            if ( m_pendingTasks == 0 )
+            {
+                break;
+            }
+
+            ++m_idleWorkers;
+            m_condition.wait( lock, [this]()
+                              {
+                                  return m_pendingTasks == 0 or m_queuedTasks > 0;
+                              } );
+            --m_idleWorkers;
+        }
+
+        t_scheduler = nullptr;
+    }
+
+    bool WorkStealingScheduler::takeTask( std::size_t workerIndex, task_t & task )
+    {
+        bool found = false;
+        {
+            Worker & worker = *m_workers[workerIndex];
+            std::lock_guard< std::mutex > lock( worker.m_mutex );
+            if ( not worker.m_tasks.empty() )
+            {
+                task = std::move( worker.m_tasks.front() );
+                worker.m_tasks.pop_front();
+                found = true;
+            }
+        }
+
+        for ( std::size_t offset = 1; not found and offset < m_workers.size(); ++offset )
+        {
+            Worker & victim = *m_workers[( workerIndex + offset ) % m_workers.size()];
+            std::lock_guard< std::mutex > lock( victim.m_mutex );
+            if ( not victim.m_tasks.empty() )
+            {
+                task = std::move( victim.m_tasks.back() );
+                victim.m_tasks.pop_back();
+                ++m_workers[workerIndex]->m_tasksStolen;
+                found = true;
+            }
+        }
+
+        if ( found )
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            --m_queuedTasks;
+        }
+
+        return found;
+    }
+
+    void WorkStealingScheduler::reportUtilisation( std::chrono::steady_clock::duration wallTime ) const
+    {
+        const auto wallSeconds = toSeconds( wallTime );
+        double totalBusySeconds = 0.0;
+
+        for ( std::size_t i = 0; i < m_workers.size(); ++i )
+        {
+            const auto busySeconds = toSeconds( m_workers[i]->m_busyTime );
+            totalBusySeconds += busySeconds;
+
+            WECALL_LOG( INFO, "Worker " << i << " ran " << m_workers[i]->m_tasksRun << " tasks ("
+                                         << m_workers[i]->m_tasksStolen << " stolen), busy for " << std::fixed
+                                         << std::setprecision( 1 ) << busySeconds << "s of " << wallSeconds
+                                         << "s (" << 100.0 * busySeconds / std::max( wallSeconds, 1e-9 ) << "%)" );
+        }
+
+        WECALL_LOG( INFO, "Overall worker utilisation " << std::fixed << std::setprecision( 1 )
+                                                         << 100.0 * totalBusySeconds /
+                                                                std::max( wallSeconds * m_workers.size(), 1e-9 )
+                                                         << "%" );
+    }
+}
+}
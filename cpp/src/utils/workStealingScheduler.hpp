@@ -0,0 +1,71 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef WORK_STEALING_SCHEDULER_HPP
+#define WORK_STEALING_SCHEDULER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace wecall
+{
+namespace utils
+{
+    /// Runs tasks on a fixed number of worker threads, each with its own deque of tasks. A worker takes tasks from
+    /// the front of its own deque and, when that is empty, steals from the back of the other workers' deques.
+    /// Tasks scheduled from a worker thread go to the back of that worker's deque, so work split off a running
+    /// task is the first thing an idle worker steals.
+    class WorkStealingScheduler
+    {
+    public:
+        using task_t = std::function< void() >;
+
+        explicit WorkStealingScheduler( std::size_t numberOfWorkers );
+
+        WorkStealingScheduler( const WorkStealingScheduler & rhs ) = delete;
+        WorkStealingScheduler & operator=( const WorkStealingScheduler & ) = delete;
+
+        /// Queue a task. Tasks scheduled before run() are dealt to the workers in turn, so scheduling them in
+        /// decreasing order of cost starts every worker on its most expensive task.
+        void schedule( task_t task );
+
+        /// @return True if a worker is waiting for work and there is none left to steal.
+        bool hasIdleWorkers() const;
+
+        /// Run all scheduled tasks, and any tasks they schedule, to completion and log the utilisation of each
+        /// worker. Rethrows the first exception thrown by a task.
+        void run();
+
+    private:
+        struct Worker
+        {
+            std::mutex m_mutex;
+            std::deque< task_t > m_tasks;
+            std::chrono::steady_clock::duration m_busyTime = std::chrono::steady_clock::duration::zero();
+            std::size_t m_tasksRun = 0;
+            std::size_t m_tasksStolen = 0;
+        };
+
+        void workerLoop( std::size_t workerIndex );
+        bool takeTask( std::size_t workerIndex, task_t & task );
+        void reportUtilisation( std::chrono::steady_clock::duration wallTime ) const;
+
+    private:
+        std::vector< std::unique_ptr< Worker > > m_workers;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::size_t m_pendingTasks;
+        std::size_t m_queuedTasks;
+        std::size_t m_idleWorkers;
+        std::size_t m_nextWorker;
+        std::exception_ptr m_exception;
+    };
+}
+}
+
+#endif
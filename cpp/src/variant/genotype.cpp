@@ -39,6 +39,16 @@ namespace variant
         return genotypeHash;
     }
 
+    nonPhasedGenotypeHash_t Genotype::getVariantNonPhasedHash( const HaplotypeMembership & membership ) const
+    {
+        nonPhasedGenotypeHash_t genotypeHash( membership.nVariants(), 0 );
+        for ( std::size_t varIndex = 0; varIndex < membership.nVariants(); ++varIndex )
+        {
+            genotypeHash[varIndex] = static_cast< char >( nStrandsContainingVariant( membership, varIndex ) );
+        }
+        return genotypeHash;
+    }
+
     std::size_t Genotype::nStrandsContainingVariant( const HaplotypeVector & haplotypes,
                                                      const variant::varPtr_t & var ) const
     {
@@ -53,6 +63,20 @@ namespace variant
         return numberOfStrands;
     }
 
+    std::size_t Genotype::nStrandsContainingVariant( const HaplotypeMembership & membership,
+                                                     const std::size_t variantIndex ) const
+    {
+        std::size_t numberOfStrands = 0;
+        for ( const auto & haplotype : m_haplotypes )
+        {
+            if ( membership.containsVariant( variantIndex, haplotype.first ) )
+            {
+                numberOfStrands += haplotype.second;
+            }
+        }
+        return numberOfStrands;
+    }
+
     std::string Genotype::toString() const
     {
         std::stringstream message;
@@ -112,7 +136,8 @@ namespace variant
     GenotypeVector::GenotypeVector( const std::size_t ploidy,
                                     const HaplotypeVector & haplotypes,
                                     const std::vector< std::size_t > & hapIndiciesToUse,
-                                    const std::vector< variant::varPtr_t > & variants )
+                                    const std::vector< variant::varPtr_t > & variants,
+                                    const HaplotypeMembership * membership )
         : m_ploidy( ploidy ), m_variants( variants ), m_genotypes(), m_genotypeHaplotypeIndexes()
     {
         if ( m_ploidy > 0 )
@@ -160,7 +185,16 @@ namespace variant
                 m_genotypes.emplace_back( std::make_shared< variant::Genotype >( hapPointers ) );
                 m_genotypeHaplotypeIndexes.push_back( indices );
             }
-            this->buildGenotypeWithSameNonPhaseRepresentation( haplotypes );
+            if ( membership == nullptr )
+            {
+                this->buildGenotypeWithSameNonPhaseRepresentation( HaplotypeMembership( haplotypes, m_variants ) );
+            }
+            else
+            {
+                WECALL_ASSERT( membership->nVariants() == m_variants.size(),
+                                "Haplotype membership does not match the variants of the GenotypeVector" );
+                this->buildGenotypeWithSameNonPhaseRepresentation( *membership );
+            }
         }
     }
 
@@ -175,13 +209,13 @@ namespace variant
         return *( m_genotypeWithSameNonPhasedRepresentation.at( givenGenotypeIndex ) );
     }
 
-    void GenotypeVector::buildGenotypeWithSameNonPhaseRepresentation( const HaplotypeVector & haplotypes )
+    void GenotypeVector::buildGenotypeWithSameNonPhaseRepresentation( const HaplotypeMembership & membership )
     {
         std::unordered_map< nonPhasedGenotypeHash_t, genotypeIndexSetPtr_t > nonPhasedGenotypeSets;
 
         for ( std::size_t i = 0; i < m_genotypes.size(); ++i )
         {
-            auto const hash = m_genotypes[i]->getVariantNonPhasedHash( haplotypes, m_variants );
+            auto const hash = m_genotypes[i]->getVariantNonPhasedHash( membership );
 
             if ( nonPhasedGenotypeSets.find( hash ) == nonPhasedGenotypeSets.end() )
             {
@@ -8,6 +8,7 @@
 #include <unordered_map>
 
 #include "variant/haplotype.hpp"
+#include "variant/haplotypeMembership.hpp"
 #include "caller/callSet.hpp"
 
 namespace wecall
@@ -24,6 +25,8 @@ namespace variant
 
         std::size_t nStrandsContainingVariant( const HaplotypeVector & haplotypes,
                                                const variant::varPtr_t & var ) const;
+        std::size_t nStrandsContainingVariant( const HaplotypeMembership & membership,
+                                               const std::size_t variantIndex ) const;
         std::size_t nCombinationsThisGenotype() const { return m_nCombinationsThisGenotype; }
         std::string toString() const;
         std::string toString( const HaplotypeVector & ) const;
@@ -32,6 +35,7 @@ namespace variant
 
         nonPhasedGenotypeHash_t getVariantNonPhasedHash( const HaplotypeVector & haplotypes,
                                                          const std::vector< varPtr_t > & variants ) const;
+        nonPhasedGenotypeHash_t getVariantNonPhasedHash( const HaplotypeMembership & membership ) const;
 
     private:
         const haplotypeAndCount_t m_haplotypes;
@@ -51,9 +55,10 @@ namespace variant
         GenotypeVector( const std::size_t ploidy,
                         const HaplotypeVector & haplotypes,
                         const std::vector< std::size_t > & hapIndiciesToUse,
-                        const std::vector< variant::varPtr_t > & variants );
+                        const std::vector< variant::varPtr_t > & variants,
+                        const HaplotypeMembership * membership = nullptr );
 
-        std::vector< std::size_t > getHaplotypeIndices( const std::size_t genotypeIndex ) const
+        const std::vector< std::size_t > & getHaplotypeIndices( const std::size_t genotypeIndex ) const
         {
             return m_genotypeHaplotypeIndexes.at( genotypeIndex );
         }
@@ -66,7 +71,7 @@ namespace variant
         genotypePtr_t operator[]( std::size_t genotypeIndex ) const { return m_genotypes.at( genotypeIndex ); }
 
     private:
-        void buildGenotypeWithSameNonPhaseRepresentation( const HaplotypeVector & haplotypes );
+        void buildGenotypeWithSameNonPhaseRepresentation( const HaplotypeMembership & membership );
 
     private:
         const std::size_t m_ploidy;
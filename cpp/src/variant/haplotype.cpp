@@ -338,37 +338,6 @@ namespace variant
 
     //-----------------------------------------------------------------------------------------
 
-    std::set< std::size_t > HaplotypeVector::getHaplotypeIndicesForVariant( const varPtr_t & variant ) const
-    {
-        std::set< std::size_t > hapIndicesForThisVariant;
-
-        for ( std::size_t hapIndex = 0; hapIndex < m_haplotypes.size(); ++hapIndex )
-        {
-            if ( m_haplotypes[hapIndex].containsVariant( variant ) )
-            {
-                hapIndicesForThisVariant.insert( hapIndex );
-            }
-        }
-
-        return hapIndicesForThisVariant;
-    }
-
-    std::set< std::size_t > HaplotypeVector::getIndicesForReference( const caller::Region & region ) const
-    {
-        std::set< std::size_t > hapIndicesForReferenceAtRegion;
-
-        for ( std::size_t hapIndex = 0; hapIndex < m_haplotypes.size(); ++hapIndex )
-        {
-            if ( m_haplotypes[hapIndex].isReference( region ) )
-            {
-                hapIndicesForReferenceAtRegion.insert( hapIndex );
-            }
-        }
-        return hapIndicesForReferenceAtRegion;
-    }
-
-    //-----------------------------------------------------------------------------------------
-
     void HaplotypeVector::sort() { std::sort( m_haplotypes.begin(), m_haplotypes.end() ); }
 
     std::string HaplotypeVector::toString() const
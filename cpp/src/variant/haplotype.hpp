@@ -96,9 +96,6 @@ namespace variant
 
         std::size_t size() const { return m_haplotypes.size(); }
 
-        std::set< std::size_t > getHaplotypeIndicesForVariant( const varPtr_t & variant ) const;
-        std::set< std::size_t > getIndicesForReference( const caller::Region & region ) const;
-
         void push_back( const variantSet_t & varCombo );
         void push_back( const variantSet_t & varCombo, const size_t haplotypeId );
         void keepIndicies( std::set< std::size_t > indicies );
@@ -19,13 +19,17 @@ namespace variant
                                                               const io::perSampleRegionsReads_t & readsPerSample,
                                                               utils::referenceSequencePtr_t referenceSequence,
                                                               const int64_t maxHaplotypesPerRanker,
-                                                              const std::size_t minReadsToSupportClaim )
+                                                              const std::size_t minReadsToSupportClaim,
+                                                              caller::ReadLikelihoodCache * likelihoodCache,
+                                                              caller::HaplotypeIndex * haplotypeIndex )
         : m_vars( variants ),
           m_regions( regions ),
           m_readsPerSample( readsPerSample ),
           m_referenceSequence( referenceSequence ),
           m_maxHaplotypesPerRanker( maxHaplotypesPerRanker ),
-          m_minReadsToSupportClaim( minReadsToSupportClaim )
+          m_minReadsToSupportClaim( minReadsToSupportClaim ),
+          m_likelihoodCache( likelihoodCache ),
+          m_haplotypeIndex( haplotypeIndex )
     {
     }
 
@@ -43,7 +47,7 @@ namespace variant
         haplotypes.sort();
         haplotypes.merge();
 
-        const AlignmentHaplotypeRanker alignmentHaplotypeRanker( clusterReads );
+        const AlignmentHaplotypeRanker alignmentHaplotypeRanker( clusterReads, m_likelihoodCache, m_haplotypeIndex );
 
         const auto bestIndicies = alignmentHaplotypeRanker.getTopHaplotypes( haplotypes, m_maxHaplotypesPerRanker );
 
@@ -105,7 +109,8 @@ namespace variant
             }
             if ( haplotypes.size() >= static_cast< std::size_t >( m_maxHaplotypesPerRanker - 1 ) )
             {
-                const AlignmentHaplotypeRanker alignmentHaplotypeRanker( m_readsPerSample );
+                const AlignmentHaplotypeRanker alignmentHaplotypeRanker( m_readsPerSample, m_likelihoodCache,
+                                                                         m_haplotypeIndex );
                 const auto bestIndicies =
                     alignmentHaplotypeRanker.getTopHaplotypes( haplotypes, m_maxHaplotypesPerRanker - 1 );
                 haplotypes.keepIndicies( bestIndicies );
@@ -22,7 +22,9 @@ namespace variant
                                      const io::perSampleRegionsReads_t & readsPerSample,
                                      utils::referenceSequencePtr_t referenceSequence,
                                      const int64_t maxHaplotypesPerRanker,
-                                     const std::size_t minReadsToSupportClaim );
+                                     const std::size_t minReadsToSupportClaim,
+                                     caller::ReadLikelihoodCache * likelihoodCache = nullptr,
+                                     caller::HaplotypeIndex * haplotypeIndex = nullptr );
 
         HaplotypeVector generateHaplotypes() const;
 
@@ -38,6 +40,8 @@ namespace variant
         const utils::referenceSequencePtr_t m_referenceSequence;
         const int64_t m_maxHaplotypesPerRanker;
         const std::size_t m_minReadsToSupportClaim;
+        caller::ReadLikelihoodCache * const m_likelihoodCache;
+        caller::HaplotypeIndex * const m_haplotypeIndex;
     };
 }
 }
@@ -0,0 +1,38 @@
+// All content Copyright (C) 2018 Genomics plc
+#include "variant/haplotypeMembership.hpp"
+
+namespace wecall
+{
+namespace variant
+{
+    HaplotypeMembership::HaplotypeMembership( const HaplotypeVector & haplotypes,
+                                              const std::vector< varPtr_t > & variants )
+        : HaplotypeMembership( variants.size(), haplotypes.size() )
+    {
+        for ( std::size_t variantIndex = 0; variantIndex < m_nVariants; ++variantIndex )
+        {
+            const auto & variant = variants[variantIndex];
+            for ( std::size_t haplotypeIndex = 0; haplotypeIndex < m_nHaplotypes; ++haplotypeIndex )
+            {
+                if ( haplotypes[haplotypeIndex].containsVariant( variant ) )
+                {
+                    this->setContainsVariant( variantIndex, haplotypeIndex );
+                }
+                if ( haplotypes[haplotypeIndex].isReference( variant->region() ) )
+                {
+                    this->setIsReference( variantIndex, haplotypeIndex );
+                }
+            }
+        }
+    }
+
+    HaplotypeMembership::HaplotypeMembership( const std::size_t nVariants, const std::size_t nHaplotypes )
+        : m_nVariants( nVariants ),
+          m_nHaplotypes( nHaplotypes ),
+          m_wordsPerVariant( ( nHaplotypes + 63 ) / 64 ),
+          m_containsVariant( m_nVariants * m_wordsPerVariant, 0 ),
+          m_isReference( m_nVariants * m_wordsPerVariant, 0 )
+    {
+    }
+}
+}
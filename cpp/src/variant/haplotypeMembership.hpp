@@ -0,0 +1,103 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef HAPLOTYPE_MEMBERSHIP_HPP
+#define HAPLOTYPE_MEMBERSHIP_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "variant/haplotype.hpp"
+
+namespace wecall
+{
+namespace variant
+{
+    /// Which haplotypes of a cluster contain each of its variants, and which are reference at each variant, as two
+    /// variants x haplotypes bit-matrices. It is built once per cluster so that the model and annotation stages
+    /// look up bits instead of building sets of haplotype indices per variant.
+    class HaplotypeMembership
+    {
+    public:
+        HaplotypeMembership( const HaplotypeVector & haplotypes, const std::vector< varPtr_t > & variants );
+
+        /// An empty membership, for callers which know the bits without the haplotypes themselves.
+        HaplotypeMembership( const std::size_t nVariants, const std::size_t nHaplotypes );
+
+        std::size_t nVariants() const { return m_nVariants; }
+        std::size_t nHaplotypes() const { return m_nHaplotypes; }
+
+        void setContainsVariant( const std::size_t variantIndex, const std::size_t haplotypeIndex )
+        {
+            set( m_containsVariant, variantIndex, haplotypeIndex );
+        }
+
+        void setIsReference( const std::size_t variantIndex, const std::size_t haplotypeIndex )
+        {
+            set( m_isReference, variantIndex, haplotypeIndex );
+        }
+
+        bool containsVariant( const std::size_t variantIndex, const std::size_t haplotypeIndex ) const
+        {
+            return isSet( m_containsVariant, variantIndex, haplotypeIndex );
+        }
+
+        bool isReference( const std::size_t variantIndex, const std::size_t haplotypeIndex ) const
+        {
+            return isSet( m_isReference, variantIndex, haplotypeIndex );
+        }
+
+        /// Sums of a per-haplotype value over the haplotypes containing the variant, and over the haplotypes which
+        /// are reference at the variant. Haplotypes are added in index order.
+        template < typename T >
+        double sumOverHaplotypesContainingVariant( const std::size_t variantIndex, const T * values ) const
+        {
+            return sumOverSetBits( m_containsVariant, variantIndex, values );
+        }
+
+        template < typename T >
+        double sumOverReferenceHaplotypes( const std::size_t variantIndex, const T * values ) const
+        {
+            return sumOverSetBits( m_isReference, variantIndex, values );
+        }
+
+    private:
+        void set( std::vector< uint64_t > & bits, const std::size_t variantIndex, const std::size_t haplotypeIndex )
+        {
+            bits[variantIndex * m_wordsPerVariant + haplotypeIndex / 64] |= uint64_t( 1 ) << ( haplotypeIndex % 64 );
+        }
+
+        bool isSet( const std::vector< uint64_t > & bits,
+                    const std::size_t variantIndex,
+                    const std::size_t haplotypeIndex ) const
+        {
+            return ( bits[variantIndex * m_wordsPerVariant + haplotypeIndex / 64] >> ( haplotypeIndex % 64 ) ) & 1u;
+        }
+
+        template < typename T >
+        double sumOverSetBits( const std::vector< uint64_t > & bits,
+                               const std::size_t variantIndex,
+                               const T * values ) const
+        {
+            double sum = 0.0;
+            for ( std::size_t word = 0; word < m_wordsPerVariant; ++word )
+            {
+                auto remaining = bits[variantIndex * m_wordsPerVariant + word];
+                while ( remaining != 0 )
+                {
+                    sum += values[64 * word + static_cast< std::size_t >( __builtin_ctzll( remaining ) )];
+                    remaining &= remaining - 1;
+                }
+            }
+            return sum;
+        }
+
+    private:
+        std::size_t m_nVariants;
+        std::size_t m_nHaplotypes;
+        std::size_t m_wordsPerVariant;
+        std::vector< uint64_t > m_containsVariant;
+        std::vector< uint64_t > m_isReference;
+    };
+}
+}
+
+#endif
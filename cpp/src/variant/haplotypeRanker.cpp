@@ -23,10 +23,15 @@ namespace variant
             return std::set< std::size_t >( v.begin(), v.end() );
         }
 
+        // Samples share one index of the haplotype sequences.
+        caller::HaplotypeIndex localHaplotypeIndex;
+        const auto sequenceIndex = m_haplotypeIndex == nullptr ? &localHaplotypeIndex : m_haplotypeIndex;
+
         std::vector< double > totalHaplotypeFrequencies( haplotypes.size(), 0.0 );
         for ( const auto & readRangePair : m_reads )
         {
-            const auto haplotypeLikelihoods = caller::computeHaplotypeLikelihoods( haplotypes, readRangePair.second );
+            const auto haplotypeLikelihoods = caller::computeHaplotypeLikelihoods( haplotypes, readRangePair.second,
+                                                                                   m_likelihoodCache, sequenceIndex );
             const auto haplotypeFrequencies = caller::computeHaplotypeFrequencies( haplotypeLikelihoods );
 
             for ( std::size_t haplotypeIndex = 0; haplotypeIndex != haplotypes.size(); ++haplotypeIndex )
@@ -8,6 +8,8 @@
 #include <io/readRange.hpp>
 
 #include "variant/haplotype.hpp"
+#include "caller/haplotypeIndex.hpp"
+#include "caller/readLikelihoodCache.hpp"
 
 namespace wecall
 {
@@ -21,13 +23,20 @@ namespace variant
     class AlignmentHaplotypeRanker
     {
     public:
-        AlignmentHaplotypeRanker( const io::perSampleRegionsReads_t & reads ) : m_reads( reads ) {}
+        AlignmentHaplotypeRanker( const io::perSampleRegionsReads_t & reads,
+                                  caller::ReadLikelihoodCache * likelihoodCache = nullptr,
+                                  caller::HaplotypeIndex * haplotypeIndex = nullptr )
+            : m_reads( reads ), m_likelihoodCache( likelihoodCache ), m_haplotypeIndex( haplotypeIndex )
+        {
+        }
 
         std::set< std::size_t > getTopHaplotypes( const HaplotypeVector & haplotypes,
                                                   const uint64_t maxHaplotypes ) const;
 
     private:
         io::perSampleRegionsReads_t m_reads;
+        caller::ReadLikelihoodCache * m_likelihoodCache;
+        caller::HaplotypeIndex * m_haplotypeIndex;
     };
 }
 }
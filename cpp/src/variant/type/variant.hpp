@@ -135,6 +135,7 @@ namespace variant
         void prior( const double prior ) { m_prior = std::max( prior, constants::minVariantPrior ); }
 
         std::vector< io::readPtr_t > getReads() const { return m_reads; }
+        std::size_t nReads() const { return m_reads.size(); }
         void addRead( io::readPtr_t readPtr ) { m_reads.push_back( readPtr ); }
 
     private:
@@ -81,7 +81,8 @@ namespace vcf
         {
             infoItems.push_back( idValuePair.first + "=" + boost::algorithm::join( idValuePair.second, "," ) );
         }
-        out << boost::algorithm::join( infoItems, ";" ) << constants::vcfRecordColumnSeparator;
+        out << ( infoItems.empty() ? constants::vcfUnknownValue : boost::algorithm::join( infoItems, ";" ) )
+            << constants::vcfRecordColumnSeparator;
 
         // Output sample info IDs first...
         std::vector< std::string > sampleColumns = {
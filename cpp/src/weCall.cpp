@@ -1,23 +1,34 @@
 // All content Copyright (C) 2018 Genomics plc
 #include "weCallMapAndReduce.hpp"
+#include "weCallMergeLikelihoods.hpp"
 #include "weCallReduce.hpp"
 
-int main( const int argc, char * argv[] )
+template < typename Command >
+int runSubcommand( const int argc, char * argv[] )
 {
-    if ( argc > 1 and strncmp( argv[1], "reduce", 7 ) == 0 )
+    // Shift command-line arguments up by one
+    char ** newArgv = new char * [argc - 1];
+    newArgv[0] = argv[0];
+
+    for ( std::size_t i = 1; i < static_cast< std::size_t >( argc - 1 ); ++i )
     {
-        // Shift command-line arguments up by one
-        char ** newArgv = new char * [argc - 1];
-        newArgv[0] = argv[0];
+        newArgv[i] = argv[i + 1];
+    }
 
-        for ( std::size_t i = 1; i < static_cast< std::size_t >( argc - 1 ); ++i )
-        {
-            newArgv[i] = argv[i + 1];
-        }
+    const auto rt = Command().processJob( argc - 1, newArgv );
+    delete[] newArgv;
+    return rt;
+}
 
-        const auto rt = wecall::weCallReduce().processJob( argc - 1, newArgv );
-        delete[] newArgv;
-        return rt;
+int main( const int argc, char * argv[] )
+{
+    if ( argc > 1 and strncmp( argv[1], "reduce", 7 ) == 0 )
+    {
+        return runSubcommand< wecall::weCallReduce >( argc, argv );
+    }
+    else if ( argc > 1 and strncmp( argv[1], "mergeLikelihoods", 17 ) == 0 )
+    {
+        return runSubcommand< wecall::weCallMergeLikelihoods >( argc, argv );
     }
     else
     {
@@ -72,61 +72,154 @@ int weCallMapAndReduce::processJob( int argc, char * argv[] )
         caller::params::Calling callingParams( optValues );
         caller::params::PrivateData privateOutputParams( optValues );
 
+        // All jobs reserve the memory of their reads from one budget.
+        utils::memoryBudgetPtr_t memoryBudget;
+        if ( systemParams.m_memoryBudget > 0 )
+        {
+            memoryBudget = std::make_shared< utils::MemoryBudget >(
+                static_cast< int64_t >( systemParams.m_memoryBudget ) * 1024 * 1024 );
+        }
+
+        // The input files are opened and their indices loaded once, for all jobs.
+        const auto inputContext =
+            std::make_shared< const caller::InputContext >( dataParams, systemParams, privateOutputParams );
+
+        // Jobs commit their likelihood records to a queue of their own, so that the file is in genome order like
+        // the VCF output and likelihood files can be merged as sorted streams.
+        std::unique_ptr< caller::JobOutputQueue > likelihoodQueue;
+        if ( not privateOutputParams.m_likelihoodsOutput.empty() )
+        {
+            likelihoodQueue.reset( new caller::JobOutputQueue( privateOutputParams.m_likelihoodsOutput,
+                                                               dataParams.workDir(),
+                                                               caller::params::defaults::maxHeldOutputBytes ) );
+
+            caller::LikelihoodFileHeader header;
+            header.sampleNames = inputContext->sampleNames();
+            header.ploidy = privateCallingParams.m_ploidy;
+            header.genotypingMode = privateOutputParams.genotypingMode();
+            likelihoodQueue->writeHeader( caller::serialiseLikelihoodFileHeader( header ) );
+        }
+        const auto setLikelihoodRecordCommitter = [&likelihoodQueue]( caller::Job & job, const std::string & jobName )
+        {
+            if ( likelihoodQueue != nullptr )
+            {
+                job.setLikelihoodRecordCommitter( [&likelihoodQueue, jobName]( const std::string & records )
+                                                  {
+                                                      likelihoodQueue->commit( jobName, records );
+                                                  } );
+            }
+        };
+
         if ( systemParams.m_numberOfJobs == 0 )
         {
             WECALL_LOG( INFO, "Will run in serial mode" );
 
+            const auto jobName = dataParams.outputDataSink();
             caller::Job job( applicationParams, dataParams, systemParams, privateSystemParams, filterParams,
-                             privateCallingParams, callingParams, privateOutputParams );
+                             privateCallingParams, callingParams, privateOutputParams, nullptr, inputContext );
+            setLikelihoodRecordCommitter( job, jobName );
+            job.setMemoryBudget( memoryBudget );
 
+            if ( likelihoodQueue != nullptr )
+            {
+                likelihoodQueue->addJob( jobName );
+            }
             job.process();
+            if ( likelihoodQueue != nullptr )
+            {
+                likelihoodQueue->finishJob( jobName );
+            }
         }
         else
         {
-            const caller::params::Reduce reduceParams( dataParams.workDir(), dataParams.outputDataSink() );
-            caller::params::validateReduceParamsPreMap( reduceParams );
-
-            std::shared_ptr< boost::asio::io_service > ioService( new boost::asio::io_service );
-            std::shared_ptr< boost::asio::io_service::work > work( new boost::asio::io_service::work( *ioService ) );
-
             WECALL_LOG( INFO, "Will run " << systemParams.m_numberOfJobs << " jobs simultaneously, where possible" );
-            boost::thread_group threadPool;
-            for ( std::size_t i = 0; i < systemParams.m_numberOfJobs; ++i )
+            utils::WorkStealingScheduler scheduler( systemParams.m_numberOfJobs );
+
+            // Jobs commit their output to the queue as they go, which writes it to the output file in genome order.
+            caller::JobOutputQueue outputQueue( dataParams.outputDataSink(), dataParams.workDir(),
+                                                caller::params::defaults::maxHeldOutputBytes );
             {
-                threadPool.create_thread( boost::bind( &boost::asio::io_service::run, ioService ) );
+                std::ostringstream header;
+                io::VCFWriter headerWriter( header, dataParams.outputDataSink(), dataParams.outputRefCalls(),
+                                            callingParams.m_outputPhasedGenotypes );
+                caller::writeVCFHeader( headerWriter, applicationParams, dataParams, privateCallingParams,
+                                        callingParams, inputContext->sampleNames(),
+                                        inputContext->reference()->indexFile() );
+                outputQueue.writeHeader( header.str() );
             }
 
-            const std::vector< caller::params::Data > chunkedDataParams = dataParams.splitWorkload();
+            const std::vector< caller::params::Data > chunkedDataParams =
+                dataParams.splitWorkload( systemParams.m_numberOfJobs, systemParams.m_shardSize );
 
-            for ( std::size_t i = 0; i < chunkedDataParams.size(); ++i )
+            // Jobs split off the rest of their work when a worker runs out of jobs, and schedule it themselves.
+            std::function< void( const caller::params::Data & ) > scheduleJob;
+            scheduleJob = [&]( const caller::params::Data & jobDataParams ) -> void
             {
-                const auto jobProcessor = [&]( std::size_t jobIndex ) -> void
+                const auto jobName = jobDataParams.outputDataSink();
+                const auto jobProcessor = [&, jobDataParams, jobName]() -> void
                 {
-                    WECALL_LOG( INFO, "Started job " << jobIndex );
-
-                    caller::Job job( applicationParams, chunkedDataParams[jobIndex], systemParams, privateSystemParams,
-                                     filterParams, privateCallingParams, callingParams, privateOutputParams );
+                    WECALL_LOG( INFO, "Started job " << jobName );
+
+                    caller::Job job( applicationParams, jobDataParams, systemParams, privateSystemParams,
+                                     filterParams, privateCallingParams, callingParams, privateOutputParams,
+                                     [&outputQueue, jobName]( const std::string & output )
+                                     {
+                                         outputQueue.commit( jobName, output );
+                                     },
+                                     inputContext );
+                    job.setWorkSplitter( [&scheduler]()
+                                         {
+                                             return scheduler.hasIdleWorkers();
+                                         },
+                                         scheduleJob );
+                    setLikelihoodRecordCommitter( job, jobName );
+                    job.setMemoryBudget( memoryBudget );
 
                     job.process();
+                    outputQueue.finishJob( jobName );
+                    if ( likelihoodQueue != nullptr )
+                    {
+                        likelihoodQueue->finishJob( jobName );
+                    }
 
-                    WECALL_LOG( INFO, "Finished job " << jobIndex );
+                    WECALL_LOG( INFO, "Finished job " << jobName );
                 };
 
-                ioService->post( boost::lambda::bind( jobProcessor, i ) );
+                outputQueue.addJob( jobName );
+                if ( likelihoodQueue != nullptr )
+                {
+                    likelihoodQueue->addJob( jobName );
+                }
+                scheduler.schedule( jobProcessor );
 
-                WECALL_LOG( INFO, "Posted job " << i );
-            }
+                WECALL_LOG( INFO, "Posted job " << jobName );
+            };
 
-            work.reset();
+            for ( const auto & jobDataParams : chunkedDataParams )
+            {
+                scheduleJob( jobDataParams );
+            }
 
             WECALL_LOG( INFO, "Waiting for all jobs to finish" );
 
-            threadPool.join_all();
+            scheduler.run();
+            outputQueue.close();
+
+            WECALL_LOG( INFO, "All jobs finished" );
+        }
 
-            WECALL_LOG( INFO, "Joined all threads" );
+        if ( likelihoodQueue != nullptr )
+        {
+            likelihoodQueue->close();
+        }
 
-            caller::JobReduce( reduceParams ).process();
+        if ( memoryBudget != nullptr )
+        {
+            const auto peakMB = memoryBudget->peak() / ( 1024 * 1024 );
+            WECALL_LOG( INFO, "Peak memory reserved for reads: " << peakMB << " MB of a "
+                                                                 << systemParams.m_memoryBudget << " MB budget" );
         }
+        WECALL_LOG( INFO, "Peak resident memory: " << utils::peakResidentBytes() / ( 1024 * 1024 ) << " MB" );
 
         WECALL_LOG( DEBUG, m_programName + " completed" );
     }
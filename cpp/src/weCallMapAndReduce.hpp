@@ -2,10 +2,10 @@
 #ifndef WECALL_MAP_HPP
 #define WECALL_MAP_HPP
 
+#include <functional>
 #include <iomanip>
 
 #include <boost/program_options.hpp>
-#include <boost/asio/io_service.hpp>
 #include <boost/bind.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/algorithm/string.hpp>
@@ -13,9 +13,10 @@
 #include <boost/lambda/bind.hpp>
 #include <boost/lambda/construct.hpp>
 
-#include "caller/jobReduce.hpp"
+#include "caller/jobOutputQueue.hpp"
 #include "common.hpp"
 #include "caller/job.hpp"
+#include "utils/workStealingScheduler.hpp"
 #include "version/version.hpp"
 #include "weCallBase.hpp"
 
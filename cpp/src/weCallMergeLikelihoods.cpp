@@ -0,0 +1,67 @@
+// All content Copyright (C) 2018 Genomics plc
+#include "weCallMergeLikelihoods.hpp"
+
+namespace wecall
+{
+using namespace boost::program_options;
+
+weCallMergeLikelihoods::weCallMergeLikelihoods() : weCallBase( constants::weCallString + " mergeLikelihoods" )
+{
+    initOptions();
+}
+
+int weCallMergeLikelihoods::processJob( int argc, char * argv[] )
+{
+    try
+    {
+        variables_map optValues;
+
+        basic_parsed_options< char > cmdLineValues =
+            command_line_parser( argc, argv )
+                .options( m_cmdLineOpts )
+                .style( command_line_style::default_style & ~command_line_style::allow_guessing )
+                .run();
+
+        store( cmdLineValues, optValues );
+
+        if ( optValues.count( "help" ) )
+        {
+            std::cout << m_publicOpts << std::endl;
+            return 0;
+        }
+
+        notify( optValues );
+
+        caller::params::Logging loggingParams( optValues );
+        utils::initialiseLog( loggingParams.m_logLevel, loggingParams.m_logFilename, loggingParams.m_quietMode,
+                              loggingParams.m_verbosity, loggingParams.m_logTimings );
+
+        caller::params::Application applicationParams( m_programName, m_programVersion, g_GIT_SHA1, g_BUILD_DATE,
+                                                       "" );
+        caller::params::MergeLikelihoods mergeParams( optValues );
+        caller::params::PrivateCalling privateCallingParams( optValues );
+        caller::params::Calling callingParams( optValues );
+        caller::JobMergeLikelihoods( mergeParams, applicationParams, privateCallingParams, callingParams ).process();
+    }
+    catch ( std::exception & e )
+    {
+        std::cerr << "FAILED - " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+void weCallMergeLikelihoods::initOptions()
+{
+    options_description basicOpts( "Basic Parameters", caller::params::PARAM_HELP_DISPLAY_WIDTH );
+    basicOpts.add_options()( "help,h", "produce help message" );
+
+    m_publicOpts.add( caller::params::MergeLikelihoods::getOptionsDescription() );
+    m_publicOpts.add( caller::params::Calling::getOptionsDescription() );
+    m_publicOpts.add( caller::params::Logging::getOptionsDescription() );
+    m_publicOpts.add( basicOpts );
+
+    m_cmdLineOpts.add( m_publicOpts ).add( caller::params::PrivateCalling::getOptionsDescription() );
+}
+}
@@ -0,0 +1,28 @@
+// All content Copyright (C) 2018 Genomics plc
+#ifndef WECALL_MERGE_LIKELIHOODS_HPP
+#define WECALL_MERGE_LIKELIHOODS_HPP
+
+#include <boost/program_options.hpp>
+
+#include "caller/jobMergeLikelihoods.hpp"
+#include "common.hpp"
+#include "version/version.hpp"
+#include "weCallBase.hpp"
+
+namespace wecall
+{
+class weCallMergeLikelihoods : public weCallBase
+{
+public:
+    weCallMergeLikelihoods();
+
+    int processJob( int argc, char * argv[] );
+
+private:
+    void initOptions();
+
+    boost::program_options::options_description m_cmdLineOpts;
+};
+}
+
+#endif
@@ -0,0 +1,121 @@
+// All content Copyright (C) 2018 Genomics plc
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+
+#include "caller/jobOutputQueue.hpp"
+#include "utils/exceptions.hpp"
+
+using wecall::caller::JobOutputQueue;
+
+namespace
+{
+    struct JobOutputQueueTestFiles
+    {
+        JobOutputQueueTestFiles()
+            : m_directory( boost::filesystem::temp_directory_path() / boost::filesystem::unique_path( "%%%%-%%%%" ) ),
+              m_outputFilename( ( m_directory / "output.vcf" ).string() ),
+              m_workDir( ( m_directory / "workDir" ).string() )
+        {
+            boost::filesystem::create_directories( m_directory );
+        }
+
+        ~JobOutputQueueTestFiles() { boost::filesystem::remove_all( m_directory ); }
+
+        std::string readOutput() const
+        {
+            std::ifstream in( m_outputFilename );
+            std::stringstream contents;
+            contents << in.rdbuf();
+            return contents.str();
+        }
+
+        const boost::filesystem::path m_directory;
+        const std::string m_outputFilename;
+        const std::string m_workDir;
+    };
+
+    const std::size_t unlimitedHeldBytes = 1024 * 1024;
+}
+
+BOOST_AUTO_TEST_CASE( testJobOutputQueueWritesJobsInNameOrder )
+{
+    const JobOutputQueueTestFiles files;
+    JobOutputQueue queue( files.m_outputFilename, files.m_workDir, unlimitedHeldBytes );
+    queue.writeHeader( "header\n" );
+    queue.addJob( "00000.vcf" );
+    queue.addJob( "00001.vcf" );
+
+    queue.commit( "00001.vcf", "b1\n" );
+    queue.commit( "00000.vcf", "a1\n" );
+
+    // A job split off the first job sorts between the first and second jobs.
+    queue.addJob( "00000_000000001000.vcf" );
+    queue.commit( "00000_000000001000.vcf", "c1\n" );
+    queue.finishJob( "00000_000000001000.vcf" );
+    queue.finishJob( "00001.vcf" );
+
+    queue.commit( "00000.vcf", "a2\n" );
+    queue.finishJob( "00000.vcf" );
+    queue.close();
+
+    BOOST_CHECK_EQUAL( files.readOutput(), "header\na1\na2\nc1\nb1\n" );
+}
+
+BOOST_AUTO_TEST_CASE( testJobOutputQueueWritesOutputOfFirstJobStraightAway )
+{
+    const JobOutputQueueTestFiles files;
+    JobOutputQueue queue( files.m_outputFilename, files.m_workDir, unlimitedHeldBytes );
+    queue.addJob( "00000.vcf" );
+    queue.addJob( "00001.vcf" );
+
+    queue.commit( "00000.vcf", "a1\n" );
+    queue.commit( "00001.vcf", "b1\n" );
+    BOOST_CHECK_EQUAL( files.readOutput(), "a1\n" );
+
+    queue.finishJob( "00000.vcf" );
+    BOOST_CHECK_EQUAL( files.readOutput(), "a1\nb1\n" );
+
+    queue.finishJob( "00001.vcf" );
+    queue.close();
+}
+
+BOOST_AUTO_TEST_CASE( testJobOutputQueueThrowsIfClosedBeforeAllJobsFinish )
+{
+    const JobOutputQueueTestFiles files;
+    JobOutputQueue queue( files.m_outputFilename, files.m_workDir, unlimitedHeldBytes );
+    queue.addJob( "00000.vcf" );
+
+    BOOST_CHECK_THROW( queue.close(), wecall::utils::wecall_exception );
+}
+
+BOOST_AUTO_TEST_CASE( testJobOutputQueueSpillsHeldOutputBeyondLimitToWorkDir )
+{
+    const JobOutputQueueTestFiles files;
+    JobOutputQueue queue( files.m_outputFilename, files.m_workDir, 4 );
+    queue.addJob( "00000.vcf" );
+    queue.addJob( "00001.vcf" );
+    queue.addJob( "00002.vcf" );
+
+    queue.commit( "00001.vcf", "b1\n" );
+    BOOST_CHECK( not boost::filesystem::exists( files.m_workDir ) );
+
+    queue.commit( "00002.vcf", "c1\n" );
+    queue.commit( "00002.vcf", "c2\n" );
+    BOOST_CHECK_EQUAL( std::distance( boost::filesystem::directory_iterator( files.m_workDir ),
+                                      boost::filesystem::directory_iterator() ),
+                       1 );
+
+    queue.commit( "00000.vcf", "a1\n" );
+    queue.finishJob( "00002.vcf" );
+    queue.finishJob( "00000.vcf" );
+    queue.commit( "00001.vcf", "b2\n" );
+    queue.finishJob( "00001.vcf" );
+    queue.close();
+
+    BOOST_CHECK_EQUAL( files.readOutput(), "a1\nb1\nb2\nc1\nc2\n" );
+    BOOST_CHECK( boost::filesystem::is_empty( files.m_workDir ) );
+}
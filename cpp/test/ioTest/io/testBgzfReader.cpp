@@ -0,0 +1,102 @@
+// All content Copyright (C) 2018 Genomics plc
+#include "io/bgzfReader.hpp"
+
+extern "C" {
+#include "samtools/bgzf.h"
+}
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+using wecall::io::BgzfDecoderPool;
+using wecall::io::BgzfFile;
+using wecall::io::BgzfReader;
+
+namespace
+{
+    /// A BGZF file of several blocks, with the samtools virtual offsets of the starts of its records.
+    struct BgzfFileFixture
+    {
+        BgzfFileFixture()
+            : filename( ( boost::filesystem::temp_directory_path() /
+                          boost::filesystem::unique_path( "%%%%-%%%%.bgzf" ) ).string() )
+        {
+            BGZF * file = bgzf_open( filename.c_str(), "w" );
+            for ( int recordIndex = 0; recordIndex < 20000; ++recordIndex )
+            {
+                const std::string record = "record" + std::to_string( recordIndex ) + ";";
+                offsets.push_back( bgzf_tell( file ) );
+                records.push_back( record );
+                bgzf_write( file, record.data(), record.size() );
+                content += record;
+            }
+            bgzf_close( file );
+        }
+
+        ~BgzfFileFixture() { boost::filesystem::remove( filename ); }
+
+        const std::string filename;
+        std::vector< uint64_t > offsets;
+        std::vector< std::string > records;
+        std::string content;
+    };
+
+    std::string readString( BgzfReader & reader, const std::size_t length )
+    {
+        std::string value( length, '\0' );
+        value.resize( reader.read( &value[0], length ) );
+        return value;
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE( testBgzfReaderReadsWholeFileWithAndWithoutDecoderThreads, BgzfFileFixture )
+{
+    for ( const std::size_t nThreads : {0, 1, 3} )
+    {
+        BgzfReader reader( std::make_shared< BgzfFile >( filename, std::make_shared< BgzfDecoderPool >( nThreads ) ) );
+        reader.seek( 0 );
+        reader.setReadAheadLimit( std::numeric_limits< uint64_t >::max() );
+
+        BOOST_CHECK_EQUAL( readString( reader, content.size() + 100 ), content );
+        BOOST_CHECK_EQUAL( reader.bytesDecompressed(), content.size() );
+        BOOST_CHECK_EQUAL( readString( reader, 1 ), "" );
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE( testBgzfReaderVirtualOffsetsMatchSamtools, BgzfFileFixture )
+{
+    BgzfReader reader( std::make_shared< BgzfFile >( filename, std::make_shared< BgzfDecoderPool >( 2 ) ) );
+    reader.seek( offsets.front() );
+    reader.setReadAheadLimit( offsets.back() );
+    for ( std::size_t recordIndex = 0; recordIndex + 1 < records.size(); ++recordIndex )
+    {
+        BOOST_REQUIRE_EQUAL( readString( reader, records[recordIndex].size() ), records[recordIndex] );
+        BOOST_REQUIRE_EQUAL( reader.tell(), offsets[recordIndex + 1] );
+    }
+
+    for ( const std::size_t recordIndex : {17000, 3, 12345, 0} )
+    {
+        reader.seek( offsets[recordIndex] );
+        BOOST_CHECK_EQUAL( reader.tell(), offsets[recordIndex] );
+        BOOST_CHECK_EQUAL( readString( reader, records[recordIndex].size() ), records[recordIndex] );
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE( testBgzfDecoderPoolIsSharedBetweenFilesAndCappedAtTheCores, BgzfFileFixture )
+{
+    const auto pool = BgzfDecoderPool::processPool( 1000 );
+    BOOST_CHECK_EQUAL( BgzfDecoderPool::processPool( 1 ), pool );
+
+    const std::size_t numberOfCores = std::thread::hardware_concurrency();
+    BOOST_CHECK_EQUAL( pool->nThreads(), numberOfCores > 0 ? numberOfCores : 1000 );
+
+    BgzfFile firstFile( filename, pool );
+    BgzfFile secondFile( filename, BgzfDecoderPool::processPool( 2 ) );
+    BOOST_CHECK_EQUAL( &firstFile.pool(), &secondFile.pool() );
+}
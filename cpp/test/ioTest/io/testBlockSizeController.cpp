@@ -0,0 +1,48 @@
+// All content Copyright (C) 2018 Genomics plc
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "io/blockSizeController.hpp"
+
+using wecall::io::BlockSizeController;
+
+BOOST_AUTO_TEST_CASE( testBlockSizeControllerUsesMaximumSizesBeforeFirstBlock )
+{
+    const BlockSizeController controller( 100000, 1000, 1000000 );
+    BOOST_CHECK_EQUAL( controller.blockSize(), 100000 );
+    BOOST_CHECK_EQUAL( controller.biteSize(), 1000 );
+    BOOST_CHECK_EQUAL( controller.bytesPerBase(), 0.0 );
+}
+
+BOOST_AUTO_TEST_CASE( testBlockSizeControllerShrinksBlocksToTargetForDenseData )
+{
+    BlockSizeController controller( 100000, 1000, 1000000 );
+    controller.recordBlock( 10000, 10000000 );
+
+    BOOST_CHECK_EQUAL( controller.bytesPerBase(), 1000.0 );
+    BOOST_CHECK_EQUAL( controller.blockSize(), 1000 );
+    BOOST_CHECK_EQUAL( controller.biteSize(), 50 );
+}
+
+BOOST_AUTO_TEST_CASE( testBlockSizeControllerKeepsWithinConfiguredMaximum )
+{
+    BlockSizeController controller( 100000, 1000, 1000000 );
+    controller.recordBlock( 100000, 100000 );
+
+    BOOST_CHECK_EQUAL( controller.blockSize(), 100000 );
+    BOOST_CHECK_EQUAL( controller.biteSize(), 1000 );
+}
+
+BOOST_AUTO_TEST_CASE( testBlockSizeControllerRisesAtOnceAndFallsBackSlowly )
+{
+    BlockSizeController controller( 100000, 1000, 1000000 );
+    controller.recordBlock( 1000, 100000 );
+    controller.recordBlock( 1000, 400000 );
+    BOOST_CHECK_EQUAL( controller.bytesPerBase(), 400.0 );
+
+    controller.recordBlock( 1000, 0 );
+    BOOST_CHECK_EQUAL( controller.bytesPerBase(), 300.0 );
+
+    controller.recordBlock( 0, 1000000 );
+    BOOST_CHECK_EQUAL( controller.bytesPerBase(), 300.0 );
+}
@@ -0,0 +1,118 @@
+// All content Copyright (C) 2018 Genomics plc
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "io/readArena.hpp"
+#include "io/readDataSet.hpp"
+#include "samtools/bam.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using wecall::io::ReadArena;
+using wecall::io::ReadDataset;
+using wecall::caller::Region;
+using wecall::utils::ReferenceSequence;
+
+namespace
+{
+    /// An all-match BAM record with a read group, laid out as samtools lays out records read from a file.
+    struct BamRecord
+    {
+        BamRecord( const std::string & qname,
+                   const std::string & bases,
+                   const std::string & qualities,
+                   const int32_t startPos,
+                   const std::string & readGroupID )
+        {
+            std::memset( &record, 0, sizeof( record ) );
+            record.core.pos = startPos;
+            record.core.qual = 60;
+            record.core.l_qname = qname.size() + 1;
+            record.core.n_cigar = 1;
+            record.core.l_qseq = int32_t( bases.size() );
+
+            data.insert( data.end(), qname.cbegin(), qname.cend() );
+            data.push_back( 0 );
+
+            const uint32_t cigar = uint32_t( bases.size() ) << BAM_CIGAR_SHIFT | BAM_CMATCH;
+            data.resize( data.size() + sizeof( cigar ) );
+            std::memcpy( &data[data.size() - sizeof( cigar )], &cigar, sizeof( cigar ) );
+
+            for ( std::size_t baseIndex = 0; baseIndex < bases.size(); baseIndex += 2 )
+            {
+                const auto high = bam_nt16_table[int( bases[baseIndex] )];
+                const auto low = baseIndex + 1 < bases.size() ? bam_nt16_table[int( bases[baseIndex + 1] )] : 0;
+                data.push_back( uint8_t( high << 4 | low ) );
+            }
+            data.insert( data.end(), qualities.cbegin(), qualities.cend() );
+
+            const auto auxStart = data.size();
+            data.push_back( 'R' );
+            data.push_back( 'G' );
+            data.push_back( 'Z' );
+            data.insert( data.end(), readGroupID.cbegin(), readGroupID.cend() );
+            data.push_back( 0 );
+
+            record.l_aux = int( data.size() - auxStart );
+            record.data_len = int( data.size() );
+            record.m_data = int( data.size() );
+            record.data = data.data();
+        }
+
+        bam1_t record;
+        std::vector< uint8_t > data;
+    };
+}
+
+BOOST_AUTO_TEST_CASE( testDecodeBamBasesDecodesTwoBasesPerByteAndOddTail )
+{
+    const std::vector< uint8_t > packed = {0x12, 0x48, 0xf0};
+    std::string bases( 5, ' ' );
+    wecall::io::decodeBamBases( packed.data(), bases.size(), &bases[0] );
+    BOOST_CHECK_EQUAL( bases, "ACGTN" );
+}
+
+BOOST_AUTO_TEST_CASE( testReadArenaConstructsReadsFromBamRecords )
+{
+    const auto refSequence = std::make_shared< ReferenceSequence >( Region( "1", 100, 110 ), "ACGTACGTAC" );
+    const BamRecord referenceRecord( "ref", "CGTAC", "ABCDE", 101, "rg1" );
+    const BamRecord variantRecord( "var", "CGAACG", "FGHIJK", 101, "rg2" );
+
+    const auto arena = std::make_shared< ReadArena >();
+    const auto referenceRead = arena->makeRead( wecall::io::Read( &referenceRecord.record, refSequence ) );
+    const auto variantRead = arena->makeRead( wecall::io::Read( &variantRecord.record, refSequence ) );
+    BOOST_CHECK_EQUAL( arena->size(), 2 );
+    BOOST_CHECK_GE( arena->bytesUsed(), 2 * sizeof( wecall::io::Read ) );
+
+    BOOST_CHECK( referenceRead->isReference() );
+    BOOST_CHECK_EQUAL( referenceRead->sequence(), "CGTAC" );
+    BOOST_CHECK_EQUAL( referenceRead->getQualities(), "ABCDE" );
+    BOOST_CHECK_EQUAL( referenceRead->getQName(), "ref" );
+    BOOST_CHECK_EQUAL( referenceRead->getReadGroupID(), "rg1" );
+    BOOST_CHECK_EQUAL( referenceRead->getAlignedEndPos(), 106 );
+
+    BOOST_CHECK( not variantRead->isReference() );
+    BOOST_CHECK_EQUAL( variantRead->sequence(), "CGAACG" );
+    BOOST_CHECK_EQUAL( variantRead->getQualities(), "FGHIJK" );
+    BOOST_CHECK_EQUAL( variantRead->getReadGroupID(), "rg2" );
+}
+
+BOOST_AUTO_TEST_CASE( testReadsOfDatasetOutliveDatasetWhileHeld )
+{
+    const auto refSequence = std::make_shared< ReferenceSequence >( Region( "1", 100, 110 ), "ACGTACGTAC" );
+    const BamRecord record( "read", "GTACG", "ABCDE", 102, "rg" );
+
+    wecall::io::readPtr_t read;
+    {
+        ReadDataset dataset( {"sample"}, Region( "1", 100, 110 ) );
+        read = dataset.arena().makeRead( wecall::io::Read( &record.record, refSequence ) );
+        dataset.insertRead( "sample", read );
+        BOOST_CHECK_EQUAL( dataset.bytesUsed(),
+                           int64_t( dataset.arena().bytesUsed() ) + ReadDataset::indexBytesPerRead );
+    }
+
+    BOOST_CHECK_EQUAL( read->sequence(), "GTACG" );
+    BOOST_CHECK_EQUAL( read->getStartPos(), 102 );
+}
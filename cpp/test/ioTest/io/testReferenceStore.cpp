@@ -0,0 +1,109 @@
+// All content Copyright (C) 2018 Genomics plc
+#include "io/referenceStore.hpp"
+#include "ioFixture.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cctype>
+#include <string>
+#include <thread>
+#include <vector>
+
+using wecall::caller::Region;
+using wecall::io::FastaFile;
+using wecall::io::FastaIndex;
+using wecall::io::ReferenceStore;
+
+namespace
+{
+    /// A FASTA file with lower case bases and Windows line breaks.
+    struct SoftMaskedFastaFixture
+    {
+        SoftMaskedFastaFixture()
+            : refFilename( wecall::test::fs::temp_directory_path().generic_string() + "/softMasked.fa" ),
+              indexFilename( refFilename + ".fai" )
+        {
+            wecall::test::writeFile( indexFilename, "1\t25\t4\t10\t12\n" );
+            wecall::test::writeFile( refFilename, ">1\r\nACGTacgtNN\r\nnnACgtTTaa\r\nGGccA\r\n" );
+        }
+
+        ~SoftMaskedFastaFixture()
+        {
+            wecall::test::fs::remove( refFilename );
+            wecall::test::fs::remove( indexFilename );
+        }
+
+        std::shared_ptr< const ReferenceStore > makeStore() const
+        {
+            return std::make_shared< const ReferenceStore >( refFilename,
+                                                             std::make_shared< const FastaIndex >( indexFilename ) );
+        }
+
+        const std::string refFilename;
+        const std::string indexFilename;
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( testReferenceStoreUpperCasesAndSkipsLineBreaks, SoftMaskedFastaFixture )
+{
+    const auto store = this->makeStore();
+
+    std::string sequence;
+    store->appendSequence( Region( "1", 0, 25 ), sequence );
+    BOOST_CHECK_EQUAL( sequence, "ACGTACGTNNNNACGTTTAAGGCCA" );
+
+    sequence = "X";
+    store->appendSequence( Region( "1", 8, 13 ), sequence );
+    BOOST_CHECK_EQUAL( sequence, "XNNNNA" );
+
+    BOOST_CHECK_THROW( store->appendSequence( Region( "1", 20, 26 ), sequence ), wecall::utils::wecall_exception );
+}
+
+BOOST_FIXTURE_TEST_CASE( testReferenceStoreIsSharedBetweenThreads, SoftMaskedFastaFixture )
+{
+    const auto store = this->makeStore();
+
+    std::vector< std::string > sequences( 4 );
+    std::vector< std::thread > threads;
+    for ( std::size_t threadIndex = 0; threadIndex < sequences.size(); ++threadIndex )
+    {
+        threads.emplace_back( [&store, &sequences, threadIndex]()
+                              {
+                                  const FastaFile reference( store );
+                                  for ( int i = 0; i < 1000; ++i )
+                                  {
+                                      sequences[threadIndex] = reference.getSequence( Region( "1", -2, 27 ) )
+                                                                   .sequence()
+                                                                   .str();
+                                  }
+                              } );
+    }
+    for ( auto & thread : threads )
+    {
+        thread.join();
+    }
+
+    for ( const auto & sequence : sequences )
+    {
+        BOOST_CHECK_EQUAL( sequence, "NNACGTACGTNNNNACGTTTAAGGCCANN" );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( testCopyUpperCaseConvertsOnlyLowerCaseLetters )
+{
+    std::string bases;
+    for ( int character = 1; character < 256; ++character )
+    {
+        bases.push_back( static_cast< char >( character ) );
+    }
+
+    std::string upperCase( bases.size(), '\0' );
+    wecall::io::copyUpperCase( bases.data(), bases.size(), &upperCase[0] );
+
+    for ( std::size_t i = 0; i < bases.size(); ++i )
+    {
+        const auto base = static_cast< unsigned char >( bases[i] );
+        BOOST_CHECK_EQUAL( static_cast< unsigned char >( upperCase[i] ), std::islower( base ) ? base - 32 : base );
+    }
+}
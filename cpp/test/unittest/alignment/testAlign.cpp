@@ -0,0 +1,155 @@
+// All content Copyright (C) 2018 Genomics plc
+#include "alignment/align.hpp"
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+using wecall::alignment::NeedlemanWunschTask;
+using wecall::alignment::SimdInstructionSet;
+
+namespace
+{
+    struct RandomAlignments
+    {
+        RandomAlignments( std::mt19937 & generator, const std::size_t numberOfReads, const unsigned int readLength )
+            : m_readLength( readLength ),
+              m_haplotypes( numberOfReads ),
+              m_reads( numberOfReads ),
+              m_quals( numberOfReads )
+        {
+            const std::string bases = "ACGTN";
+            std::uniform_int_distribution< int > base( 0, 4 );
+            std::uniform_int_distribution< int > qual( 0, 40 );
+            std::uniform_int_distribution< int > gapOpen( 5, 60 );
+            std::uniform_int_distribution< int > mutation( 0, 9 );
+
+            for ( std::size_t i = 0; i < numberOfReads; ++i )
+            {
+                // Reads are mutated haplotypes so that alignments contain matches as well as indels.
+                for ( unsigned int j = 0; j < readLength + 15; ++j )
+                {
+                    m_haplotypes[i].push_back( bases[base( generator )] );
+                }
+                unsigned int start = 7;
+                while ( m_reads[i].size() < readLength )
+                {
+                    const auto change = mutation( generator );
+                    if ( change == 0 )
+                    {
+                        m_reads[i].push_back( bases[base( generator )] );
+                    }
+                    else if ( change == 1 )
+                    {
+                        ++start;
+                    }
+                    else
+                    {
+                        m_reads[i].push_back( m_haplotypes[i][start++ % m_haplotypes[i].size()] );
+                    }
+                    m_quals[i].push_back( static_cast< char >( qual( generator ) ) );
+                }
+                m_quals[i].resize( readLength );
+            }
+
+            m_localGapOpen.resize( numberOfReads * ( readLength + 15 ) );
+            for ( auto & penalty : m_localGapOpen )
+            {
+                penalty = static_cast< int16_t >( gapOpen( generator ) );
+            }
+        }
+
+        std::vector< NeedlemanWunschTask > tasks() const
+        {
+            std::vector< NeedlemanWunschTask > tasks;
+            for ( std::size_t i = 0; i < m_reads.size(); ++i )
+            {
+                tasks.push_back( {m_haplotypes[i].cbegin(), m_reads[i].cbegin(), m_quals[i].c_str(),
+                                  m_localGapOpen.data() + i * ( m_readLength + 15 )} );
+            }
+            return tasks;
+        }
+
+        int sse2Score( const std::size_t i,
+                       const unsigned short gapExtend,
+                       const unsigned short nucPrior,
+                       const bool backtrace ) const
+        {
+            std::vector< char > aln1( 2 * m_readLength + 16 );
+            std::vector< char > aln2( 2 * m_readLength + 16 );
+            int firstPos;
+            return wecall::alignment::needlemanWunschAlignment(
+                m_haplotypes[i].cbegin(), m_reads[i].cbegin(), m_quals[i].c_str(), m_readLength + 15, m_readLength,
+                gapExtend, nucPrior, m_localGapOpen, backtrace ? aln1.data() : nullptr,
+                backtrace ? aln2.data() : nullptr, &firstPos, static_cast< int >( i * ( m_readLength + 15 ) ) );
+        }
+
+        const unsigned int m_readLength;
+        std::vector< std::string > m_haplotypes;
+        std::vector< std::string > m_reads;
+        std::vector< std::string > m_quals;
+        wecall::alignment::localGapOpenPenalties_t m_localGapOpen;
+    };
+
+    std::vector< SimdInstructionSet > supportedInstructionSets()
+    {
+        std::vector< SimdInstructionSet > instructionSets = {SimdInstructionSet::scalar, SimdInstructionSet::sse2};
+        const auto best = wecall::alignment::bestSupportedInstructionSet();
+        if ( best == SimdInstructionSet::avx2 or best == SimdInstructionSet::avx512bw )
+        {
+            instructionSets.push_back( SimdInstructionSet::avx2 );
+        }
+        if ( best == SimdInstructionSet::avx512bw )
+        {
+            instructionSets.push_back( SimdInstructionSet::avx512bw );
+        }
+        return instructionSets;
+    }
+}
+
+BOOST_AUTO_TEST_CASE( testAlignmentLanesOfInstructionSets )
+{
+    BOOST_CHECK_EQUAL( wecall::alignment::alignmentLanes( SimdInstructionSet::scalar ), 1 );
+    BOOST_CHECK_EQUAL( wecall::alignment::alignmentLanes( SimdInstructionSet::sse2 ), 1 );
+    BOOST_CHECK_EQUAL( wecall::alignment::alignmentLanes( SimdInstructionSet::avx2 ), 2 );
+    BOOST_CHECK_EQUAL( wecall::alignment::alignmentLanes( SimdInstructionSet::avx512bw ), 4 );
+}
+
+BOOST_AUTO_TEST_CASE( testNeedlemanWunschScoresMatchSSE2AlignmentForAllInstructionSets )
+{
+    std::mt19937 generator( 42 );
+    const std::vector< unsigned int > readLengths = {1, 2, 7, 8, 9, 16, 50, 101, 150};
+
+    for ( const auto instructionSet : supportedInstructionSets() )
+    {
+        for ( const auto readLength : readLengths )
+        {
+            for ( const std::size_t numberOfReads : {1, 3, 4, 7} )
+            {
+                const RandomAlignments alignments( generator, numberOfReads, readLength );
+                for ( const unsigned short gapExtend : {1, 3} )
+                {
+                    for ( const unsigned short nucPrior : {0, 4} )
+                    {
+                        std::vector< int > scores( numberOfReads );
+                        wecall::alignment::needlemanWunschScores( instructionSet, alignments.tasks(), readLength,
+                                                                  gapExtend, nucPrior, scores.data() );
+
+                        for ( std::size_t i = 0; i < numberOfReads; ++i )
+                        {
+                            BOOST_TEST_CONTEXT( wecall::alignment::toString( instructionSet )
+                                                << " read " << alignments.m_reads[i] << " haplotype "
+                                                << alignments.m_haplotypes[i] )
+                            {
+                                BOOST_CHECK_EQUAL( scores[i], alignments.sse2Score( i, gapExtend, nucPrior, false ) );
+                                BOOST_CHECK_EQUAL( scores[i], alignments.sse2Score( i, gapExtend, nucPrior, true ) );
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
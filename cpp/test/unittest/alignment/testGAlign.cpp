@@ -484,3 +484,75 @@ BOOST_AUTO_TEST_CASE( testGAlignWithWrongQualLength )
     delete[] aln1;
     delete[] aln2;
 }
+
+BOOST_AUTO_TEST_CASE( testGAlignBestScoreOverPositionsIsLowestScoreAtAnyPosition )
+{
+    std::string padding = "NNNNNNNN";
+    std::string haplotype = "ACGTTACGATCAGGACTTACGAT";
+    std::string read = "ACGAT";
+    const wecall::utils::BasePairSequence haplotypeSequence = padding + haplotype + padding;
+    const wecall::alignment::localGapOpenPenalties_t localGapOpen( haplotypeSequence.size(), 20 );
+    const wecall::utils::QualitySequence qual( read.size(), 30 );
+
+    const short gapExtend = 1;
+    const short nucleotidePrior = 4;
+
+    const wecall::alignment::GAlign align( haplotypeSequence, gapExtend, nucleotidePrior, localGapOpen );
+
+    std::vector< std::size_t > positions;
+    int bestScore = std::numeric_limits< int >::max();
+    for ( std::size_t pos = 8; pos <= 8 + haplotype.size() - read.size(); ++pos )
+    {
+        positions.push_back( pos );
+        bestScore = std::min( bestScore, align.computeAlignmentPhredScore( read, qual, static_cast< int >( pos ) ) );
+
+        BOOST_CHECK_EQUAL( align.computeBestAlignmentPhredScore( read, qual, positions ), bestScore );
+        BOOST_CHECK_EQUAL( align.computeBestAlignmentPhredScore( read, qual, {pos} ),
+                           align.computeAlignmentPhredScore( read, qual, static_cast< int >( pos ) ) );
+    }
+    BOOST_CHECK_EQUAL( bestScore, 0 );
+
+    BOOST_CHECK_THROW( align.computeBestAlignmentPhredScore( read, qual, {8, 7} ), wecall::utils::wecall_exception );
+}
+
+BOOST_AUTO_TEST_CASE( testGAlignBestScoresOfReadsMatchScoresOfReadsAlignedOneAtATime )
+{
+    std::string padding = "NNNNNNNN";
+    std::string haplotype = "ACGTTACGATCAGGACTTACGATTGCA";
+    const wecall::utils::BasePairSequence haplotypeSequence = padding + haplotype + padding;
+    const auto localGapOpen =
+        wecall::alignment::computeGapOpen( haplotypeSequence, wecall::alignment::errorModel_t{20, 15, 10} );
+
+    const short gapExtend = 1;
+    const short nucleotidePrior = 4;
+
+    const wecall::alignment::GAlign align( haplotypeSequence, gapExtend, nucleotidePrior, localGapOpen );
+
+    // Three reads of length 5 share kernel passes; the reads of length 4 and 7 are aligned on their own.
+    const std::vector< wecall::utils::BasePairSequence > readSeqs = {"ACGAT", "TTACG", "ACGT", "CAGCACT", "GGACT"};
+    std::vector< wecall::utils::QualitySequence > quals;
+    std::vector< wecall::alignment::ReadToAlign > reads;
+    for ( const auto & readSeq : readSeqs )
+    {
+        quals.push_back( wecall::utils::QualitySequence( readSeq.size(), 30 ) );
+    }
+    for ( std::size_t i = 0; i < readSeqs.size(); ++i )
+    {
+        std::vector< std::size_t > positions = {8 + i, 12 + i, 16 + i};
+        reads.push_back( {&readSeqs[i], &quals[i], positions} );
+    }
+
+    const auto bestScores = align.computeBestAlignmentPhredScores( reads );
+
+    BOOST_REQUIRE_EQUAL( bestScores.size(), reads.size() );
+    for ( std::size_t i = 0; i < reads.size(); ++i )
+    {
+        int expectedScore = std::numeric_limits< int >::max();
+        for ( const auto pos : reads[i].m_positions )
+        {
+            expectedScore = std::min( expectedScore, align.computeAlignmentPhredScore( readSeqs[i], quals[i],
+                                                                                        static_cast< int >( pos ) ) );
+        }
+        BOOST_CHECK_EQUAL( bestScores[i], expectedScore );
+    }
+}
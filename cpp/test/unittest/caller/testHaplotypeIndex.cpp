@@ -0,0 +1,24 @@
+// All content Copyright (C) 2018 Genomics plc
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "caller/haplotypeIndex.hpp"
+
+using wecall::caller::HaplotypeIndex;
+using wecall::utils::BasePairSequence;
+
+BOOST_AUTO_TEST_CASE( testHaplotypeIndexBuildsEachSequenceOnce )
+{
+    const BasePairSequence sequence1( std::string( 20, 'A' ) + "ACGTTGCATTGACCA" + std::string( 20, 'A' ) );
+    const BasePairSequence sequence2( std::string( 20, 'A' ) + "ACGTTGCATTGACCT" + std::string( 20, 'A' ) );
+
+    const auto timer = std::make_shared< wecall::utils::Timer >( "HaplotypeIndex", wecall::utils::fileMetaData( "" ) );
+    HaplotypeIndex index( timer );
+
+    const auto & index1 = index.get( sequence1 );
+    const auto & index2 = index.get( sequence2 );
+
+    BOOST_CHECK( &index1 != &index2 );
+    BOOST_CHECK( &index.get( BasePairSequence( sequence1.str() ) ) == &index1 );
+    BOOST_CHECK( &index.get( sequence2 ) == &index2 );
+}
@@ -0,0 +1,71 @@
+// All content Copyright (C) 2018 Genomics plc
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "caller/haplotypeLikelihoods.hpp"
+#include "io/read.hpp"
+#include "io/readIntervalTree.hpp"
+#include "variant/type/variant.hpp"
+
+using wecall::alignment::Cigar;
+using wecall::caller::Region;
+using wecall::io::Read;
+using wecall::io::RegionsReads;
+using wecall::utils::BasePairSequence;
+using wecall::variant::Variant;
+
+BOOST_AUTO_TEST_CASE( testDuplicateReadsAreAlignedOnceAndGetTheSameLikelihoods )
+{
+    const Region region( "1", 0, 30 );
+    const auto refSequence =
+        std::make_shared< wecall::utils::ReferenceSequence >( region, "GAGGGTCCTGCAAGGAACTGCGGGAAGTCT" );
+
+    // The duplicate differs only in strand and name, which do not affect its likelihoods.
+    const auto read = std::make_shared< Read >( BasePairSequence( "CCAGGAAC" ), std::string( 8, 'Q' ), "0",
+                                                Cigar( "8M" ), 0, 10, 0, 10, 0, 0, 0, refSequence, "read" );
+    const auto duplicate = std::make_shared< Read >( BasePairSequence( "CCAGGAAC" ), std::string( 8, 'Q' ), "0",
+                                                     Cigar( "8M" ), 0, 10, 16, 10, 0, 0, 0, refSequence, "dup" );
+    const auto other = std::make_shared< Read >( BasePairSequence( "CAAGGAAC" ), std::string( 8, 'Q' ), "0",
+                                                 Cigar( "8M" ), 0, 10, 0, 10, 0, 0, 0, refSequence, "other" );
+
+    wecall::io::readIntervalTree_t readContainer( 0, 100 );
+    readContainer.insert( read );
+    readContainer.insert( duplicate );
+    readContainer.insert( other );
+    const RegionsReads regionsReads( region, readContainer.getFullRange(), 0 );
+
+    wecall::variant::HaplotypeVector haplotypes( refSequence->region(), refSequence );
+    haplotypes.push_back( {} );
+    haplotypes.push_back( {std::make_shared< Variant >( refSequence, Region( "1", 11, 12 ), "C" )} );
+
+    wecall::caller::ReadLikelihoodCache likelihoodCache;
+    const auto likelihoods = wecall::caller::computeHaplotypeLikelihoods( haplotypes, regionsReads, &likelihoodCache );
+
+    BOOST_CHECK_EQUAL( likelihoodCache.misses(), 2 * haplotypes.size() );
+    BOOST_REQUIRE_EQUAL( likelihoods.nRows(), 3 );
+    BOOST_REQUIRE_EQUAL( likelihoods.nColumns(), 2 );
+
+    std::vector< std::size_t > duplicateRows;
+    std::size_t otherRow = 0;
+    std::size_t readIndex = 0;
+    for ( const auto & regionRead : regionsReads )
+    {
+        if ( regionRead.getQName() == "other" )
+        {
+            otherRow = readIndex;
+        }
+        else
+        {
+            duplicateRows.push_back( readIndex );
+        }
+        ++readIndex;
+    }
+
+    BOOST_REQUIRE_EQUAL( duplicateRows.size(), 2 );
+    for ( std::size_t haplotypeIndex = 0; haplotypeIndex < haplotypes.size(); ++haplotypeIndex )
+    {
+        BOOST_CHECK_EQUAL( likelihoods( duplicateRows[0], haplotypeIndex ),
+                           likelihoods( duplicateRows[1], haplotypeIndex ) );
+    }
+    BOOST_CHECK_NE( likelihoods( duplicateRows[0], 1 ), likelihoods( otherRow, 1 ) );
+}
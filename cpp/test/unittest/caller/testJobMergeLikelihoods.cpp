@@ -0,0 +1,122 @@
+// All content Copyright (C) 2018 Genomics plc
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "caller/jobMergeLikelihoods.hpp"
+#include "vcf/field.hpp"
+
+using wecall::caller::Call;
+using wecall::caller::ClusterLikelihoodRecord;
+using wecall::caller::LikelihoodRecordVariant;
+using wecall::caller::Region;
+using wecall::caller::callVector_t;
+
+namespace
+{
+const std::vector< std::string > samples = {"S0", "S1", "S2"};
+const std::vector< std::size_t > ploidyPerSample = {2, 2, 2};
+
+/// A record of a diploid sample with a reference haplotype and one carrying all its variants.
+ClusterLikelihoodRecord makeRecord( const std::string & sample,
+                                    const Region & region,
+                                    const std::vector< LikelihoodRecordVariant > & variants,
+                                    const std::vector< std::size_t > & calledHaplotypes,
+                                    const std::vector< double > & weightedLikelihoods )
+{
+    ClusterLikelihoodRecord record;
+    record.sample = sample;
+    record.region = region;
+    record.variants = variants;
+    record.nHaplotypes = 2;
+    for ( std::size_t variantIndex = 0; variantIndex < variants.size(); ++variantIndex )
+    {
+        record.haplotypeFlags.push_back( ClusterLikelihoodRecord::isReferenceFlag );
+        record.haplotypeFlags.push_back( ClusterLikelihoodRecord::containsVariantFlag );
+    }
+    record.haplotypeFrequencies = {0.5, 0.5};
+    record.genotypeStatistics.hasReads = true;
+    record.genotypeStatistics.ploidy = 2;
+    record.genotypeStatistics.haplotypesUsed = {0, 1};
+    record.genotypeStatistics.weightedLikelihoods = weightedLikelihoods;
+    record.calledHaplotypes = calledHaplotypes;
+    record.readSupport.resize( variants.size() );
+    record.genotypeLikelihoods.assign( variants.size(), {0.0, 10.0, 20.0} );
+    return record;
+}
+
+const std::vector< double > homozygousVariant = {1.0e-20, 2.0e-10, 1.0};
+const std::vector< double > heterozygous = {1.0e-10, 2.0, 1.0e-10};
+const std::vector< double > homozygousReference = {1.0, 2.0e-10, 1.0e-20};
+
+callVector_t merge( const std::vector< ClusterLikelihoodRecord > & records, const bool outputAllVariants = false )
+{
+    const auto reference =
+        std::make_shared< wecall::utils::ReferenceSequence >( Region( "1", 0, 40 ), std::string( 40, 'A' ) );
+    return wecall::caller::mergeCluster( records, samples, ploidyPerSample, reference, true, outputAllVariants,
+                                         false );
+}
+}
+
+BOOST_AUTO_TEST_CASE( shouldMergeRecordsOfTheSameCluster )
+{
+    const LikelihoodRecordVariant snp = {10, 11, "C", 1.0e-4, false};
+    const auto calls = merge( {makeRecord( "S0", Region( "1", 0, 20 ), {snp}, {1, 1}, homozygousVariant ),
+                               makeRecord( "S1", Region( "1", 0, 20 ), {snp}, {0, 0}, homozygousReference )} );
+
+    BOOST_REQUIRE_EQUAL( calls.size(), 1 );
+    BOOST_CHECK_EQUAL( calls[0].var->start(), 10 );
+    BOOST_CHECK_GE( calls[0].qual, double( constants::minAllowedQualityScore ) );
+    BOOST_CHECK( calls[0].filters.empty() );
+    BOOST_CHECK( calls[0].samples[0].genotypeCalls == std::vector< Call::Type >( {Call::VAR, Call::VAR} ) );
+    BOOST_CHECK( calls[0].samples[1].genotypeCalls == std::vector< Call::Type >( {Call::REF, Call::REF} ) );
+    BOOST_CHECK( calls[0].samples[2].genotypeCalls == std::vector< Call::Type >( {Call::UNKNOWN, Call::UNKNOWN} ) );
+}
+
+BOOST_AUTO_TEST_CASE( shouldMergeOverlappingClustersWithDifferentBoundaries )
+{
+    const LikelihoodRecordVariant firstSnp = {10, 11, "C", 1.0e-4, false};
+    const LikelihoodRecordVariant secondSnp = {25, 26, "G", 1.0e-4, false};
+    const auto calls =
+        merge( {makeRecord( "S0", Region( "1", 0, 20 ), {firstSnp}, {1, 1}, homozygousVariant ),
+                makeRecord( "S1", Region( "1", 5, 30 ), {firstSnp, secondSnp}, {0, 1}, heterozygous )} );
+
+    BOOST_REQUIRE_EQUAL( calls.size(), 2 );
+
+    BOOST_CHECK_EQUAL( calls[0].var->start(), 10 );
+    BOOST_CHECK( calls[0].samples[0].genotypeCalls == std::vector< Call::Type >( {Call::VAR, Call::VAR} ) );
+    BOOST_CHECK( calls[0].samples[1].genotypeCalls == std::vector< Call::Type >( {Call::REF, Call::VAR} ) );
+
+    // The first sample has no record covering the second variant.
+    BOOST_CHECK_EQUAL( calls[1].var->start(), 25 );
+    BOOST_CHECK( calls[1].samples[0].genotypeCalls == std::vector< Call::Type >( {Call::UNKNOWN, Call::UNKNOWN} ) );
+    BOOST_CHECK( calls[1].samples[1].genotypeCalls == std::vector< Call::Type >( {Call::REF, Call::VAR} ) );
+}
+
+BOOST_AUTO_TEST_CASE( shouldCallSampleReferenceAtVariantItsRecordCoversWithoutCandidate )
+{
+    const LikelihoodRecordVariant firstSnp = {10, 11, "C", 1.0e-4, false};
+    const LikelihoodRecordVariant secondSnp = {15, 16, "G", 1.0e-4, false};
+    const auto calls = merge( {makeRecord( "S0", Region( "1", 0, 20 ), {firstSnp}, {1, 1}, homozygousVariant ),
+                               makeRecord( "S1", Region( "1", 2, 22 ), {secondSnp}, {0, 0}, homozygousReference )},
+                              true );
+
+    BOOST_REQUIRE_EQUAL( calls.size(), 2 );
+
+    BOOST_CHECK_EQUAL( calls[0].var->start(), 10 );
+    BOOST_CHECK( calls[0].filters.empty() );
+    BOOST_CHECK( calls[0].samples[0].genotypeCalls == std::vector< Call::Type >( {Call::VAR, Call::VAR} ) );
+    BOOST_CHECK( calls[0].samples[1].genotypeCalls == std::vector< Call::Type >( {Call::REF, Call::REF} ) );
+
+    BOOST_CHECK_EQUAL( calls[1].var->start(), 15 );
+    BOOST_CHECK_EQUAL( calls[1].filters.count( wecall::vcf::filter::NC_key ), 1 );
+    BOOST_CHECK( calls[1].samples[0].genotypeCalls == std::vector< Call::Type >( {Call::REF, Call::REF} ) );
+    BOOST_CHECK( calls[1].samples[1].genotypeCalls == std::vector< Call::Type >( {Call::REF, Call::REF} ) );
+}
+
+BOOST_AUTO_TEST_CASE( shouldNotOutputUncalledVariantsByDefault )
+{
+    const LikelihoodRecordVariant snp = {10, 11, "C", 1.0e-4, false};
+    const auto calls = merge( {makeRecord( "S0", Region( "1", 0, 20 ), {snp}, {0, 0}, homozygousReference )} );
+
+    BOOST_CHECK( calls.empty() );
+}
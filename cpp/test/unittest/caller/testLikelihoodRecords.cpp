@@ -0,0 +1,126 @@
+// All content Copyright (C) 2018 Genomics plc
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <limits>
+
+#include "caller/likelihoodRecords.hpp"
+#include "utils/exceptions.hpp"
+
+using wecall::caller::ClusterLikelihoodRecord;
+using wecall::caller::LikelihoodFileHeader;
+using wecall::caller::LikelihoodRecordReader;
+using wecall::caller::Region;
+
+namespace
+{
+std::string writeLikelihoodFile( const std::vector< ClusterLikelihoodRecord > & records )
+{
+    const auto filename =
+        ( boost::filesystem::temp_directory_path() / boost::filesystem::unique_path( "%%%%-%%%%.wclike" ) ).string();
+
+    LikelihoodFileHeader header;
+    header.sampleNames = {"NA12878", "NA12879"};
+    header.ploidy = 2;
+
+    std::ofstream out( filename, std::ios_base::out | std::ios_base::binary );
+    out << wecall::caller::serialiseLikelihoodFileHeader( header );
+    for ( const auto & record : records )
+    {
+        out << wecall::caller::serialiseLikelihoodRecord( record );
+    }
+    return filename;
+}
+}
+
+BOOST_AUTO_TEST_CASE( testLikelihoodRecordsRoundTrip )
+{
+    ClusterLikelihoodRecord record;
+    record.sample = "NA12878";
+    record.region = Region( "20", 100, 150 );
+    record.variants.push_back( {110, 111, "C", 1.0e-4, false} );
+    record.variants.push_back( {120, 121, "", 1.0e-5, true} );
+    record.nHaplotypes = 3;
+    record.haplotypeFlags = {2, 1, 1, 2, 2, 1};
+    record.haplotypeFrequencies = {0.5, 1.25, 3.0};
+    record.genotypeStatistics.hasReads = true;
+    record.genotypeStatistics.ploidy = 2;
+    record.genotypeStatistics.haplotypesUsed = {0, 1};
+    record.genotypeStatistics.weightedLikelihoods = {1.0e-20, 2.0e-10, 3.0e-30};
+    record.calledHaplotypes = {0, 1};
+    record.genotypeMetadata.genotypeQuality = 45.0;
+    record.readSupport.resize( 2 );
+    record.readSupport[1].forwardSupportingVariant = 3.5;
+    record.readSupport[1].mappingQuals = {60, 20};
+    record.genotypeLikelihoods = {{10.0, 0.0, 30.0}, {0.0, 5.0, 50.0}};
+
+    auto secondRecord = record;
+    secondRecord.sample = "NA12879";
+    secondRecord.calledHaplotypes.clear();
+
+    const auto filename = writeLikelihoodFile( {record, secondRecord} );
+
+    LikelihoodRecordReader reader( filename );
+    std::vector< ClusterLikelihoodRecord > records( 3 );
+    BOOST_REQUIRE( reader.read( records[0] ) );
+    BOOST_REQUIRE( reader.read( records[1] ) );
+    BOOST_CHECK( not reader.read( records[2] ) );
+    boost::filesystem::remove( filename );
+
+    BOOST_CHECK( reader.header().sampleNames == std::vector< std::string >( {"NA12878", "NA12879"} ) );
+    BOOST_CHECK_EQUAL( reader.header().ploidy, 2 );
+    BOOST_CHECK( not reader.header().genotypingMode );
+
+    BOOST_CHECK_EQUAL( records[0].sample, "NA12878" );
+    BOOST_CHECK_EQUAL( records[1].sample, "NA12879" );
+    BOOST_CHECK_EQUAL( records[0].region, record.region );
+    BOOST_CHECK( records[0].variants == record.variants );
+    BOOST_CHECK_EQUAL( records[0].variants[1].prior, 1.0e-5 );
+    BOOST_CHECK( records[0].variants[1].isGenotypingVariant );
+    BOOST_CHECK_EQUAL( records[0].flags( 1, 2 ), ClusterLikelihoodRecord::containsVariantFlag );
+    BOOST_CHECK( records[0].haplotypeFrequencies == record.haplotypeFrequencies );
+    BOOST_CHECK( records[0].genotypeStatistics.hasReads );
+    BOOST_CHECK_EQUAL( records[0].genotypeStatistics.ploidy, 2 );
+    BOOST_CHECK( records[0].genotypeStatistics.haplotypesUsed == record.genotypeStatistics.haplotypesUsed );
+    BOOST_CHECK( records[0].genotypeStatistics.weightedLikelihoods == record.genotypeStatistics.weightedLikelihoods );
+    BOOST_CHECK_EQUAL( records[0].calledHaplotypes.size(), 2 );
+    BOOST_CHECK( records[1].calledHaplotypes.empty() );
+    BOOST_CHECK_EQUAL( records[0].genotypeMetadata.genotypeQuality, 45.0 );
+    BOOST_CHECK_EQUAL( records[0].readSupport[1].forwardSupportingVariant, 3.5 );
+    BOOST_CHECK( records[0].readSupport[1].mappingQuals == record.readSupport[1].mappingQuals );
+    BOOST_CHECK( records[0].genotypeLikelihoods == record.genotypeLikelihoods );
+}
+
+BOOST_AUTO_TEST_CASE( testReadingLikelihoodRecordWithLengthPastEndOfFileFails )
+{
+    const auto filename = writeLikelihoodFile( {} );
+    {
+        // A sample name claiming to be far longer than the rest of the file.
+        std::ofstream out( filename, std::ios_base::out | std::ios_base::app | std::ios_base::binary );
+        const uint64_t length = std::numeric_limits< uint64_t >::max() / 2;
+        out.write( reinterpret_cast< const char * >( &length ), sizeof( length ) );
+        out << "NA12878";
+    }
+
+    LikelihoodRecordReader reader( filename );
+    ClusterLikelihoodRecord record;
+    BOOST_CHECK_THROW( reader.read( record ), wecall::utils::wecall_exception );
+    boost::filesystem::remove( filename );
+}
+
+BOOST_AUTO_TEST_CASE( testReadingTruncatedLikelihoodRecordFails )
+{
+    const auto filename = writeLikelihoodFile( {} );
+    {
+        // Only part of the length of the sample name.
+        std::ofstream out( filename, std::ios_base::out | std::ios_base::app | std::ios_base::binary );
+        out.write( "\x07\x00\x00", 3 );
+    }
+
+    LikelihoodRecordReader reader( filename );
+    ClusterLikelihoodRecord record;
+    BOOST_CHECK_THROW( reader.read( record ), wecall::utils::wecall_exception );
+    boost::filesystem::remove( filename );
+}
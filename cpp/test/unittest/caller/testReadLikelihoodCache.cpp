@@ -0,0 +1,83 @@
+// All content Copyright (C) 2018 Genomics plc
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "caller/readLikelihoodCache.hpp"
+#include "io/read.hpp"
+
+using wecall::caller::ReadLikelihoodCache;
+using wecall::alignment::Cigar;
+using wecall::caller::Region;
+using wecall::io::Read;
+using wecall::utils::BasePairSequence;
+using wecall::utils::QualitySequence;
+using wecall::utils::ReferenceSequence;
+
+namespace
+{
+    std::shared_ptr< Read > makeReadAt( wecall::utils::referenceSequencePtr_t reference, const int64_t start )
+    {
+        const BasePairSequence sequence( "ACGTA" );
+        return std::make_shared< Read >( sequence, QualitySequence( sequence.size(), 30 ), "", Cigar( "5M" ), 0,
+                                         start, 0, 30, 0, 0, 0, reference );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( testReadLikelihoodCacheOnlyComputesLikelihoodsNotCached )
+{
+    const auto reference = std::make_shared< ReferenceSequence >( Region( "1", 0, 20 ), "ACGTAACGTAACGTAACGTA" );
+    const auto read1 = makeReadAt( reference, 2 );
+    const auto read2 = makeReadAt( reference, 5 );
+
+    std::vector< std::vector< const Read * > > computedReads;
+    const auto computeLikelihoods = [&computedReads]( const std::vector< const Read * > & reads )
+    {
+        computedReads.push_back( reads );
+        std::vector< double > likelihoods;
+        for ( const auto read : reads )
+        {
+            likelihoods.push_back( 1.0 / static_cast< double >( read->getStartPos() ) );
+        }
+        return likelihoods;
+    };
+
+    ReadLikelihoodCache cache;
+    const auto first = cache.getLikelihoods( "ACGTACGT", 0, {read1.get()}, computeLikelihoods );
+    const auto second = cache.getLikelihoods( "ACGTACGT", 0, {read2.get(), read1.get()}, computeLikelihoods );
+
+    BOOST_CHECK_EQUAL( first.size(), 1 );
+    BOOST_CHECK_EQUAL( first[0], 0.5 );
+    BOOST_REQUIRE_EQUAL( second.size(), 2 );
+    BOOST_CHECK_EQUAL( second[0], 0.2 );
+    BOOST_CHECK_EQUAL( second[1], 0.5 );
+
+    BOOST_REQUIRE_EQUAL( computedReads.size(), 2 );
+    BOOST_CHECK( computedReads[1] == std::vector< const Read * >( {read2.get()} ) );
+
+    BOOST_CHECK_EQUAL( cache.hits(), 1 );
+    BOOST_CHECK_EQUAL( cache.misses(), 2 );
+    BOOST_CHECK_CLOSE( cache.hitRate(), 1.0 / 3.0, 1e-8 );
+}
+
+BOOST_AUTO_TEST_CASE( testReadLikelihoodCacheKeysOnSequenceAndHintPosition )
+{
+    const auto reference = std::make_shared< ReferenceSequence >( Region( "1", 0, 20 ), "ACGTAACGTAACGTAACGTA" );
+    const auto read = makeReadAt( reference, 2 );
+
+    std::size_t computations = 0;
+    const auto computeLikelihoods = [&computations]( const std::vector< const Read * > & reads )
+    {
+        computations += reads.size();
+        return std::vector< double >( reads.size(), 0.5 );
+    };
+
+    ReadLikelihoodCache cache;
+    cache.getLikelihoods( "ACGTACGT", 0, {read.get()}, computeLikelihoods );
+    cache.getLikelihoods( "ACGTACGA", 0, {read.get()}, computeLikelihoods );
+    cache.getLikelihoods( "ACGTACGT", 1, {read.get()}, computeLikelihoods );
+    cache.getLikelihoods( "ACGTACGA", 0, {read.get()}, computeLikelihoods );
+
+    BOOST_CHECK_EQUAL( computations, 3 );
+    BOOST_CHECK_EQUAL( cache.hits(), 1 );
+    BOOST_CHECK_EQUAL( cache.misses(), 3 );
+}
@@ -99,6 +99,40 @@ BOOST_AUTO_TEST_CASE( padParitionedShouldMaintainContigs )
                                    expectedOutput[1].end() );
 }
 
+BOOST_AUTO_TEST_CASE( shardPartitionedRegionsShouldKeepOneShardPerContigForZeroShardSize )
+{
+    std::vector< std::vector< Region > > input = {{{"1", 1, 20}, {"1", 30, 40}}, {{"2", 1, 2}}};
+
+    auto results = wecall::caller::shardPartitionedRegions( input, 0 );
+    BOOST_REQUIRE_EQUAL( results.size(), 2 );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( results[0].regions.begin(), results[0].regions.end(), input[0].begin(),
+                                   input[0].end() );
+    BOOST_CHECK_EQUAL( results[0].ownedInterval, wecall::caller::unboundedShardInterval() );
+    BOOST_CHECK_EQUAL( results[1].ownedInterval, wecall::caller::unboundedShardInterval() );
+}
+
+BOOST_AUTO_TEST_CASE( shardPartitionedRegionsShouldCutRegionsIntoShardsOwningTheWholeContig )
+{
+    std::vector< std::vector< Region > > input = {{{"1", 0, 25}, {"1", 30, 40}}, {{"2", 5, 15}}};
+    const auto maxInt = std::numeric_limits< int64_t >::max();
+
+    auto results = wecall::caller::shardPartitionedRegions( input, 10 );
+    BOOST_REQUIRE_EQUAL( results.size(), 5 );
+
+    std::vector< std::vector< Region > > expectedRegions = {
+        {{"1", 0, 10}}, {{"1", 10, 20}}, {{"1", 20, 25}, {"1", 30, 35}}, {{"1", 35, 40}}, {{"2", 5, 15}}};
+    std::vector< Interval > expectedOwned = {Interval( 0, 10 ), Interval( 10, 20 ), Interval( 20, 35 ),
+                                             Interval( 35, maxInt ), Interval( 0, maxInt )};
+
+    for ( std::size_t i = 0; i < results.size(); ++i )
+    {
+        BOOST_CHECK_EQUAL_COLLECTIONS( results[i].regions.begin(), results[i].regions.end(),
+                                       expectedRegions[i].begin(), expectedRegions[i].end() );
+        BOOST_CHECK_EQUAL( results[i].ownedInterval, expectedOwned[i] );
+    }
+}
+
 BOOST_AUTO_TEST_CASE( mergeRegionsShouldNotMergeNonOverlappingRegions )
 {
     std::vector< Region > input = {{"1", 1, 2}, {"1", 3, 4}};
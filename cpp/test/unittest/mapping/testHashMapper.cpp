@@ -85,6 +85,39 @@ BOOST_AUTO_TEST_CASE( test_next_hash_value_repetitive_sequence )
     }
 }
 
+BOOST_AUTO_TEST_CASE( test_kmer_hashes_match_hash_function_values )
+{
+    const wecall::utils::BasePairSequence sequence( "ACGAAATTTAAAAACCCCCTCCGCCCAAAAACATGACCCAATTGGNacgtn" );
+
+    for ( const unsigned int kmerSize : {4u, 8u} )
+    {
+        const auto hashes = kmerHashes( sequence, kmerSize );
+        BOOST_REQUIRE_EQUAL( hashes.size(), sequence.size() - kmerSize + 1 );
+
+        HashFunction hashFunction( sequence, kmerSize );
+        for ( std::size_t index = 0; index < hashes.size(); ++index )
+        {
+            BOOST_CHECK_EQUAL( hashes[index], hashFunction.next( sequence[index + kmerSize - 1] ) );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_kmers_repeated_more_than_max_repeat_count_are_not_counted )
+{
+    const auto kmerSize = 4;
+    const auto maxRepeatCount = wecall::mapping::constants::maxRepeatCount;
+    const std::string unique( "ACGTTGCA" );
+    const wecall::utils::BasePairSequence tenRepeats( unique + std::string( maxRepeatCount + kmerSize - 1, 'C' ) );
+    const wecall::utils::BasePairSequence elevenRepeats( unique + std::string( maxRepeatCount + kmerSize, 'C' ) );
+    const wecall::utils::BasePairSequence read( "CCCCC" );
+
+    const auto tenRepeatCounts = KmerMatches( tenRepeats, kmerSize, 0 ).countKmerMatches( read );
+    BOOST_CHECK_GT( std::accumulate( tenRepeatCounts.cbegin(), tenRepeatCounts.cend(), 0ul ), 0 );
+
+    const auto elevenRepeatCounts = KmerMatches( elevenRepeats, kmerSize, 0 ).countKmerMatches( read );
+    BOOST_CHECK_EQUAL( std::accumulate( elevenRepeatCounts.cbegin(), elevenRepeatCounts.cend(), 0ul ), 0 );
+}
+
 BOOST_AUTO_TEST_CASE( test_maps_substring_back_to_correct_start_position_in_non_repetitive_sequence )
 {
     const auto kmerSize = 8;
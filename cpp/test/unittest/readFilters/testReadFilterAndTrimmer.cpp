@@ -40,13 +40,13 @@ BOOST_AUTO_TEST_CASE( testEmptyFilters )
 
     // test that a read with length passes trimAndFilter with all filters turned off
     auto emptyIntvlRead = std::make_shared< wecall::io::Read >( readParams, refSequence );
-    BOOST_CHECK( rft.trimAndFilter( emptyIntvlRead ) );
+    BOOST_CHECK( rft.trimAndFilter( *emptyIntvlRead ) );
 
     // test that a read with no length fails trimAndFilter
     readParams.m_cigar = Cigar( "3I" );
     readParams.m_startPos = 101;
     auto emptyIntvlReadZeroAlignedLength = std::make_shared< wecall::io::Read >( readParams, refSequence );
-    BOOST_CHECK( not rft.trimAndFilter( emptyIntvlReadZeroAlignedLength ) );
+    BOOST_CHECK( not rft.trimAndFilter( *emptyIntvlReadZeroAlignedLength ) );
 }
 
 BOOST_AUTO_TEST_CASE( testFilterFail )
@@ -70,18 +70,18 @@ BOOST_AUTO_TEST_CASE( testFilterFail )
     auto notProperPairRead = std::make_shared< wecall::io::Read >( "WHY", "NOT", "test", Cigar( "3M" ), 0, 101, 0, 100,
                                                                     200, 200, 0, refSequence );
     BOOST_CHECK( not notProperPairRead->isProperPair() );
-    BOOST_CHECK( not rft.trimAndFilter( notProperPairRead ) );
+    BOOST_CHECK( not rft.trimAndFilter( *notProperPairRead ) );
 
     // add a filter
     filterParams.m_duplicatesFilter = true;  // filter all duplicates
     wecall::io::ReadFilterAndTrimmer rft_duplicates( filterParams );
     auto passesDuplicateFilterRead = std::make_shared< wecall::io::Read >(
         "WHY", "NOT", "test", Cigar( "3M" ), 0, 101, BAM_FPROPER_PAIR, 100, 200, 200, 0, refSequence );
-    BOOST_CHECK( rft_duplicates.trimAndFilter( passesDuplicateFilterRead ) );
+    BOOST_CHECK( rft_duplicates.trimAndFilter( *passesDuplicateFilterRead ) );
     auto failsDuplicateFilterRead = std::make_shared< wecall::io::Read >(
         "WHY", "NOT", "test", Cigar( "3M" ), 0, 101, BAM_FPROPER_PAIR + BAM_FDUP, 100, 200, 200, 0, refSequence );
     BOOST_CHECK( failsDuplicateFilterRead->isDuplicate() );
-    BOOST_CHECK( not rft_duplicates.trimAndFilter( failsDuplicateFilterRead ) );
+    BOOST_CHECK( not rft_duplicates.trimAndFilter( *failsDuplicateFilterRead ) );
 }
 
 BOOST_AUTO_TEST_CASE( testOverlapTrimming )
@@ -113,7 +113,7 @@ BOOST_AUTO_TEST_CASE( testOverlapTrimming )
                                                                   8,                                 // mateStartPos
                                                                   0, refSequence );
 
-    BOOST_CHECK( rftTrimOverlap.trimAndFilter( overlappingRead ) );
+    BOOST_CHECK( rftTrimOverlap.trimAndFilter( *overlappingRead ) );
     BOOST_CHECK_EQUAL( overlappingRead->getQualities().substr( 0, 9 ), "NOTNOTNOT" );
     BOOST_CHECK_EQUAL( overlappingRead->getQualities().at( 9 ), constants::minAllowedQualityScore );
 }
@@ -149,7 +149,7 @@ BOOST_AUTO_TEST_CASE( testShortReadTrimming )
                                                                    8,                                 // mateStartPos
                                                                    0, refSequence );
 
-    BOOST_CHECK( rftTrimShortRead.trimAndFilter( reverseShortRead ) );
+    BOOST_CHECK( rftTrimShortRead.trimAndFilter( *reverseShortRead ) );
     BOOST_CHECK_EQUAL( reverseShortRead->getQualities().substr( 0, 9 ), "NOTNOTNOT" );
     BOOST_CHECK_EQUAL( reverseShortRead->getQualities().at( 9 ), constants::minAllowedQualityScore );
 
@@ -164,8 +164,43 @@ BOOST_AUTO_TEST_CASE( testShortReadTrimming )
                                                                      8,                 // mateStartPos
                                                                      0, refSequence );
 
-    BOOST_CHECK( rftTrimShortRead.trimAndFilter( noReverseShortRead ) );
+    BOOST_CHECK( rftTrimShortRead.trimAndFilter( *noReverseShortRead ) );
     BOOST_CHECK_EQUAL( noReverseShortRead->getQualities().substr( 0, 8 ), "NOTNOTNO" );
     BOOST_CHECK_EQUAL( noReverseShortRead->getQualities().at( 8 ), constants::minAllowedQualityScore );
     BOOST_CHECK_EQUAL( noReverseShortRead->getQualities().at( 9 ), constants::minAllowedQualityScore );
 }
+
+BOOST_AUTO_TEST_CASE( testSimilarReadsFilterComparesWithRestoredPreviousRead )
+{
+    wecall::caller::params::Filters filterParams;
+    filterParams.m_readMappingFilterQ = 0;
+    filterParams.m_baseCallFilterN = 0;
+    filterParams.m_baseCallFilterQ = 0;
+    filterParams.m_duplicatesFilter = false;
+    filterParams.m_noMatesFilter = false;
+    filterParams.m_overlapTrim = false;
+    filterParams.m_shortReadFilter = false;
+    filterParams.m_shortReadTrim = false;
+    filterParams.m_noSimilarReadsFilter = true;
+
+    auto refSequence =
+        std::make_shared< wecall::utils::ReferenceSequence >( wecall::caller::Region( "1", 100, 110 ), "ACGTAAAAGT" );
+    wecall::io::ReadFilterAndTrimmer rft( filterParams );
+
+    wecall::io::Read firstRead( "WHY", "NOT", "test", Cigar( "3M" ), 0, 101, BAM_FPROPER_PAIR, 100, 200, 0, 300,
+                                refSequence );
+    wecall::io::Read similarRead( "WHY", "NOT", "test", Cigar( "3M" ), 0, 101, BAM_FPROPER_PAIR, 100, 200, 0, 300,
+                                  refSequence );
+    wecall::io::Read otherRead( "WHY", "NOT", "test", Cigar( "3M" ), 0, 102, BAM_FPROPER_PAIR, 100, 200, 0, 300,
+                                refSequence );
+
+    BOOST_CHECK( not rft.previousRead().isSet );
+    BOOST_CHECK( rft.trimAndFilter( firstRead ) );
+    const auto previousRead = rft.previousRead();
+    BOOST_CHECK_EQUAL( previousRead.startPos, 101 );
+    BOOST_CHECK_EQUAL( previousRead.insertSize, 200 );
+
+    BOOST_CHECK( rft.trimAndFilter( otherRead ) );
+    rft.restorePreviousRead( previousRead );
+    BOOST_CHECK( not rft.trimAndFilter( similarRead ) );
+}
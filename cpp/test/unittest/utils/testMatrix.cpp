@@ -3,37 +3,70 @@
 #include <boost/test/unit_test.hpp>
 
 #include "utils/matrix.hpp"
-#include <set>
 #include <cassert>
+#include <cstdint>
 #include <algorithm>
 
-wecall::utils::matrix_t getMatrixFromVecOfVecs( const std::vector< std::vector< double > > & values )
+template < typename T >
+wecall::utils::AlignedMatrix< T > getMatrixFromVecOfVecs( const std::vector< std::vector< double > > & values )
 {
     assert( values.size() > 0 );
 
-    wecall::utils::matrix_t matrix_t( values.size(), values[0].size() );
+    wecall::utils::AlignedMatrix< T > matrix( values.size(), values[0].size() );
 
-    for ( std::size_t rowIndex = 0; rowIndex < matrix_t.size1(); ++rowIndex )
+    for ( std::size_t rowIndex = 0; rowIndex < matrix.nRows(); ++rowIndex )
     {
         const auto & row = values[rowIndex];
-        assert( row.size() == matrix_t.size2() );
+        assert( row.size() == matrix.nColumns() );
 
-        std::copy( row.begin(), row.end(), matrix_t.data().begin() + matrix_t.size2() * rowIndex );
+        std::copy( row.begin(), row.end(), matrix.row( rowIndex ) );
     }
-    return matrix_t;
+    return matrix;
 }
 
-BOOST_AUTO_TEST_CASE( testSumOverMatrixRowIndexSet )
+template < typename T >
+T minElement( const wecall::utils::AlignedMatrix< T > & matrix )
 {
-    std::vector< int > values = {1, 2, 3, 4, 5, 6, 7};
-    wecall::utils::matrix_t matrix_t( 1, 7 );
-    std::copy( values.begin(), values.end(), matrix_t.data().begin() );
+    T min = matrix( 0, 0 );
+    for ( std::size_t rowIndex = 0; rowIndex < matrix.nRows(); ++rowIndex )
+    {
+        const T * row = matrix.row( rowIndex );
+        min = std::min( min, *std::min_element( row, row + matrix.nColumns() ) );
+    }
+    return min;
+}
 
-    wecall::utils::matrixRow_t matrixRow_t( matrix_t, 0 );
+BOOST_AUTO_TEST_CASE( testRowsAreCacheLineAligned )
+{
+    wecall::utils::AlignedMatrix< double > matrix( 3, 5 );
+
+    BOOST_CHECK_EQUAL( matrix.nRows(), 3 );
+    BOOST_CHECK_EQUAL( matrix.nColumns(), 5 );
+    BOOST_CHECK_EQUAL( matrix.stride(), 8 );
+    for ( std::size_t rowIndex = 0; rowIndex < matrix.nRows(); ++rowIndex )
+    {
+        BOOST_CHECK_EQUAL( reinterpret_cast< std::uintptr_t >( matrix.row( rowIndex ) ) % 64, 0 );
+        BOOST_CHECK_EQUAL( &matrix( rowIndex, 2 ), matrix.row( rowIndex ) + 2 );
+    }
 
-    std::set< std::size_t > indicies = {0, 2, 4};
-    BOOST_CHECK_EQUAL( wecall::utils::sumMatrixRowOverIndexSubset( matrixRow_t, indicies ), 1 + 3 + 5 );
-    BOOST_CHECK_EQUAL( wecall::utils::sumMatrixRowOverAllIndices( matrixRow_t ), 1 + 2 + 3 + 4 + 5 + 6 + 7 );
+    wecall::utils::AlignedMatrix< float > floatMatrix( 2, 17 );
+    BOOST_CHECK_EQUAL( floatMatrix.stride(), 32 );
+    BOOST_CHECK_EQUAL( reinterpret_cast< std::uintptr_t >( floatMatrix.row( 1 ) ) % 64, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( testRowAndColumnSums )
+{
+    const auto matrix = getMatrixFromVecOfVecs< double >( {{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}} );
+
+    const std::vector< double > expectedRowSums = {6.0, 15.0};
+    const std::vector< double > expectedColumnSums = {5.0, 7.0, 9.0};
+
+    const auto rowSums = wecall::utils::rowSums( matrix );
+    const auto columnSums = wecall::utils::columnSums( matrix );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( rowSums.begin(), rowSums.end(), expectedRowSums.begin(), expectedRowSums.end() );
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        columnSums.begin(), columnSums.end(), expectedColumnSums.begin(), expectedColumnSums.end() );
 }
 
 BOOST_AUTO_TEST_CASE( testAdjustmentToMedian )
@@ -42,11 +75,26 @@ BOOST_AUTO_TEST_CASE( testAdjustmentToMedian )
         {13.0}, {1.0}, {1.0}, {1.0e-6}, {1.0}, {1.0}, {1.0}, {15.0},
     };
 
-    wecall::utils::matrix_t matrix = getMatrixFromVecOfVecs( values );
+    auto matrix = getMatrixFromVecOfVecs< double >( values );
 
-    BOOST_CHECK_CLOSE( *std::min_element( matrix.data().begin(), matrix.data().end() ), 1.0e-6, 1.0 );
+    BOOST_CHECK_CLOSE( minElement( matrix ), 1.0e-6, 1.0 );
 
     wecall::utils::smoothLowOutliers( matrix, 1.0e-4 );
 
-    BOOST_CHECK_CLOSE( *std::min_element( matrix.data().begin(), matrix.data().end() ), 1.0e-4, 1.0 );
-}
\ No newline at end of file
+    BOOST_CHECK_CLOSE( minElement( matrix ), 1.0e-4, 1.0 );
+}
+
+BOOST_AUTO_TEST_CASE( testAdjustmentToMedianInSinglePrecision )
+{
+    std::vector< std::vector< double > > values = {
+        {13.0, 1.0e-6}, {1.0, 1.0}, {1.0e-6, 1.0}, {15.0, 2.0},
+    };
+
+    auto matrix = getMatrixFromVecOfVecs< float >( values );
+
+    wecall::utils::smoothLowOutliers( matrix, 1.0e-4 );
+
+    // The median of the row maxima {13, 1, 1, 15} is 7.
+    BOOST_CHECK_CLOSE( minElement( matrix ), 7.0e-4f, 1.0 );
+    BOOST_CHECK_EQUAL( matrix( 3, 0 ), 15.0f );
+}
@@ -0,0 +1,95 @@
+// All content Copyright (C) 2018 Genomics plc
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "utils/memoryBudget.hpp"
+
+using wecall::utils::MemoryBudget;
+using wecall::utils::MemoryReservation;
+
+BOOST_AUTO_TEST_CASE( testMemoryBudgetGrantsReservationsWithinLimit )
+{
+    const auto budget = std::make_shared< MemoryBudget >( 100 );
+    MemoryReservation first( budget );
+    MemoryReservation second( budget );
+
+    BOOST_CHECK( first.tryGrow( 60 ) );
+    BOOST_CHECK( not second.tryGrow( 50 ) );
+    BOOST_CHECK( second.tryGrow( 40 ) );
+    BOOST_CHECK_EQUAL( budget->reserved(), 100 );
+
+    second = MemoryReservation( budget );
+    BOOST_CHECK_EQUAL( budget->reserved(), 60 );
+    BOOST_CHECK_EQUAL( budget->peak(), 100 );
+}
+
+BOOST_AUTO_TEST_CASE( testMemoryBudgetAlwaysGrantsFirstReservation )
+{
+    const auto budget = std::make_shared< MemoryBudget >( 100 );
+    {
+        MemoryReservation reservation( budget );
+        BOOST_CHECK( reservation.tryGrow( 500 ) );
+        BOOST_CHECK( not MemoryReservation( budget ).tryGrow( 1 ) );
+    }
+    BOOST_CHECK_EQUAL( budget->reserved(), 0 );
+    BOOST_CHECK_EQUAL( budget->peak(), 500 );
+}
+
+BOOST_AUTO_TEST_CASE( testMemoryReservationGrowsToMemoryInUse )
+{
+    const auto budget = std::make_shared< MemoryBudget >( 100 );
+    MemoryReservation reservation( budget );
+    BOOST_CHECK( reservation.tryGrow( 80 ) );
+
+    reservation.growTo( 50 );
+    BOOST_CHECK_EQUAL( reservation.bytes(), 80 );
+    reservation.growTo( 150 );
+    BOOST_CHECK_EQUAL( reservation.bytes(), 150 );
+    BOOST_CHECK_EQUAL( budget->reserved(), 150 );
+
+    MemoryReservation unbudgeted;
+    BOOST_CHECK( unbudgeted.tryGrow( 1000 ) );
+    BOOST_CHECK_EQUAL( budget->reserved(), 150 );
+}
+
+BOOST_AUTO_TEST_CASE( testMemoryBudgetWaitsForRelease )
+{
+    const auto budget = std::make_shared< MemoryBudget >( 100 );
+    std::unique_ptr< MemoryReservation > held( new MemoryReservation( budget ) );
+    BOOST_REQUIRE( held->tryGrow( 90 ) );
+
+    std::atomic< bool > granted( false );
+    std::thread waiter( [&budget, &granted]()
+                        {
+                            MemoryReservation reservation( budget );
+                            granted = reservation.grow( 50, nullptr );
+                        } );
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    BOOST_CHECK( not granted );
+    held.reset();
+    waiter.join();
+
+    BOOST_CHECK( granted );
+    BOOST_CHECK_EQUAL( budget->reserved(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( testMemoryBudgetWaitCanBeAbandoned )
+{
+    const auto budget = std::make_shared< MemoryBudget >( 100 );
+    MemoryReservation held( budget );
+    BOOST_REQUIRE( held.tryGrow( 90 ) );
+
+    MemoryReservation reservation( budget );
+    BOOST_CHECK( not reservation.grow( 50, []()
+                                       {
+                                           return true;
+                                       } ) );
+    BOOST_CHECK_EQUAL( reservation.bytes(), 0 );
+    BOOST_CHECK_EQUAL( budget->reserved(), 90 );
+}
@@ -183,3 +183,33 @@ BOOST_AUTO_TEST_CASE( testBasicReverseIterators )
         BOOST_CHECK_EQUAL( obtainedSequenceStr, "5432" );
     }
 }
+
+BOOST_AUTO_TEST_CASE( testSubseqSharesBasesWithParent )
+{
+    const ReferenceSequence reference( Region( "1", 100, 110 ), BasePairSequence( "ACGTACGTAC" ) );
+    const auto sub = reference.subseq( Region( "1", 103, 107 ) );
+    const auto subOfSub = sub.subseq( Region( "1", 104, 106 ) );
+
+    BOOST_CHECK_EQUAL( &sub.buffer(), &reference.buffer() );
+    BOOST_CHECK_EQUAL( sub.bufferOffset(), 3 );
+    BOOST_CHECK_EQUAL( subOfSub.bufferOffset(), 4 );
+    BOOST_CHECK_EQUAL( sub.sequence(), BasePairSequence( "TACG" ) );
+    BOOST_CHECK_EQUAL( subOfSub.at( 105 ), 'C' );
+    BOOST_CHECK_EQUAL( std::string( sub.crbegin(), sub.crend() ), "GCAT" );
+    BOOST_CHECK( subOfSub == ReferenceSequence( Region( "1", 104, 106 ), BasePairSequence( "AC" ) ) );
+    BOOST_CHECK_THROW( sub.at( 107 ), wecall::utils::wecall_exception );
+}
+
+BOOST_AUTO_TEST_CASE( testGetPaddedCopiesOnlyToAddPadding )
+{
+    const ReferenceSequence reference( Region( "1", 100, 110 ), BasePairSequence( "ACGTACGTAC" ) );
+    const auto sub = reference.subseq( Region( "1", 102, 104 ) );
+
+    const auto unpadded = sub.getPadded( sub.region() );
+    BOOST_CHECK_EQUAL( &unpadded.buffer(), &reference.buffer() );
+
+    const auto padded = sub.getPadded( Region( "1", 101, 105 ) );
+    BOOST_CHECK_NE( &padded.buffer(), &reference.buffer() );
+    BOOST_CHECK_EQUAL( padded.sequence(), BasePairSequence( "NGTN" ) );
+    BOOST_CHECK_EQUAL( reference.sequence(), BasePairSequence( "ACGTACGTAC" ) );
+}
@@ -0,0 +1,79 @@
+// All content Copyright (C) 2018 Genomics plc
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+#include "utils/taskPool.hpp"
+
+using wecall::utils::TaskPool;
+
+BOOST_AUTO_TEST_CASE( testTaskPoolRunsAllTasksOfEachBatch )
+{
+    for ( const std::size_t numberOfThreads : {1, 3} )
+    {
+        TaskPool pool( numberOfThreads );
+        BOOST_CHECK_EQUAL( pool.numberOfThreads(), numberOfThreads );
+
+        for ( int batch = 0; batch < 5; ++batch )
+        {
+            std::atomic< int > tasksRun( 0 );
+            std::vector< TaskPool::task_t > tasks;
+            for ( int i = 0; i < 20; ++i )
+            {
+                tasks.push_back( [&tasksRun]()
+                                 {
+                                     ++tasksRun;
+                                 } );
+            }
+            pool.run( tasks );
+
+            BOOST_CHECK_EQUAL( tasksRun.load(), 20 );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( testTaskPoolRunsBatchesStartedFromTasks )
+{
+    TaskPool pool( 2 );
+    std::atomic< int > tasksRun( 0 );
+
+    std::vector< TaskPool::task_t > outerTasks;
+    for ( int i = 0; i < 4; ++i )
+    {
+        outerTasks.push_back( [&pool, &tasksRun]()
+                              {
+                                  std::vector< TaskPool::task_t > innerTasks;
+                                  for ( int j = 0; j < 4; ++j )
+                                  {
+                                      innerTasks.push_back( [&tasksRun]()
+                                                            {
+                                                                ++tasksRun;
+                                                            } );
+                                  }
+                                  pool.run( innerTasks );
+                                  ++tasksRun;
+                              } );
+    }
+    pool.run( outerTasks );
+
+    BOOST_CHECK_EQUAL( tasksRun.load(), 20 );
+}
+
+BOOST_AUTO_TEST_CASE( testTaskPoolRethrowsExceptionFromTaskAndStaysUsable )
+{
+    TaskPool pool( 2 );
+    BOOST_CHECK_THROW( pool.run( {[]()
+                                  {
+                                      throw std::runtime_error( "task failed" );
+                                  }} ),
+                       std::runtime_error );
+
+    std::atomic< int > tasksRun( 0 );
+    pool.run( {[&tasksRun]()
+               {
+                   ++tasksRun;
+               }} );
+    BOOST_CHECK_EQUAL( tasksRun.load(), 1 );
+}
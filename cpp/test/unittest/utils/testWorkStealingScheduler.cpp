@@ -0,0 +1,75 @@
+// All content Copyright (C) 2018 Genomics plc
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+#include "utils/workStealingScheduler.hpp"
+
+using wecall::utils::WorkStealingScheduler;
+
+BOOST_AUTO_TEST_CASE( testSchedulerRunsAllScheduledTasks )
+{
+    WorkStealingScheduler scheduler( 3 );
+    std::atomic< int > tasksRun( 0 );
+
+    for ( int i = 0; i < 20; ++i )
+    {
+        scheduler.schedule( [&tasksRun]()
+                            {
+                                ++tasksRun;
+                            } );
+    }
+    scheduler.run();
+
+    BOOST_CHECK_EQUAL( tasksRun.load(), 20 );
+}
+
+BOOST_AUTO_TEST_CASE( testSchedulerRunsTasksScheduledByRunningTasks )
+{
+    WorkStealingScheduler scheduler( 2 );
+    std::atomic< int > tasksRun( 0 );
+
+    std::function< void( int ) > splitTask;
+    splitTask = [&]( int depth )
+    {
+        ++tasksRun;
+        if ( depth > 0 )
+        {
+            scheduler.schedule( [&splitTask, depth]()
+                                {
+                                    splitTask( depth - 1 );
+                                } );
+            scheduler.schedule( [&splitTask, depth]()
+                                {
+                                    splitTask( depth - 1 );
+                                } );
+        }
+    };
+
+    scheduler.schedule( [&splitTask]()
+                        {
+                            splitTask( 4 );
+                        } );
+    scheduler.run();
+
+    BOOST_CHECK_EQUAL( tasksRun.load(), 31 );
+}
+
+BOOST_AUTO_TEST_CASE( testSchedulerHasNoIdleWorkersBeforeRunning )
+{
+    WorkStealingScheduler scheduler( 2 );
+    BOOST_CHECK( not scheduler.hasIdleWorkers() );
+}
+
+BOOST_AUTO_TEST_CASE( testSchedulerRethrowsExceptionFromTask )
+{
+    WorkStealingScheduler scheduler( 2 );
+    scheduler.schedule( []()
+                        {
+                            throw std::runtime_error( "task failed" );
+                        } );
+
+    BOOST_CHECK_THROW( scheduler.run(), std::runtime_error );
+}
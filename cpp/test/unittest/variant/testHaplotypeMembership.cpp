@@ -0,0 +1,78 @@
+// All content Copyright (C) 2018 Genomics plc
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "variant/haplotypeMembership.hpp"
+#include "variant/type/variant.hpp"
+
+using wecall::caller::Region;
+using wecall::utils::ReferenceSequence;
+using wecall::variant::HaplotypeMembership;
+using wecall::variant::HaplotypeVector;
+using wecall::variant::Variant;
+using wecall::variant::variantSet_t;
+
+BOOST_AUTO_TEST_CASE( testHaplotypeMembershipMatchesHaplotypes )
+{
+    const auto referenceSequence = std::make_shared< ReferenceSequence >( Region( "1", 0, 2 ), "AA" );
+    const auto snp0 = std::make_shared< Variant >( referenceSequence, Region( "1", 0, 1 ), "C" );
+    const auto snp1 = std::make_shared< Variant >( referenceSequence, Region( "1", 1, 2 ), "C" );
+
+    HaplotypeVector haplotypes( Region( "1", 0, 2 ), referenceSequence );
+    haplotypes.push_back( variantSet_t{} );
+    haplotypes.push_back( variantSet_t{snp0} );
+    haplotypes.push_back( variantSet_t{snp0, snp1} );
+
+    const HaplotypeMembership membership( haplotypes, {snp0, snp1} );
+
+    BOOST_REQUIRE_EQUAL( membership.nVariants(), 2 );
+    for ( std::size_t haplotypeIndex = 0; haplotypeIndex < haplotypes.size(); ++haplotypeIndex )
+    {
+        BOOST_CHECK_EQUAL( membership.containsVariant( 0, haplotypeIndex ),
+                           haplotypes[haplotypeIndex].containsVariant( snp0 ) );
+        BOOST_CHECK_EQUAL( membership.containsVariant( 1, haplotypeIndex ),
+                           haplotypes[haplotypeIndex].containsVariant( snp1 ) );
+        BOOST_CHECK_EQUAL( membership.isReference( 0, haplotypeIndex ),
+                           haplotypes[haplotypeIndex].isReference( snp0->region() ) );
+        BOOST_CHECK_EQUAL( membership.isReference( 1, haplotypeIndex ),
+                           haplotypes[haplotypeIndex].isReference( snp1->region() ) );
+    }
+
+    const std::vector< double > values = {1.0, 10.0, 100.0};
+    BOOST_CHECK_EQUAL( membership.sumOverHaplotypesContainingVariant( 0, values.data() ), 110.0 );
+    BOOST_CHECK_EQUAL( membership.sumOverHaplotypesContainingVariant( 1, values.data() ), 100.0 );
+    BOOST_CHECK_EQUAL( membership.sumOverReferenceHaplotypes( 0, values.data() ), 1.0 );
+    BOOST_CHECK_EQUAL( membership.sumOverReferenceHaplotypes( 1, values.data() ), 11.0 );
+}
+
+BOOST_AUTO_TEST_CASE( testHaplotypeMembershipSumsOverMoreThan64Haplotypes )
+{
+    const auto referenceSequence = std::make_shared< ReferenceSequence >( Region( "1", 0, 1 ), "A" );
+    const auto snp = std::make_shared< Variant >( referenceSequence, Region( "1", 0, 1 ), "C" );
+
+    HaplotypeVector haplotypes( Region( "1", 0, 1 ), referenceSequence );
+    std::vector< double > values;
+    double expectedWithVariant = 0.0;
+    double expectedReference = 0.0;
+    for ( std::size_t haplotypeIndex = 0; haplotypeIndex < 130; ++haplotypeIndex )
+    {
+        values.push_back( static_cast< double >( haplotypeIndex ) );
+        if ( haplotypeIndex % 3 == 0 )
+        {
+            haplotypes.push_back( variantSet_t{snp} );
+            expectedWithVariant += values.back();
+        }
+        else
+        {
+            haplotypes.push_back( variantSet_t{} );
+            expectedReference += values.back();
+        }
+    }
+
+    const HaplotypeMembership membership( haplotypes, {snp} );
+
+    BOOST_CHECK( membership.containsVariant( 0, 129 ) );
+    BOOST_CHECK( not membership.containsVariant( 0, 128 ) );
+    BOOST_CHECK_EQUAL( membership.sumOverHaplotypesContainingVariant( 0, values.data() ), expectedWithVariant );
+    BOOST_CHECK_EQUAL( membership.sumOverReferenceHaplotypes( 0, values.data() ), expectedReference );
+}
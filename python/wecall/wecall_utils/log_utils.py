@@ -43,15 +43,17 @@ def log_timing_parser(fp):
         match = timing_message_regex.match(timing_message)
         if match:
             metadata_item_regex = re.compile(
-                '^(?P<key>[a-zA-z][-_0-9a-zA-Z]*)=(?P<value>\"(?:(?:\\\")|[^\"])*\");$')
-            metadata_item_match = metadata_item_regex.match(
-                match.group('metadata'))
+                r'(?P<key>[a-zA-z][-_0-9a-zA-Z]*)=(?P<value>"(?:\\.|[^"\\])*");')
+            metadata = {
+                metadata_item_match.group('key'): ast.literal_eval(metadata_item_match.group('value'))
+                for metadata_item_match in metadata_item_regex.finditer(match.group('metadata'))
+            }
 
             timing_data.append(TimingDataItem(
                 match.group('type'),
                 int(match.group('length')),
                 match.group('units'),
-                {(metadata_item_match.group('key')): ast.literal_eval(metadata_item_match.group('value'))}
+                metadata
             ))
         else:
             errors.append('failed to parse {!r}'.format(timing_message))
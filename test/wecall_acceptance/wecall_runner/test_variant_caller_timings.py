@@ -31,17 +31,18 @@ class TestVariantCallerTimings(BaseTest):
         self.svc_driver.with_log_filename(self.log_filename)
         self.svc_driver.with_output_vcf_filename(self.output_vcf)
 
-    def __outputs_timings_for_files(self, expected_files):
+    def __outputs_timings_for_files(self, expected_files, timing_type="IO"):
         observed_files = set()
 
         with open(self.log_filename, "r") as log_file:
             timing_data = log_timing_parser(log_file)
             self.assertGreater(len(timing_data), 0)
             for timing_data_item in timing_data:
-                self.assertEqual("IO", timing_data_item.timing_type)
+                self.assertIn(timing_data_item.timing_type, {"IO", "HaplotypeIndex"})
                 self.assertEqual("us", timing_data_item.length_units)
                 self.assertIn("file", timing_data_item.metadata)
-                observed_files.add(timing_data_item.metadata["file"])
+                if timing_data_item.timing_type == timing_type:
+                    observed_files.add(timing_data_item.metadata["file"])
 
         for expected in expected_files:
             self.assertIn(expected, observed_files)
@@ -82,3 +83,7 @@ class TestVariantCallerTimings(BaseTest):
     def test_should_contain_timings_output_for_bed(self):
         self.svc_driver.call()
         self.__outputs_timings_for_files({self.bed_filename})
+
+    def test_should_contain_haplotype_index_timings_for_output_vcf(self):
+        self.svc_driver.call()
+        self.__outputs_timings_for_files({self.output_vcf}, "HaplotypeIndex")
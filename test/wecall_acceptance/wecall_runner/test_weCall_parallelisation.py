@@ -77,10 +77,7 @@ class TestWeCallParallelisation(BaseTest):
 
         self.vc_wrapper_serial = VariantCallerWrapper(serial_output_file_stem, wecall_config)
 
-    def test_should_give_same_results_in_parallel_as_in_series(self):
-        self.setParallelAndSerialVariantCallers(1, 5)
-        self.vc_wrapper_parallel.add_additional_command("numberOfJobs", "2")
-        self.vc_wrapper_parallel.add_additional_command("workDir", self.vc_work_dir)
+    def assertParallelOutputEqualsSerialOutput(self):
         self.vc_wrapper_parallel.run()
         self.vc_wrapper_serial.run()
 
@@ -91,6 +88,25 @@ class TestWeCallParallelisation(BaseTest):
                     if not parallel_vcf_line.startswith("##options"):
                         self.assertEqual(parallel_vcf_line, serial_vcf_line)
 
+    def test_should_give_same_results_in_parallel_as_in_series(self):
+        self.setParallelAndSerialVariantCallers(1, 5)
+        self.vc_wrapper_parallel.add_additional_command("numberOfJobs", "2")
+        self.vc_wrapper_parallel.add_additional_command("workDir", self.vc_work_dir)
+        self.assertParallelOutputEqualsSerialOutput()
+
+    def test_should_give_same_results_with_cluster_threads_as_in_series(self):
+        self.setParallelAndSerialVariantCallers(1, 5)
+        self.vc_wrapper_parallel.add_additional_command("clusterThreads", "4")
+        self.assertParallelOutputEqualsSerialOutput()
+
+    def test_should_give_same_results_with_sample_threads_as_in_series(self):
+        self.sample_name1 = "SAMPLE_A"
+        self.sample_name2 = "SAMPLE_B"
+        self.setParallelAndSerialVariantCallers(1, 5)
+        self.vc_wrapper_parallel.add_additional_command("sampleThreads", "2")
+        self.vc_wrapper_parallel.add_additional_command("clusterThreads", "2")
+        self.assertParallelOutputEqualsSerialOutput()
+
     def test_should_find_correct_variants(self):
         n_copies1 = 1
         n_copies2 = 5
@@ -0,0 +1,82 @@
+# All content Copyright (C) 2018 Genomics plc
+from os import path, environ
+
+from wecall.bamutils.sample_bank import SampleBank
+from wecall.vcfutils.genotype_call import GenotypeCall
+from wecall.vcfutils.parser import VCFReaderContextManager
+from wecall.wecall_utils.wecall_input_data_builder import WecallInputDataBuilder
+from wecall_test_drivers.base_test import BaseTest
+from wecall_test_drivers.tool_runner import ToolRunner
+
+
+class TestMergeLikelihoods(BaseTest):
+    def setUp(self):
+        BaseTest.setUp(self)
+        self.tool_location = path.join(environ["WECALL_BIN"], "weCall")
+        self.log_filename = path.join(self.work_dir, "_.log")
+        self.merged_vcf_location = path.join(self.work_dir, "merged.vcf")
+
+    def __run_wecall(self, bam_filename, ref_filename, stem):
+        likelihoods_filename = path.join(self.work_dir, stem + ".wclike")
+        tool_runner = ToolRunner().start([
+            self.tool_location,
+            "--inputs={}".format(bam_filename),
+            "--refFile={}".format(ref_filename),
+            "--output={}".format(path.join(self.work_dir, stem + ".vcf")),
+            "--likelihoodsOutput={}".format(likelihoods_filename),
+            "--noSimilarReadsFilter=0",
+            "--logFilename={}".format(self.log_filename),
+        ])
+        self.assertEqual(tool_runner.return_code, 0, tool_runner.stderr)
+        return likelihoods_filename
+
+    def __run_merge(self, likelihoods_filenames, ref_filename):
+        return ToolRunner().start([
+            self.tool_location,
+            "mergeLikelihoods",
+            "--inputs={}".format(",".join(likelihoods_filenames)),
+            "--refFile={}".format(ref_filename),
+            "--output={}".format(self.merged_vcf_location),
+            "--logFilename={}".format(self.log_filename),
+        ])
+
+    def test_should_merge_samples_called_in_clusters_with_different_boundaries(self):
+        sample_bank = SampleBank("AAAAAAAAAAACGCACCCCCCATAAAAAAAATTTTTTTTTTTCGCATTT", chrom="1")
+        sample_bank.add_sample_with_seqs_and_quals(
+            "SAMPLE_A", ["...................T............................."], n_fwd=10, n_rev=10)
+        # The second variant only in this sample makes its cluster extend beyond that of the first sample.
+        sample_bank.add_sample_with_seqs_and_quals(
+            "SAMPLE_B", ["...................T.........C..................."], n_fwd=10, n_rev=10)
+        input_data = WecallInputDataBuilder(self.work_dir).with_sample_bank(sample_bank).build()
+
+        likelihoods_filenames = [
+            self.__run_wecall(bam_filename, input_data.reference_filename, "run_{}".format(index))
+            for index, bam_filename in enumerate(sorted(input_data.bam_filenames))
+        ]
+
+        tool_runner = self.__run_merge(likelihoods_filenames, input_data.reference_filename)
+        self.assertEqual(tool_runner.return_code, 0, tool_runner.stderr)
+
+        with VCFReaderContextManager(self.merged_vcf_location) as merged_vcf:
+            records = list(merged_vcf.read_records())
+            self.assertEqual(merged_vcf.header.samples, ["SAMPLE_A", "SAMPLE_B"])
+            self.assertEqual(merged_vcf.header.get_contig("1").length, len(sample_bank.reference.fasta_string()))
+
+        self.assertEqual([record.one_indexed_pos_from for record in records], [20, 30])
+        self.assertEqual(records[0].sample_info.get_field("SAMPLE_A", "GT"), GenotypeCall("1/1"))
+        self.assertEqual(records[0].sample_info.get_field("SAMPLE_B", "GT"), GenotypeCall("1/1"))
+        self.assertNotIn(1, records[1].sample_info.get_field("SAMPLE_A", "GT").alleles)
+        self.assertEqual(records[1].sample_info.get_field("SAMPLE_B", "GT"), GenotypeCall("1/1"))
+        self.assertTrue(all(record.passes_filter for record in records))
+        self.assertIsNotNone(records[0].sample_info.get_field("SAMPLE_B", "PL"))
+
+    def test_should_fail_if_likelihood_file_does_not_exist(self):
+        sample_bank = SampleBank("AAAAAAAAAAACGCACCCCCCATAAAAAAAATTTTTTTTTTT", chrom="1")
+        sample_bank.add_sample_with_seqs_and_quals(
+            "SAMPLE_A", ["...................T......................"], n_fwd=10, n_rev=10)
+        input_data = WecallInputDataBuilder(self.work_dir).with_sample_bank(sample_bank).build()
+
+        tool_runner = self.__run_merge([path.join(self.work_dir, "missing.wclike")], input_data.reference_filename)
+
+        self.assertEqual(tool_runner.return_code, 1)
+        self.assertRegex(tool_runner.stderr.decode(), "FAILED - Could not open likelihood record file")